@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+# SPDX-License-Identifier: Apache-2.0 OR MIT
+#
+# SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+
+"""
+Generate the RegisterNatives() tables from the headers produced by javac -h.
+
+Every native method declared in a header gets an entry, so the table can never
+drift from the Java sources.
+"""
+
+import argparse
+import pathlib
+import re
+import sys
+
+METHOD_RE = re.compile(
+    r"^ \* Method:\s+(?P<name>\S+)\n"
+    r" \* Signature:\s+(?P<signature>\S+)\n"
+    r" \*/\n"
+    r"JNIEXPORT \S+ JNICALL (?P<function>\w+)\n",
+    re.MULTILINE,
+)
+
+
+def header_name(package: str, cls: str) -> str:
+    return "{}_{}.h".format(package.replace(".", "_"), cls.replace(".", "_"))
+
+
+def binary_name(package: str, cls: str) -> str:
+    return "{}/{}".format(package.replace(".", "/"), cls.replace(".", "$"))
+
+
+def table_name(package: str, cls: str) -> str:
+    return "{}_{}_methods".format(package.replace(".", "_"), cls.replace(".", "_"))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--output", required=True, type=pathlib.Path)
+    parser.add_argument("--package", required=True)
+    parser.add_argument("--classes", required=True, nargs="+")
+    parser.add_argument("--headers", required=True, nargs="+", type=pathlib.Path)
+    args = parser.parse_args()
+
+    headers = {h.name: h for h in args.headers}
+
+    lines = [
+        "/* Generated by natives.py. Do not edit. */",
+        "",
+        "#include <jni.h>",
+        "",
+        '#include "hsejni.h"',
+    ]
+    for cls in args.classes:
+        lines.append('#include "{}"'.format(header_name(args.package, cls)))
+
+    for cls in args.classes:
+        name = header_name(args.package, cls)
+        if name not in headers:
+            print("natives.py: missing header {}".format(name), file=sys.stderr)
+            return 1
+
+        methods = list(METHOD_RE.finditer(headers[name].read_text()))
+        if not methods:
+            print("natives.py: no native methods in {}".format(name), file=sys.stderr)
+            return 1
+
+        lines.append("")
+        lines.append("static const JNINativeMethod {}[] = {{".format(table_name(args.package, cls)))
+        for m in methods:
+            # ISO C does not allow converting a function pointer to void *, but
+            # JNINativeMethod requires it.
+            lines.append(
+                '    {{ "{}", "{}", __extension__(void *){} }},'.format(
+                    m.group("name"), m.group("signature"), m.group("function")
+                )
+            )
+        lines.append("};")
+
+    lines.append("")
+    lines.append("const struct native_class native_classes[] = {")
+    for cls in args.classes:
+        table = table_name(args.package, cls)
+        lines.append(
+            '    {{ "{}", {}, sizeof({}) / sizeof({}[0]) }},'.format(
+                binary_name(args.package, cls), table, table, table
+            )
+        )
+    lines.append("};")
+    lines.append("")
+    lines.append(
+        "const size_t native_classes_len = sizeof(native_classes) / sizeof(native_classes[0]);"
+    )
+
+    args.output.write_text("\n".join(lines) + "\n")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,365 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.io.BufferedReader;
+import java.io.EOFException;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.Optional;
+
+import io.github.hse_project.hse.Hse;
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.Kvdb;
+import io.github.hse_project.hse.Kvs;
+import io.github.hse_project.hse.KvsCursor;
+
+/**
+ * Report what the bindings add to each operation over calling HSE directly.
+ *
+ * <p>
+ * The {@code hsejni-bench} executable built next to the JNI library runs
+ * each workload against HSE from C. This driver runs it, then runs the same
+ * workloads through every overload family of the bindings, and prints one CSV
+ * row per operation, family, and key/value size with both costs and their
+ * difference.
+ * </p>
+ *
+ * <p>
+ * Both sides run identical workloads. Each starts from a fresh KVS, empty for
+ * puts and loaded with the same records otherwise; puts get a new KVS for
+ * every run, as they change it. Each workload is run {@value #WARMUP_RUNS}
+ * times untimed, then {@value #RUNS} times timed, and the mean and sample
+ * standard deviation of the timed runs are reported. Compare an overhead to
+ * the deviations before reading anything into it.
+ * </p>
+ *
+ * <p>Usage: {@code BindingOverhead PATH_TO_HSEJNI_BENCH}</p>
+ */
+public final class BindingOverhead {
+    private static final int[] KEY_SIZES = {16, 64, 256};
+    private static final int[] VALUE_SIZES = {16, 1024, 65536};
+    private static final int MAX_RECORDS = 65536;
+    private static final int DATASET_BYTES = 64 << 20;
+    private static final int PASSES = 4;
+    private static final int WARMUP_RUNS = 2;
+    private static final int RUNS = 5;
+    private static final String KVS_NAME = "bench";
+
+    private final Kvdb kvdb;
+    private final int keySize;
+    private final int valueSize;
+    private final int records;
+    private final int ops;
+    private final byte[][] keyBytes;
+    private final String[] keyStrings;
+    private final ByteBuffer[] keyBuffers;
+    private final byte[] valueBytes;
+    private final String valueString;
+    private final ByteBuffer valueBuffer;
+    private final byte[] keyBuf;
+    private final byte[] valueBuf;
+    private final ByteBuffer valueBufDirect;
+    private Kvs kvs;
+    private KvsCursor cursor;
+
+    private BindingOverhead(final Kvdb kvdb, final int keySize, final int valueSize) {
+        this.kvdb = kvdb;
+        this.keySize = keySize;
+        this.valueSize = valueSize;
+        this.records = Math.min(MAX_RECORDS, DATASET_BYTES / (keySize + valueSize));
+        this.ops = this.records * PASSES;
+        this.keyBytes = new byte[this.records][];
+        this.keyStrings = new String[this.records];
+        this.keyBuffers = new ByteBuffer[this.records];
+
+        for (int i = 0; i < this.records; i++) {
+            this.keyStrings[i] = String.format("%0" + keySize + "d", i);
+            this.keyBytes[i] = this.keyStrings[i].getBytes(StandardCharsets.UTF_8);
+            this.keyBuffers[i] = direct(this.keyBytes[i]);
+        }
+
+        final char[] value = new char[valueSize];
+        Arrays.fill(value, 'v');
+        this.valueString = new String(value);
+        this.valueBytes = this.valueString.getBytes(StandardCharsets.UTF_8);
+        this.valueBuffer = direct(this.valueBytes);
+        this.keyBuf = new byte[keySize];
+        this.valueBuf = new byte[valueSize];
+        this.valueBufDirect = ByteBuffer.allocateDirect(valueSize);
+    }
+
+    private static ByteBuffer direct(final byte[] data) {
+        final ByteBuffer buf = ByteBuffer.allocateDirect(data.length).put(data);
+        buf.flip();
+
+        return buf;
+    }
+
+    private static ByteBuffer rewind(final ByteBuffer buf) {
+        buf.rewind();
+
+        return buf;
+    }
+
+    private int index(final int i) {
+        return i % this.records;
+    }
+
+    private void rewindCursor() throws HseException {
+        this.cursor.seek(this.keyBytes[0]);
+    }
+
+    /** One operation of a workload. */
+    @FunctionalInterface
+    private interface Op {
+        void run(int i) throws HseException;
+    }
+
+    /** What a workload needs from its KVS, as in {@code hsejni-bench}. */
+    private enum Kind {
+        /** An empty KVS per run. */
+        PUT,
+        /** A loaded KVS. */
+        GET,
+        /** A loaded KVS, and a cursor at its first key at every run. */
+        CURSOR
+    }
+
+    private void setupKvs(final Kind kind) throws HseException {
+        this.kvdb.kvsCreate(KVS_NAME);
+        this.kvs = this.kvdb.kvsOpen(KVS_NAME);
+
+        if (kind == Kind.PUT) {
+            return;
+        }
+
+        for (int i = 0; i < this.records; i++) {
+            this.kvs.put(this.keyBytes[i], this.valueBytes);
+        }
+        this.kvdb.sync();
+
+        if (kind == Kind.CURSOR) {
+            this.cursor = this.kvs.cursor();
+        }
+    }
+
+    private void tearDownKvs() throws HseException {
+        if (this.cursor != null) {
+            this.cursor.close();
+            this.cursor = null;
+        }
+
+        this.kvs.close();
+        this.kvs = null;
+        this.kvdb.kvsDrop(KVS_NAME);
+    }
+
+    private double runOnce(final Op op) throws HseException {
+        final long start = System.nanoTime();
+        for (int i = 0; i < this.ops; i++) {
+            op.run(i);
+        }
+
+        return (double) (System.nanoTime() - start) / this.ops;
+    }
+
+    /**
+     * Run a workload as {@code hsejni-bench} does.
+     *
+     * @param kind What the workload needs from its KVS.
+     * @param op Operation to run.
+     * @return Mean and sample standard deviation of the nanoseconds per
+     *      operation of the timed runs.
+     */
+    private double[] measure(final Kind kind, final Op op) throws HseException {
+        final double[] samples = new double[RUNS];
+
+        if (kind != Kind.PUT) {
+            setupKvs(kind);
+        }
+
+        for (int r = -WARMUP_RUNS; r < RUNS; r++) {
+            if (kind == Kind.PUT) {
+                setupKvs(kind);
+            } else if (kind == Kind.CURSOR) {
+                rewindCursor();
+            }
+
+            final double ns = runOnce(op);
+
+            if (kind == Kind.PUT) {
+                tearDownKvs();
+            }
+            if (r >= 0) {
+                samples[r] = ns;
+            }
+        }
+
+        if (kind != Kind.PUT) {
+            tearDownKvs();
+        }
+
+        final double mean = Arrays.stream(samples).average().getAsDouble();
+        final double var = Arrays.stream(samples).map(x -> (x - mean) * (x - mean)).sum()
+            / (RUNS - 1);
+
+        return new double[]{mean, Math.sqrt(var)};
+    }
+
+    private void report(final Map<String, double[]> baseline, final String op,
+            final String family, final String nativeOp, final Kind kind, final Op fn)
+            throws HseException {
+        final double[] java = measure(kind, fn);
+        final double[] nat = baseline.get(
+            String.format("%s,%d,%d", nativeOp, this.keySize, this.valueSize));
+
+        if (nat == null) {
+            System.out.printf("%s,%s,%d,%d,,,%.1f,%.1f,%n", op, family, this.keySize,
+                this.valueSize, java[0], java[1]);
+        } else {
+            System.out.printf("%s,%s,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f%n", op, family,
+                this.keySize, this.valueSize, nat[0], nat[1], java[0], java[1],
+                java[0] - nat[0]);
+        }
+        System.out.flush();
+    }
+
+    private void run(final Map<String, double[]> baseline) throws HseException {
+        final KvsCursor.Entry entry = new KvsCursor.Entry(this.keySize, this.valueSize);
+        final KvsCursor.View view = new KvsCursor.View();
+
+        report(baseline, "put", "bytes", "put", Kind.PUT,
+            i -> this.kvs.put(this.keyBytes[index(i)], this.valueBytes));
+        report(baseline, "put", "string", "put", Kind.PUT,
+            i -> this.kvs.put(this.keyStrings[index(i)], this.valueString));
+        report(baseline, "put", "buffer", "put", Kind.PUT,
+            i -> this.kvs.put(rewind(this.keyBuffers[index(i)]), rewind(this.valueBuffer)));
+
+        report(baseline, "get", "bytes", "get", Kind.GET,
+            i -> this.kvs.get(this.keyBytes[index(i)], this.valueBuf));
+        report(baseline, "get", "string", "get", Kind.GET,
+            i -> this.kvs.get(this.keyStrings[index(i)], this.valueBuf));
+        report(baseline, "get", "buffer", "get", Kind.GET, i -> {
+            this.valueBufDirect.clear();
+            this.kvs.get(rewind(this.keyBuffers[index(i)]), this.valueBufDirect);
+        });
+        report(baseline, "get", "alloc", "get_scratch", Kind.GET,
+            i -> this.kvs.get(this.keyBytes[index(i)]));
+
+        report(baseline, "cursor_read", "view", "cursor_read", Kind.CURSOR, i -> {
+            if (!this.cursor.read(view)) {
+                rewindCursor();
+            }
+        });
+        report(baseline, "cursor_read", "entry", "cursor_read_copy", Kind.CURSOR, i -> {
+            if (!this.cursor.read(entry)) {
+                rewindCursor();
+            }
+        });
+        report(baseline, "cursor_read", "bytes", "cursor_read_copy", Kind.CURSOR, i -> {
+            try {
+                this.cursor.read(this.keyBuf, this.valueBuf);
+            } catch (final EOFException e) {
+                rewindCursor();
+            }
+        });
+
+        report(baseline, "seek", "bytes", "seek", Kind.CURSOR,
+            i -> this.cursor.seek(this.keyBytes[index(i)]));
+        report(baseline, "seek", "string", "seek", Kind.CURSOR,
+            i -> this.cursor.seek(this.keyStrings[index(i)]));
+        report(baseline, "seek", "buffer", "seek", Kind.CURSOR,
+            i -> this.cursor.seek(rewind(this.keyBuffers[index(i)])));
+    }
+
+    private static Path base() {
+        return Paths.get(Optional.ofNullable(System.getenv("MESON_BUILD_ROOT"))
+            .orElse(System.getProperty("java.io.tmpdir")));
+    }
+
+    /**
+     * Run the native benchmark, and collect its results.
+     *
+     * @param executable Path to {@code hsejni-bench}.
+     * @return Mean and standard deviation of the nanoseconds per operation,
+     *      keyed by {@code op,key_size,value_size}.
+     */
+    private static Map<String, double[]> runNative(final String executable)
+            throws IOException, InterruptedException {
+        final Map<String, double[]> baseline = new HashMap<>();
+        final Path home = Files.createTempDirectory(base(), "overhead-native-");
+
+        try {
+            final Process process = new ProcessBuilder(executable, home.toString())
+                .redirectError(ProcessBuilder.Redirect.INHERIT)
+                .start();
+
+            try (BufferedReader reader = new BufferedReader(new InputStreamReader(
+                    process.getInputStream(), StandardCharsets.UTF_8))) {
+                // Skip the header.
+                reader.readLine();
+                for (String line = reader.readLine(); line != null; line = reader.readLine()) {
+                    final String[] fields = line.split(",");
+                    baseline.put(String.join(",", fields[0], fields[1], fields[2]),
+                        new double[]{Double.parseDouble(fields[5]),
+                            Double.parseDouble(fields[6])});
+                }
+            }
+
+            if (process.waitFor() != 0) {
+                throw new IOException(executable + " exited with " + process.exitValue());
+            }
+        } finally {
+            Files.deleteIfExists(home);
+        }
+
+        return baseline;
+    }
+
+    /**
+     * Entry point.
+     *
+     * @param args Path to {@code hsejni-bench}.
+     * @throws Exception Benchmark failed.
+     */
+    public static void main(final String[] args) throws Exception {
+        if (args.length != 1) {
+            System.err.println("Usage: BindingOverhead PATH_TO_HSEJNI_BENCH");
+            System.exit(1);
+        }
+
+        final Map<String, double[]> baseline = runNative(args[0]);
+        final Path home = Files.createTempDirectory(base(), "overhead-java-");
+
+        System.out.println("op,family,key_size,value_size,native_ns_per_op,native_stddev_ns,"
+            + "java_ns_per_op,java_stddev_ns,overhead_ns_per_op");
+
+        Hse.init("rest.enabled=false");
+        try {
+            Kvdb.create(home);
+            try (Kvdb kvdb = Kvdb.open(home)) {
+                for (final int keySize : KEY_SIZES) {
+                    for (final int valueSize : VALUE_SIZES) {
+                        new BindingOverhead(kvdb, keySize, valueSize).run(baseline);
+                    }
+                }
+            }
+            Kvdb.drop(home);
+        } finally {
+            Hse.fini();
+            Files.deleteIfExists(home);
+        }
+    }
+}
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.io.EOFException;
+import java.nio.ByteBuffer;
+import java.util.AbstractMap.SimpleImmutableEntry;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.KvsCursor;
+
+/**
+ * Reads and seeks of {@link KvsCursor} across the {@code byte[]},
+ * {@link String}, and direct {@link ByteBuffer} overload families.
+ *
+ * <p>
+ * Reads wrap around to the first key at the end of the cursor. One
+ * invocation of {@link #readBatch(KvsState)} reads as many records as fit in
+ * its buffer.
+ * </p>
+ */
+@BenchmarkMode({Mode.Throughput, Mode.SampleTime})
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+@State(Scope.Thread)
+public class CursorBenchmark {
+    /** Minimum size of the batch buffer. */
+    private static final int BATCH_BUF_SZ = 256 << 10;
+
+    /** Cursor over the preloaded records. */
+    private KvsCursor cursor;
+    /** Index of the next key to seek to. */
+    private int next;
+    /** Destination of key copies into a {@code byte[]}. */
+    private byte[] keyBuf;
+    /** Destination of value copies into a {@code byte[]}. */
+    private byte[] valueBuf;
+    /** Destination of key copies into a direct {@link ByteBuffer}. */
+    private ByteBuffer keyBuffer;
+    /** Destination of value copies into a direct {@link ByteBuffer}. */
+    private ByteBuffer valueBuffer;
+    /** Destination of batch reads. */
+    private ByteBuffer batchBuffer;
+    /** Reusable entry. */
+    private KvsCursor.Entry entry;
+    /** Reusable view. */
+    private KvsCursor.View view;
+
+    @Setup(Level.Trial)
+    public void setup(final KvsState state) throws HseException {
+        this.cursor = state.kvs.cursor();
+        this.keyBuf = new byte[state.keySize];
+        this.valueBuf = new byte[state.valueSize];
+        this.keyBuffer = ByteBuffer.allocateDirect(state.keySize);
+        this.valueBuffer = ByteBuffer.allocateDirect(state.valueSize);
+        this.batchBuffer = ByteBuffer.allocateDirect(Math.max(BATCH_BUF_SZ,
+            2 * Integer.BYTES + state.keySize + state.valueSize));
+        this.entry = new KvsCursor.Entry(state.keySize, state.valueSize);
+        this.view = new KvsCursor.View();
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() throws HseException {
+        this.cursor.close();
+    }
+
+    private int next(final KvsState state) {
+        final int i = this.next;
+
+        this.next = i + 1 == state.records ? 0 : i + 1;
+
+        return i;
+    }
+
+    private static ByteBuffer rewind(final ByteBuffer buf) {
+        buf.rewind();
+
+        return buf;
+    }
+
+    private void restart(final KvsState state) throws HseException {
+        this.cursor.seek(state.keyBytes[0]);
+    }
+
+    @Benchmark
+    public SimpleImmutableEntry<byte[], byte[]> readAllocating(final KvsState state)
+            throws HseException {
+        try {
+            return this.cursor.read();
+        } catch (final EOFException e) {
+            restart(state);
+            return null;
+        }
+    }
+
+    @Benchmark
+    public SimpleImmutableEntry<Integer, Integer> readBytes(final KvsState state)
+            throws HseException {
+        try {
+            return this.cursor.read(this.keyBuf, this.valueBuf);
+        } catch (final EOFException e) {
+            restart(state);
+            return null;
+        }
+    }
+
+    @Benchmark
+    public SimpleImmutableEntry<Integer, Integer> readBuffers(final KvsState state)
+            throws HseException {
+        this.keyBuffer.clear();
+        this.valueBuffer.clear();
+
+        try {
+            return this.cursor.read(this.keyBuffer, this.valueBuffer);
+        } catch (final EOFException e) {
+            restart(state);
+            return null;
+        }
+    }
+
+    @Benchmark
+    public KvsCursor.Entry readEntry(final KvsState state) throws HseException {
+        if (!this.cursor.read(this.entry)) {
+            restart(state);
+        }
+
+        return this.entry;
+    }
+
+    @Benchmark
+    public KvsCursor.View readView(final KvsState state) throws HseException {
+        if (!this.cursor.read(this.view)) {
+            restart(state);
+        }
+
+        return this.view;
+    }
+
+    @Benchmark
+    public int readBatch(final KvsState state) throws HseException {
+        this.batchBuffer.clear();
+
+        final int records = this.cursor.readBatch(this.batchBuffer, Integer.MAX_VALUE);
+        if (records < 0) {
+            restart(state);
+        }
+
+        return records;
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekBytes(final KvsState state) throws HseException {
+        return this.cursor.seek(state.keyBytes[next(state)]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekString(final KvsState state) throws HseException {
+        return this.cursor.seek(state.keyStrings[next(state)]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekBuffer(final KvsState state) throws HseException {
+        return this.cursor.seek(rewind(state.keyBuffers[next(state)]));
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekRangeBytes(final KvsState state) throws HseException {
+        return this.cursor.seekRange(state.keyBytes[next(state)],
+            state.keyBytes[state.records - 1]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekRangeString(final KvsState state) throws HseException {
+        return this.cursor.seekRange(state.keyStrings[next(state)],
+            state.keyStrings[state.records - 1]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> seekRangeBuffer(final KvsState state) throws HseException {
+        return this.cursor.seekRange(rewind(state.keyBuffers[next(state)]),
+            rewind(state.keyBuffers[state.records - 1]));
+    }
+}
@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Group;
+import org.openjdk.jmh.annotations.GroupThreads;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import io.github.hse_project.hse.HseException;
+
+/**
+ * Throughput of the {@code byte[]} put and get paths, next to a thread which
+ * only allocates.
+ *
+ * <p>
+ * Each group runs one thread of {@code byte[]} operations and one thread
+ * allocating short-lived arrays. A binding which holds the garbage collector
+ * off while it is in HSE, as a JNI critical region does, shows up as lower
+ * allocation throughput, a long tail in the allocation latency, and more GC
+ * time under {@code -prof gc}. Compare the {@code allocate} results across
+ * value sizes, and against the same benchmark built from a tree which pins
+ * arrays, before drawing conclusions from the operation throughput alone.
+ * </p>
+ */
+@BenchmarkMode({Mode.Throughput, Mode.SampleTime})
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+@State(Scope.Thread)
+public class GcInterferenceBenchmark {
+    /** Size of every array allocated by the allocating thread. */
+    private static final int ALLOC_SZ = 1024;
+
+    /** Index of the next key. */
+    private int next;
+    /** Destination of gets. */
+    private byte[] valueBuf;
+
+    @Setup(Level.Trial)
+    public void setup(final KvsState state) {
+        this.valueBuf = new byte[state.valueSize];
+    }
+
+    private int next(final KvsState state) {
+        final int i = this.next;
+
+        this.next = i + 1 == state.records ? 0 : i + 1;
+
+        return i;
+    }
+
+    @Benchmark
+    @Group("put")
+    @GroupThreads(1)
+    public void putBytes(final KvsState state) throws HseException {
+        state.kvs.put(state.keyBytes[next(state)], state.valueBytes);
+    }
+
+    @Benchmark
+    @Group("put")
+    @GroupThreads(1)
+    public byte[] putAllocate() {
+        return new byte[ALLOC_SZ];
+    }
+
+    @Benchmark
+    @Group("get")
+    @GroupThreads(1)
+    public Optional<Integer> getBytesInto(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyBytes[next(state)], this.valueBuf);
+    }
+
+    @Benchmark
+    @Group("get")
+    @GroupThreads(1)
+    public byte[] getAllocate() {
+        return new byte[ALLOC_SZ];
+    }
+}
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.nio.ByteBuffer;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import io.github.hse_project.hse.HseException;
+
+/**
+ * Point operations of {@link io.github.hse_project.hse.Kvs} across the
+ * {@code byte[]}, {@link String}, and direct {@link ByteBuffer} overload
+ * families.
+ *
+ * <p>
+ * Every operation cycles through the preloaded keys, and each benchmark
+ * method runs against its own freshly loaded KVS. Puts overwrite the keys.
+ * Deletes would only find tombstones once they have been through every key,
+ * so each delete benchmark first puts its key back with an empty value, and
+ * {@link #restore(KvsState)} measures that put alone; subtract it from a
+ * delete score for the cost of the delete. Prefix deletes use prefixes which
+ * match no key. {@link ByteBuffer} arguments are rewound before every call, as
+ * the bindings consume them.
+ * </p>
+ */
+@BenchmarkMode({Mode.Throughput, Mode.SampleTime})
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+@State(Scope.Thread)
+public class KvsBenchmark {
+    /** Index of the next key. */
+    private int next;
+    /** Destination of copying gets into a {@code byte[]}. */
+    private byte[] valueBuf;
+    /** Destination of copying gets into a direct {@link ByteBuffer}. */
+    private ByteBuffer valueBuffer;
+
+    @Setup(Level.Trial)
+    public void setup(final KvsState state) {
+        this.valueBuf = new byte[state.valueSize];
+        this.valueBuffer = ByteBuffer.allocateDirect(state.valueSize);
+    }
+
+    private int next(final KvsState state) {
+        final int i = this.next;
+
+        this.next = i + 1 == state.records ? 0 : i + 1;
+
+        return i;
+    }
+
+    private static ByteBuffer rewind(final ByteBuffer buf) {
+        buf.rewind();
+
+        return buf;
+    }
+
+    @Benchmark
+    public void putBytes(final KvsState state) throws HseException {
+        state.kvs.put(state.keyBytes[next(state)], state.valueBytes);
+    }
+
+    @Benchmark
+    public void putString(final KvsState state) throws HseException {
+        state.kvs.put(state.keyStrings[next(state)], state.valueString);
+    }
+
+    @Benchmark
+    public void putBuffer(final KvsState state) throws HseException {
+        state.kvs.put(rewind(state.keyBuffers[next(state)]), rewind(state.valueBuffer));
+    }
+
+    @Benchmark
+    public Optional<byte[]> getBytes(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyBytes[next(state)]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> getString(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyStrings[next(state)]);
+    }
+
+    @Benchmark
+    public Optional<byte[]> getBuffer(final KvsState state) throws HseException {
+        return state.kvs.get(rewind(state.keyBuffers[next(state)]));
+    }
+
+    @Benchmark
+    public Optional<Integer> getBytesInto(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyBytes[next(state)], this.valueBuf);
+    }
+
+    @Benchmark
+    public Optional<Integer> getStringInto(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyStrings[next(state)], this.valueBuf);
+    }
+
+    @Benchmark
+    public Optional<Integer> getBufferInto(final KvsState state) throws HseException {
+        this.valueBuffer.clear();
+
+        return state.kvs.get(rewind(state.keyBuffers[next(state)]), this.valueBuffer);
+    }
+
+    private int nextPrefix(final KvsState state) {
+        return next(state) % state.prefixBytes.length;
+    }
+
+    /**
+     * Put a key back with an empty value, so that the delete which follows
+     * deletes a live key.
+     *
+     * @return Index of the key.
+     */
+    private int restoreNext(final KvsState state) throws HseException {
+        final int i = next(state);
+
+        state.kvs.put(state.keyBytes[i], state.emptyValue);
+
+        return i;
+    }
+
+    @Benchmark
+    public void restore(final KvsState state) throws HseException {
+        restoreNext(state);
+    }
+
+    @Benchmark
+    public void deleteBytes(final KvsState state) throws HseException {
+        state.kvs.delete(state.keyBytes[restoreNext(state)]);
+    }
+
+    @Benchmark
+    public void deleteString(final KvsState state) throws HseException {
+        state.kvs.delete(state.keyStrings[restoreNext(state)]);
+    }
+
+    @Benchmark
+    public void deleteBuffer(final KvsState state) throws HseException {
+        state.kvs.delete(rewind(state.keyBuffers[restoreNext(state)]));
+    }
+
+    @Benchmark
+    public void prefixDeleteBytes(final KvsState state) throws HseException {
+        state.kvs.prefixDelete(state.prefixBytes[nextPrefix(state)]);
+    }
+
+    @Benchmark
+    public void prefixDeleteString(final KvsState state) throws HseException {
+        state.kvs.prefixDelete(state.prefixStrings[nextPrefix(state)]);
+    }
+
+    @Benchmark
+    public void prefixDeleteBuffer(final KvsState state) throws HseException {
+        state.kvs.prefixDelete(rewind(state.prefixBuffers[nextPrefix(state)]));
+    }
+}
@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.Optional;
+
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+
+import io.github.hse_project.hse.Hse;
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.Kvdb;
+import io.github.hse_project.hse.Kvs;
+
+/**
+ * KVDB and KVS shared by the benchmarks of one trial, preloaded with records.
+ *
+ * <p>
+ * Every key is available as a {@code byte[]}, a {@link String}, and a direct
+ * {@link ByteBuffer} holding the same bytes, so that the overload families
+ * are compared on identical data. A key starts with its index as a
+ * {@value #INDEX_LEN}-digit decimal number, so keys sort in index order, and
+ * is padded with zeros to the key size. The KVS prefix is the leading
+ * {@value #PREFIX_LEN} digits, which puts every run of 100 consecutive keys
+ * under a prefix of its own.
+ * </p>
+ */
+@State(Scope.Benchmark)
+public class KvsState {
+    /** Length of a KVS prefix, and of the prefixes deleted by benchmarks. */
+    static final int PREFIX_LEN = 3;
+    /** Upper bound on the number of preloaded records. */
+    private static final int MAX_RECORDS = 65536;
+    /** Number of digits of the index which leads every key. */
+    private static final int INDEX_LEN = 5;
+    /** Number of distinct prefixes which match no key. */
+    private static final int UNMATCHED_PREFIXES = 100;
+    /** Approximate size of the preloaded data set. */
+    private static final int DATASET_BYTES = 64 << 20;
+
+    /** Key size in bytes. */
+    @Param({"16", "64", "256"})
+    public int keySize;
+
+    /** Value size in bytes. */
+    @Param({"16", "1024", "65536"})
+    public int valueSize;
+
+    /** KVDB home, created for the trial. */
+    private Path home;
+    /** KVDB. */
+    Kvdb kvdb;
+    /** KVS preloaded with {@link #records} records. */
+    Kvs kvs;
+    /** Number of preloaded records. */
+    int records;
+    /** Keys as {@code byte[]}. */
+    byte[][] keyBytes;
+    /** Keys as {@link String}. */
+    String[] keyStrings;
+    /** Keys as direct {@link ByteBuffer}. */
+    ByteBuffer[] keyBuffers;
+    /** Empty value, to restore deleted keys with. */
+    final byte[] emptyValue = new byte[0];
+    /** Prefixes which match no preloaded key, as {@code byte[]}. */
+    byte[][] prefixBytes;
+    /** Prefixes which match no preloaded key, as {@link String}. */
+    String[] prefixStrings;
+    /** Prefixes which match no preloaded key, as direct {@link ByteBuffer}. */
+    ByteBuffer[] prefixBuffers;
+    /** Value as {@code byte[]}. */
+    byte[] valueBytes;
+    /** Value as {@link String}. */
+    String valueString;
+    /** Value as direct {@link ByteBuffer}. */
+    ByteBuffer valueBuffer;
+
+    private static Path defaultBase() {
+        return Paths.get(Optional.ofNullable(System.getenv("MESON_BUILD_ROOT"))
+            .orElse(System.getProperty("java.io.tmpdir")));
+    }
+
+    private static String key(final int i, final int keySize) {
+        final StringBuilder key = new StringBuilder(keySize);
+
+        key.append(String.format("%0" + INDEX_LEN + "d", i));
+        while (key.length() < keySize) {
+            key.append('0');
+        }
+
+        return key.toString();
+    }
+
+    private static ByteBuffer direct(final byte[] data) {
+        final ByteBuffer buf = ByteBuffer.allocateDirect(data.length).put(data);
+        buf.flip();
+
+        return buf;
+    }
+
+    @Setup(Level.Trial)
+    public void setup() throws HseException, IOException {
+        this.records = Math.min(MAX_RECORDS, DATASET_BYTES / (this.keySize + this.valueSize));
+        this.keyBytes = new byte[this.records][];
+        this.keyStrings = new String[this.records];
+        this.keyBuffers = new ByteBuffer[this.records];
+        this.prefixBytes = new byte[UNMATCHED_PREFIXES][];
+        this.prefixStrings = new String[UNMATCHED_PREFIXES];
+        this.prefixBuffers = new ByteBuffer[UNMATCHED_PREFIXES];
+
+        for (int i = 0; i < this.records; i++) {
+            this.keyStrings[i] = key(i, this.keySize);
+            this.keyBytes[i] = this.keyStrings[i].getBytes(StandardCharsets.UTF_8);
+            this.keyBuffers[i] = direct(this.keyBytes[i]);
+        }
+
+        for (int i = 0; i < UNMATCHED_PREFIXES; i++) {
+            // Keys are all digits, so these never match a key.
+            this.prefixStrings[i] = String.format("p%0" + (PREFIX_LEN - 1) + "d", i);
+            this.prefixBytes[i] = this.prefixStrings[i].getBytes(StandardCharsets.UTF_8);
+            this.prefixBuffers[i] = direct(this.prefixBytes[i]);
+        }
+
+        final char[] value = new char[this.valueSize];
+        Arrays.fill(value, 'v');
+        this.valueString = new String(value);
+        this.valueBytes = this.valueString.getBytes(StandardCharsets.UTF_8);
+        this.valueBuffer = direct(this.valueBytes);
+
+        this.home = Files.createTempDirectory(defaultBase(), "jmh-");
+
+        Hse.init("rest.enabled=false");
+        Kvdb.create(this.home);
+        this.kvdb = Kvdb.open(this.home);
+        this.kvdb.kvsCreate("bench", "prefix.length=" + PREFIX_LEN);
+        this.kvs = this.kvdb.kvsOpen("bench");
+
+        for (int i = 0; i < this.records; i++) {
+            this.kvs.put(this.keyBytes[i], this.valueBytes);
+        }
+        this.kvdb.sync();
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() throws HseException, IOException {
+        this.kvs.close();
+        this.kvdb.close();
+        Kvdb.drop(this.home);
+        Hse.fini();
+        Files.deleteIfExists(this.home);
+    }
+}
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+
+import org.openjdk.jmh.results.RunResult;
+import org.openjdk.jmh.runner.Runner;
+import org.openjdk.jmh.runner.RunnerException;
+import org.openjdk.jmh.runner.options.OptionsBuilder;
+import org.openjdk.jmh.runner.options.VerboseMode;
+
+/**
+ * Sweep {@link ScalabilityBenchmark} over thread counts, and report how
+ * throughput scales.
+ *
+ * <p>
+ * Every benchmark runs at 1, 2, 4, and so on up to the maximum thread count,
+ * and at the maximum itself, once with shared handles and once with handles
+ * per thread. One CSV row is printed per benchmark, handle mode, and thread
+ * count, with the throughput, the speedup over one thread, and the scaling
+ * efficiency: the speedup divided by the thread count. An efficiency which
+ * falls off with shared handles but not with handles per thread points at
+ * serialization on the handle.
+ * </p>
+ *
+ * <p>
+ * Usage: {@code Scalability [MAX_THREADS]}. The maximum defaults to the
+ * number of available processors.
+ * </p>
+ */
+public final class Scalability {
+    private static final String[] HANDLES = {"shared", "perThread"};
+
+    private Scalability() {
+    }
+
+    private static List<Integer> threadCounts(final int max) {
+        final List<Integer> counts = new ArrayList<>();
+
+        for (int t = 1; t < max; t *= 2) {
+            counts.add(t);
+        }
+        counts.add(max);
+
+        return counts;
+    }
+
+    /**
+     * Run every benchmark at one thread count.
+     *
+     * @return Operations per second, keyed by benchmark method name.
+     */
+    private static Map<String, Double> run(final String handles, final int threads)
+            throws RunnerException {
+        final Map<String, Double> scores = new TreeMap<>();
+        final String benchmark = ScalabilityBenchmark.class.getName();
+
+        for (final RunResult result : new Runner(new OptionsBuilder()
+                .include(benchmark.replace(".", "\\.") + "\\.")
+                .param("handles", handles)
+                .threads(threads)
+                .verbosity(VerboseMode.SILENT)
+                .build()).run()) {
+            final String label = result.getParams().getBenchmark();
+
+            scores.put(label.substring(label.lastIndexOf('.') + 1),
+                result.getPrimaryResult().getScore());
+        }
+
+        return scores;
+    }
+
+    /**
+     * Entry point.
+     *
+     * @param args Optional maximum thread count.
+     * @throws Exception Benchmark failed.
+     */
+    public static void main(final String[] args) throws Exception {
+        final int max = args.length > 0
+            ? Integer.parseInt(args[0])
+            : Runtime.getRuntime().availableProcessors();
+
+        if (max < 1 || args.length > 1) {
+            System.err.println("Usage: Scalability [MAX_THREADS]");
+            System.exit(1);
+        }
+
+        System.out.println("benchmark,handles,threads,ops_per_s,speedup,efficiency");
+        for (final String handles : HANDLES) {
+            final Map<String, Double> baseline = new HashMap<>();
+
+            for (final int threads : threadCounts(max)) {
+                for (final Map.Entry<String, Double> e : run(handles, threads).entrySet()) {
+                    final double score = e.getValue();
+
+                    baseline.putIfAbsent(e.getKey(), score);
+
+                    final double speedup = score / baseline.get(e.getKey());
+                    System.out.printf("%s,%s,%d,%.1f,%.3f,%.3f%n", e.getKey(), handles,
+                        threads, score, speedup, speedup / threads);
+                }
+                System.out.flush();
+            }
+        }
+    }
+}
@@ -0,0 +1,258 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+import org.openjdk.jmh.infra.ThreadParams;
+
+import io.github.hse_project.hse.Hse;
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.Kvdb;
+import io.github.hse_project.hse.KvdbTransaction;
+import io.github.hse_project.hse.Kvs;
+import io.github.hse_project.hse.KvsCursor;
+
+/**
+ * Throughput of the bindings as threads are added, with handles shared by
+ * every thread or owned by each thread.
+ *
+ * <p>
+ * With {@code handles=shared}, every thread operates on the same {@link Kvs}.
+ * With {@code handles=perThread}, every thread opens its own KVS, loaded with
+ * the same records. Comparing the two at equal thread counts separates
+ * contention on a handle from contention elsewhere in the bindings or HSE.
+ * Cursors and transactions are always per thread, as neither may be used by
+ * more than one thread at a time: in shared mode, each thread creates its own
+ * cursor over the shared KVS. Transactions write keys of their own thread so
+ * that they never conflict.
+ * </p>
+ *
+ * <p>
+ * {@link Scalability} runs these benchmarks at increasing thread counts, and
+ * reports how close each comes to scaling linearly.
+ * </p>
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 2, time = 1)
+@Measurement(iterations = 3, time = 2)
+@Fork(1)
+public class ScalabilityBenchmark {
+    /** Number of records in every loaded KVS. */
+    static final int RECORDS = 16384;
+    /** Size of every value. */
+    static final int VALUE_SIZE = 64;
+    /** Number of keys written by the transactions of a thread. */
+    static final int TXN_KEYS = 1024;
+
+    private static byte[] key(final int i) {
+        return String.format("%016d", i).getBytes(StandardCharsets.UTF_8);
+    }
+
+    private static Kvs openLoaded(final Kvdb kvdb, final String name, final byte[][] keys,
+            final byte[] value) throws HseException {
+        kvdb.kvsCreate(name);
+
+        final Kvs kvs = kvdb.kvsOpen(name);
+        for (final byte[] key : keys) {
+            kvs.put(key, value);
+        }
+
+        return kvs;
+    }
+
+    /** KVDB of the trial, with the handles shared by every thread. */
+    @State(Scope.Benchmark)
+    public static class Shared {
+        /** Whether threads share handles, or open their own. */
+        @Param({"shared", "perThread"})
+        public String handles;
+
+        /** KVDB home, created for the trial. */
+        private Path home;
+        /** KVDB. */
+        Kvdb kvdb;
+        /** Keys of the loaded records, in order. */
+        byte[][] keys;
+        /** Value of every record. */
+        byte[] value;
+        /** Loaded KVS, shared if {@link #handles} is {@code shared}. */
+        Kvs kvs;
+        /** KVS with transactions enabled, shared if {@link #handles} is {@code shared}. */
+        Kvs txnKvs;
+
+        boolean isShared() {
+            return "shared".equals(this.handles);
+        }
+
+        @Setup(Level.Trial)
+        public void setup() throws HseException, IOException {
+            this.keys = new byte[RECORDS][];
+            for (int i = 0; i < RECORDS; i++) {
+                this.keys[i] = key(i);
+            }
+            this.value = new byte[VALUE_SIZE];
+
+            this.home = Files.createTempDirectory(Paths.get(Optional.ofNullable(
+                System.getenv("MESON_BUILD_ROOT")).orElse(System.getProperty("java.io.tmpdir"))),
+                "jmh-");
+
+            Hse.init("rest.enabled=false");
+            Kvdb.create(this.home);
+            this.kvdb = Kvdb.open(this.home);
+
+            if (isShared()) {
+                this.kvs = openLoaded(this.kvdb, "shared", this.keys, this.value);
+                this.kvdb.kvsCreate("shared-txn");
+                this.txnKvs = this.kvdb.kvsOpen("shared-txn", "transactions.enabled=true");
+            }
+            this.kvdb.sync();
+        }
+
+        @TearDown(Level.Trial)
+        public void tearDown() throws HseException, IOException {
+            if (isShared()) {
+                this.kvs.close();
+                this.txnKvs.close();
+            }
+            this.kvdb.close();
+            Kvdb.drop(this.home);
+            Hse.fini();
+            Files.deleteIfExists(this.home);
+        }
+    }
+
+    /**
+     * Handles used by one thread. The KVSs are its own if handles are not
+     * shared, and the cursor and transaction always are.
+     */
+    @State(Scope.Thread)
+    public static class PerThread {
+        /** Loaded KVS. */
+        private Kvs kvs;
+        /** Cursor over {@link #kvs}, always this thread's own. */
+        private KvsCursor cursor;
+        /** KVS with transactions enabled. */
+        private Kvs txnKvs;
+        /** Whether the KVSs above belong to this thread. */
+        private boolean owned;
+        /** Transaction of this thread. */
+        private KvdbTransaction txn;
+        /** Keys written by the transactions of this thread. */
+        private byte[][] txnKeys;
+        /** Reusable view. */
+        private final KvsCursor.View view = new KvsCursor.View();
+        /** Destination of gets. */
+        private final byte[] valueBuf = new byte[VALUE_SIZE];
+        /** Index of the next key. */
+        private int next;
+
+        @Setup(Level.Trial)
+        public void setup(final Shared shared, final ThreadParams params) throws HseException {
+            final int thread = params.getThreadIndex();
+
+            this.owned = !shared.isShared();
+            if (this.owned) {
+                this.kvs = openLoaded(shared.kvdb, "thread-" + thread, shared.keys,
+                    shared.value);
+                shared.kvdb.kvsCreate("thread-txn-" + thread);
+                this.txnKvs = shared.kvdb.kvsOpen("thread-txn-" + thread,
+                    "transactions.enabled=true");
+            } else {
+                this.kvs = shared.kvs;
+                this.txnKvs = shared.txnKvs;
+            }
+            this.cursor = this.kvs.cursor();
+
+            this.txn = shared.kvdb.transaction();
+            this.txnKeys = new byte[TXN_KEYS][];
+            for (int i = 0; i < TXN_KEYS; i++) {
+                this.txnKeys[i] = String.format("t%04d-%011d", thread, i)
+                    .getBytes(StandardCharsets.UTF_8);
+            }
+
+            // Spread the threads over the key space.
+            this.next = (int) ((long) RECORDS * thread / params.getThreadCount());
+        }
+
+        @TearDown(Level.Trial)
+        public void tearDown() throws HseException {
+            this.txn.close();
+            this.cursor.close();
+            if (this.owned) {
+                this.kvs.close();
+                this.txnKvs.close();
+            }
+        }
+
+        int next() {
+            final int i = this.next;
+
+            this.next = i + 1 == RECORDS ? 0 : i + 1;
+
+            return i;
+        }
+    }
+
+    @Benchmark
+    public Optional<Integer> get(final Shared shared, final PerThread t) throws HseException {
+        return t.kvs.get(shared.keys[t.next()], t.valueBuf);
+    }
+
+    @Benchmark
+    public void put(final Shared shared, final PerThread t) throws HseException {
+        t.kvs.put(shared.keys[t.next()], shared.value);
+    }
+
+    @Benchmark
+    public void transaction(final Shared shared, final PerThread t, final Blackhole bh)
+            throws HseException {
+        final byte[] key = t.txnKeys[t.next() % TXN_KEYS];
+
+        t.txn.begin();
+        bh.consume(t.txnKvs.get(key, t.valueBuf, t.txn));
+        t.txnKvs.put(key, shared.value, t.txn);
+        t.txn.commit();
+    }
+
+    @Benchmark
+    public KvsCursor.View cursorRead(final Shared shared, final PerThread t)
+            throws HseException {
+        if (!t.cursor.read(t.view)) {
+            t.cursor.seek(shared.keys[0]);
+        }
+
+        return t.view;
+    }
+
+    @Benchmark
+    public boolean cursorSeekRead(final Shared shared, final PerThread t) throws HseException {
+        t.cursor.seek(shared.keys[t.next()]);
+
+        return t.cursor.read(t.view);
+    }
+}
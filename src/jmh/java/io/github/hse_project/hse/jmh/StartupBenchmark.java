@@ -0,0 +1,184 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.io.EOFException;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+import io.github.hse_project.hse.Hse;
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.Kvdb;
+import io.github.hse_project.hse.Kvs;
+import io.github.hse_project.hse.KvsCursor;
+
+/**
+ * Time from {@link Hse#init} to the first completed call of the synchronous
+ * {@link Kvs} and {@link KvsCursor} overloads, in a fresh JVM.
+ *
+ * <p>
+ * Every fork measures exactly one cold start: loading the JNI library and
+ * registering its natives, initializing HSE, creating and opening a KVDB and a
+ * KVS, and then calling each put, get, delete, prefix delete, cursor create,
+ * read, and seek overload once. The first call of an overload is where lazy
+ * symbol lookup used to be paid, so the spread across forks is as interesting
+ * as the mean.
+ * </p>
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@Warmup(iterations = 0)
+@Measurement(iterations = 1)
+@Fork(20)
+@State(Scope.Benchmark)
+public class StartupBenchmark {
+    /** Length of the KVS prefix, and of every prefix deleted. */
+    private static final int PREFIX_LEN = 3;
+    /** Size of every destination buffer. */
+    private static final int BUF_SZ = 64;
+
+    /** KVDB home, created for the trial. */
+    private Path home;
+    /** KVDB opened by the benchmark. */
+    private Kvdb kvdb;
+    /** KVS opened by the benchmark. */
+    private Kvs kvs;
+
+    private static byte[] bytes(final String s) {
+        return s.getBytes(StandardCharsets.UTF_8);
+    }
+
+    private static ByteBuffer direct(final String s) {
+        final byte[] data = bytes(s);
+        final ByteBuffer buf = ByteBuffer.allocateDirect(data.length).put(data);
+        buf.flip();
+
+        return buf;
+    }
+
+    @Setup(Level.Trial)
+    public void setup() throws IOException {
+        this.home = Files.createTempDirectory(Paths.get(Optional.ofNullable(
+            System.getenv("MESON_BUILD_ROOT")).orElse(System.getProperty("java.io.tmpdir"))),
+            "jmh-startup-");
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() throws HseException, IOException {
+        if (this.kvs != null) {
+            this.kvs.close();
+        }
+        if (this.kvdb != null) {
+            this.kvdb.close();
+            Kvdb.drop(this.home);
+        }
+        Hse.fini();
+        Files.deleteIfExists(this.home);
+    }
+
+    private void put() throws HseException {
+        this.kvs.put(bytes("key0"), bytes("value"));
+        this.kvs.put(bytes("key1"), "value");
+        this.kvs.put(bytes("key2"), direct("value"));
+        this.kvs.put("key3", bytes("value"));
+        this.kvs.put("key4", "value");
+        this.kvs.put("key5", direct("value"));
+        this.kvs.put(direct("key6"), bytes("value"));
+        this.kvs.put(direct("key7"), "value");
+        this.kvs.put(direct("key8"), direct("value"));
+    }
+
+    private void get(final Blackhole bh) throws HseException {
+        final byte[] valueBuf = new byte[BUF_SZ];
+
+        bh.consume(this.kvs.get(bytes("key0")));
+        bh.consume(this.kvs.get("key1"));
+        bh.consume(this.kvs.get(direct("key2")));
+        bh.consume(this.kvs.get(bytes("key3"), valueBuf));
+        bh.consume(this.kvs.get("key4", valueBuf));
+        bh.consume(this.kvs.get(direct("key5"), valueBuf));
+        bh.consume(this.kvs.get(bytes("key6"), ByteBuffer.allocateDirect(BUF_SZ)));
+        bh.consume(this.kvs.get("key7", ByteBuffer.allocateDirect(BUF_SZ)));
+        bh.consume(this.kvs.get(direct("key8"), ByteBuffer.allocateDirect(BUF_SZ)));
+    }
+
+    private void cursor(final Blackhole bh) throws EOFException, HseException {
+        final byte[] keyBuf = new byte[BUF_SZ];
+        final byte[] valueBuf = new byte[BUF_SZ];
+
+        try (KvsCursor cursor = this.kvs.cursor(bytes("key"))) {
+            bh.consume(cursor.read());
+            bh.consume(cursor.read(keyBuf, valueBuf));
+            bh.consume(cursor.read(keyBuf, ByteBuffer.allocateDirect(BUF_SZ)));
+            bh.consume(cursor.read(ByteBuffer.allocateDirect(BUF_SZ), valueBuf));
+            bh.consume(cursor.read(ByteBuffer.allocateDirect(BUF_SZ),
+                ByteBuffer.allocateDirect(BUF_SZ)));
+            bh.consume(cursor.read(new KvsCursor.Entry(BUF_SZ, BUF_SZ)));
+            bh.consume(cursor.read(new KvsCursor.View()));
+
+            bh.consume(cursor.seek(bytes("key0")));
+            bh.consume(cursor.seek("key1"));
+            bh.consume(cursor.seek(direct("key2")));
+            bh.consume(cursor.seek(bytes("key3"), keyBuf));
+            bh.consume(cursor.seek("key4", keyBuf));
+            bh.consume(cursor.seek(direct("key5"), keyBuf));
+            bh.consume(cursor.seekRange(bytes("key0"), bytes("key8")));
+            bh.consume(cursor.seekRange("key0", "key8"));
+            bh.consume(cursor.seekRange(direct("key0"), direct("key8")));
+        }
+
+        try (KvsCursor cursor = this.kvs.cursor("key")) {
+            bh.consume(cursor.read());
+        }
+
+        try (KvsCursor cursor = this.kvs.cursor(direct("key"))) {
+            bh.consume(cursor.read());
+        }
+    }
+
+    private void delete() throws HseException {
+        this.kvs.delete(bytes("key0"));
+        this.kvs.delete("key1");
+        this.kvs.delete(direct("key2"));
+        this.kvs.prefixDelete(bytes("pf0"));
+        this.kvs.prefixDelete("pf1");
+        this.kvs.prefixDelete(direct("pf2"));
+    }
+
+    @Benchmark
+    public void firstCalls(final Blackhole bh) throws EOFException, HseException {
+        Hse.init("rest.enabled=false");
+        Kvdb.create(this.home);
+        this.kvdb = Kvdb.open(this.home);
+        this.kvdb.kvsCreate("startup", "prefix.length=" + PREFIX_LEN);
+        this.kvs = this.kvdb.kvsOpen("startup");
+
+        put();
+        get(bh);
+        cursor(bh);
+        delete();
+    }
+}
@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.ycsb;
+
+import java.util.Locale;
+import java.util.concurrent.ThreadLocalRandom;
+
+/**
+ * Distribution of the keys which operations of a workload touch, as in the
+ * YCSB core workloads.
+ *
+ * <p>
+ * Choosers are shared by every worker, and draw from the random number
+ * generator of the calling thread.
+ * </p>
+ */
+interface KeyChooser {
+    /**
+     * Choose a key.
+     *
+     * @param limit Number of keys inserted so far.
+     * @return Key number in {@code [0, limit)}.
+     */
+    long next(long limit);
+
+    /**
+     * Create a chooser.
+     *
+     * @param name {@code uniform}, {@code zipfian}, or {@code latest}.
+     * @param items Upper bound on the number of keys over the run.
+     * @return Chooser.
+     * @throws IllegalArgumentException Unknown distribution.
+     */
+    static KeyChooser of(final String name, final long items) {
+        switch (name.toLowerCase(Locale.ROOT)) {
+        case "uniform":
+            return new Uniform();
+        case "zipfian":
+            return new ScrambledZipfian(items);
+        case "latest":
+            return new Latest(items);
+        default:
+            throw new IllegalArgumentException("Unknown distribution: " + name);
+        }
+    }
+
+    /** Every key equally likely. */
+    final class Uniform implements KeyChooser {
+        @Override
+        public long next(final long limit) {
+            return ThreadLocalRandom.current().nextLong(limit);
+        }
+    }
+
+    /**
+     * Zipfian distribution over {@code [0, items)}, most popular first, by the
+     * method of Gray et al., "Quickly Generating Billion-Record Synthetic
+     * Databases", as YCSB does.
+     */
+    final class Zipfian {
+        /** Skew of the YCSB core workloads. */
+        static final double THETA = 0.99;
+
+        private final long items;
+        private final double alpha;
+        private final double eta;
+        private final double zetan;
+        private final double half;
+
+        Zipfian(final long items) {
+            final double zeta2 = zeta(2);
+
+            this.items = items;
+            this.zetan = zeta(items);
+            this.alpha = 1 / (1 - THETA);
+            this.eta = (1 - Math.pow(2.0 / items, 1 - THETA)) / (1 - zeta2 / this.zetan);
+            this.half = 1 + Math.pow(0.5, THETA);
+        }
+
+        private static double zeta(final long n) {
+            double sum = 0;
+
+            for (long i = 1; i <= n; i++) {
+                sum += 1 / Math.pow(i, THETA);
+            }
+
+            return sum;
+        }
+
+        long next() {
+            final double u = ThreadLocalRandom.current().nextDouble();
+            final double uz = u * this.zetan;
+
+            if (uz < 1) {
+                return 0;
+            }
+            if (uz < this.half) {
+                return 1;
+            }
+
+            return Math.min(this.items - 1,
+                (long) (this.items * Math.pow(this.eta * u - this.eta + 1, this.alpha)));
+        }
+    }
+
+    /**
+     * Zipfian popularity, with the popular keys scattered over the key space
+     * rather than clustered at its start.
+     */
+    final class ScrambledZipfian implements KeyChooser {
+        private final Zipfian zipfian;
+        private final long items;
+
+        ScrambledZipfian(final long items) {
+            this.items = items;
+            this.zipfian = new Zipfian(items);
+        }
+
+        @Override
+        public long next(final long limit) {
+            // Redraw keys which have not been inserted yet, as YCSB does.
+            while (true) {
+                final long key = Long.remainderUnsigned(
+                    Keys.fnv1a(this.zipfian.next()), this.items);
+                if (key < limit) {
+                    return key;
+                }
+            }
+        }
+    }
+
+    /** Zipfian popularity, with the most recently inserted keys most popular. */
+    final class Latest implements KeyChooser {
+        private final Zipfian zipfian;
+
+        Latest(final long items) {
+            this.zipfian = new Zipfian(items);
+        }
+
+        @Override
+        public long next(final long limit) {
+            return Math.max(0, limit - 1 - this.zipfian.next() % limit);
+        }
+    }
+}
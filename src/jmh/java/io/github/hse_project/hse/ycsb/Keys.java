@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.ycsb;
+
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Mapping from key numbers to keys.
+ *
+ * <p>
+ * Like YCSB, key numbers are hashed, so that keys inserted one after another
+ * land far apart in the key space. Keys are {@code user} followed by the hash
+ * as 20 zero-padded decimal digits, so every key is {@value #KEY_LEN} bytes.
+ * </p>
+ */
+final class Keys {
+    /** Length of every key. */
+    static final int KEY_LEN = 24;
+
+    private static final long FNV_OFFSET_BASIS = 0xcbf29ce484222325L;
+    private static final long FNV_PRIME = 0x100000001b3L;
+    private static final int BYTE_MASK = 0xff;
+
+    private Keys() {
+    }
+
+    /**
+     * FNV-1a hash of the bytes of a long, little-endian.
+     *
+     * @param value Value to hash.
+     * @return Hash.
+     */
+    static long fnv1a(final long value) {
+        long hash = FNV_OFFSET_BASIS;
+
+        for (int i = 0; i < Long.BYTES; i++) {
+            hash ^= (value >>> (i * Byte.SIZE)) & BYTE_MASK;
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    /**
+     * Get the key of a key number.
+     *
+     * @param keyNum Key number.
+     * @return Key.
+     */
+    static byte[] key(final long keyNum) {
+        final String digits = Long.toUnsignedString(fnv1a(keyNum));
+        final StringBuilder key = new StringBuilder(KEY_LEN).append("user");
+
+        for (int i = key.length() + digits.length(); i < KEY_LEN; i++) {
+            key.append('0');
+        }
+
+        return key.append(digits).toString().getBytes(StandardCharsets.US_ASCII);
+    }
+}
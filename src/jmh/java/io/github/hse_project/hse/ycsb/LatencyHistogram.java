@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.ycsb;
+
+/**
+ * Log-linear histogram of latencies in nanoseconds, in the manner of
+ * HdrHistogram.
+ *
+ * <p>
+ * Values below {@value #SUB_BUCKETS} are counted exactly. Above that, every
+ * power of two is split into {@value #HALF_SUB_BUCKETS} buckets of equal
+ * width, so reported percentiles are within 1/{@value #HALF_SUB_BUCKETS} of
+ * the recorded value at any magnitude, in constant memory.
+ * </p>
+ *
+ * <p>
+ * Recording is not synchronized. Every worker records into its own histogram,
+ * and the histograms are merged with {@link #add(LatencyHistogram)} once the
+ * workers are done.
+ * </p>
+ */
+final class LatencyHistogram {
+    /** Number of exactly counted values, and of buckets in the first range. */
+    private static final int SUB_BUCKETS = 128;
+    /** Number of buckets per power of two above {@link #SUB_BUCKETS}. */
+    private static final int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    /** Base two logarithm of {@link #HALF_SUB_BUCKETS}. */
+    private static final int HALF_SUB_BUCKETS_SHIFT =
+        Integer.numberOfTrailingZeros(HALF_SUB_BUCKETS);
+    /** Enough buckets for any non-negative {@code long}. */
+    private static final int BUCKETS =
+        SUB_BUCKETS + (Long.SIZE - 1 - HALF_SUB_BUCKETS_SHIFT - 1) * HALF_SUB_BUCKETS;
+
+    private final long[] counts = new long[BUCKETS];
+    private long count;
+    private long sum;
+    private long min = Long.MAX_VALUE;
+    private long max;
+
+    private static int bucket(final long value) {
+        if (value < SUB_BUCKETS) {
+            return (int) value;
+        }
+
+        final int magnitude = Long.SIZE - 1 - Long.numberOfLeadingZeros(value)
+            - HALF_SUB_BUCKETS_SHIFT;
+
+        return SUB_BUCKETS + (magnitude - 1) * HALF_SUB_BUCKETS
+            + (int) (value >>> magnitude) - HALF_SUB_BUCKETS;
+    }
+
+    /** Largest value which falls in the bucket. */
+    private static long highestValue(final int bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+
+        final int magnitude = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+        final long subBucket = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+
+        return ((subBucket + 1) << magnitude) - 1;
+    }
+
+    /**
+     * Record a latency.
+     *
+     * @param nanos Latency in nanoseconds. Negative values are recorded as 0.
+     */
+    void record(final long nanos) {
+        final long value = Math.max(0, nanos);
+
+        this.counts[bucket(value)]++;
+        this.count++;
+        this.sum += value;
+        this.min = Math.min(this.min, value);
+        this.max = Math.max(this.max, value);
+    }
+
+    /**
+     * Add the values of another histogram to this one.
+     *
+     * @param other Histogram to add.
+     */
+    void add(final LatencyHistogram other) {
+        for (int i = 0; i < BUCKETS; i++) {
+            this.counts[i] += other.counts[i];
+        }
+        this.count += other.count;
+        this.sum += other.sum;
+        this.min = Math.min(this.min, other.min);
+        this.max = Math.max(this.max, other.max);
+    }
+
+    long getCount() {
+        return this.count;
+    }
+
+    long getMin() {
+        return this.count == 0 ? 0 : this.min;
+    }
+
+    long getMax() {
+        return this.max;
+    }
+
+    double getMean() {
+        return this.count == 0 ? 0 : (double) this.sum / this.count;
+    }
+
+    /**
+     * Get the value at a percentile.
+     *
+     * @param percentile Percentile between 0 and 100.
+     * @return Highest value of the bucket holding the percentile, capped at the
+     *     largest recorded value.
+     */
+    long getValueAtPercentile(final double percentile) {
+        if (this.count == 0) {
+            return 0;
+        }
+
+        final long rank = Math.max(1, (long) Math.ceil(percentile / 100 * this.count));
+        long seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += this.counts[i];
+            if (seen >= rank) {
+                return Math.min(highestValue(i), this.max);
+            }
+        }
+
+        return this.max;
+    }
+}
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.ycsb;
+
+import java.util.Locale;
+
+/**
+ * Operation mixes of the YCSB core workloads, and of two profiles of our own.
+ *
+ * <p>
+ * Proportions are in percent, and add up to 100.
+ * </p>
+ */
+enum Workload {
+    /** Update heavy: 50% reads, 50% updates. */
+    A(50, 50, 0, 0, 0, "zipfian", 0),
+    /** Read mostly: 95% reads, 5% updates. */
+    B(95, 5, 0, 0, 0, "zipfian", 0),
+    /** Read only. */
+    C(100, 0, 0, 0, 0, "zipfian", 0),
+    /** Read latest: 95% reads, 5% inserts, favoring recent inserts. */
+    D(95, 0, 5, 0, 0, "latest", 0),
+    /** Short ranges: 95% scans of up to 100 records, 5% inserts. */
+    E(0, 0, 5, 95, 0, "zipfian", 100),
+    /** Read-modify-write: 50% reads, 50% reads followed by an update. */
+    F(50, 0, 0, 0, 50, "zipfian", 0),
+    /** Scan heavy: scans of up to 1000 records only. */
+    SCAN(0, 0, 0, 100, 0, "uniform", 1000),
+    /** Ingest only: inserts of new keys only. */
+    INGEST(0, 0, 100, 0, 0, "uniform", 0);
+
+    /** Operations of a workload. */
+    enum Operation {
+        READ,
+        UPDATE,
+        INSERT,
+        SCAN,
+        READ_MODIFY_WRITE;
+
+        /**
+         * Get the name of the operation in reports.
+         *
+         * @return Lower case name.
+         */
+        String label() {
+            return name().toLowerCase(Locale.ROOT);
+        }
+    }
+
+    private static final int PERCENT = 100;
+
+    private final int[] thresholds = new int[Operation.values().length];
+    private final String distribution;
+    private final int maxScanLength;
+
+    Workload(final int read, final int update, final int insert, final int scan,
+            final int readModifyWrite, final String distribution, final int maxScanLength) {
+        final int[] proportions = {read, update, insert, scan, readModifyWrite};
+
+        int total = 0;
+        for (int i = 0; i < proportions.length; i++) {
+            total += proportions[i];
+            this.thresholds[i] = total;
+        }
+        assert total == PERCENT;
+
+        this.distribution = distribution;
+        this.maxScanLength = maxScanLength;
+    }
+
+    /**
+     * Get the default key distribution.
+     *
+     * @return Distribution name understood by {@link KeyChooser#of}.
+     */
+    String getDistribution() {
+        return this.distribution;
+    }
+
+    /**
+     * Get the maximum length of a scan. Scan lengths are uniform in
+     * {@code [1, max]}.
+     *
+     * @return Maximum number of records read by a scan.
+     */
+    int getMaxScanLength() {
+        return this.maxScanLength;
+    }
+
+    /**
+     * Get the share of inserts.
+     *
+     * @return Proportion of inserts between 0 and 1.
+     */
+    double getInsertProportion() {
+        final int idx = Operation.INSERT.ordinal();
+
+        return (double) (this.thresholds[idx] - this.thresholds[idx - 1]) / PERCENT;
+    }
+
+    /**
+     * Pick the next operation.
+     *
+     * @param roll Uniformly random number in {@code [0, 100)}.
+     * @return Operation.
+     */
+    Operation pick(final int roll) {
+        final Operation[] ops = Operation.values();
+
+        for (int i = 0; i < ops.length; i++) {
+            if (roll < this.thresholds[i]) {
+                return ops[i];
+            }
+        }
+
+        throw new IllegalArgumentException("Roll out of range: " + roll);
+    }
+}
@@ -0,0 +1,718 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.ycsb;
+
+import java.io.IOException;
+import java.io.OutputStreamWriter;
+import java.io.PrintWriter;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Locale;
+import java.util.Optional;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.LongAdder;
+
+import io.github.hse_project.hse.Hse;
+import io.github.hse_project.hse.HseException;
+import io.github.hse_project.hse.Kvdb;
+import io.github.hse_project.hse.KvdbTransaction;
+import io.github.hse_project.hse.Kvs;
+import io.github.hse_project.hse.KvsCursor;
+import io.github.hse_project.hse.TransactionRetryPolicy;
+import io.github.hse_project.hse.ycsb.Workload.Operation;
+
+/**
+ * YCSB-style load generator for HSE through the Java bindings.
+ *
+ * <p>
+ * A run has two phases. The load phase inserts {@code --records} records
+ * across all threads. The run phase then issues the operation mix of the
+ * workload until {@code --operations} operations were issued or
+ * {@code --duration} seconds passed, whichever comes first. Operations are:
+ * </p>
+ *
+ * <ul>
+ * <li>read: {@link Kvs#get(byte[], byte[], KvdbTransaction)} of a chosen key.</li>
+ * <li>update: {@link Kvs#put(byte[], byte[], KvdbTransaction)} of a chosen key.</li>
+ * <li>insert: put of the next key which was never inserted.</li>
+ * <li>scan: a new {@link KvsCursor} seeked to a chosen key, which reads up
+ *     to the scan length of the workload with {@link KvsCursor#read(KvsCursor.View)}.</li>
+ * <li>read_modify_write: a read followed by an update of the same key.</li>
+ * </ul>
+ *
+ * <p>
+ * With {@code --transactions}, every operation runs in its own transaction
+ * through {@link Kvdb#runInTransaction(Kvdb.TransactionFunction,
+ * TransactionRetryPolicy)}, and latencies include commits and retries.
+ * </p>
+ *
+ * <p>
+ * The output has a time series of the throughput and mean latency of every
+ * operation per {@code --interval}, and a summary of the latency percentiles
+ * of every operation per phase. As CSV, both tables are written one after the
+ * other, separated by an empty line, or to {@code PREFIX.timeseries.csv} and
+ * {@code PREFIX.summary.csv} with {@code --output PREFIX}. As JSON, they are
+ * written as a single document. Progress is printed to standard error.
+ * </p>
+ */
+public final class Ycsb {
+    private static final String KVS_NAME = "usertable";
+    private static final String USAGE = String.join(System.lineSeparator(),
+        "Usage: Ycsb [OPTION]...",
+        "",
+        "  --workload NAME        a, b, c, d, e, f, scan, or ingest (default: a)",
+        "  --records N            Records inserted by the load phase (default: 100000)",
+        "  --operations N         Operations of the run phase, 0 for no limit"
+            + " (default: 1000000)",
+        "  --duration SECONDS     Time limit of the run phase, 0 for none (default: 0)",
+        "  --threads N            Worker threads (default: 1)",
+        "  --distribution NAME    uniform, zipfian, or latest (default: per workload)",
+        "  --value-size N         Value size in bytes (default: 1000)",
+        "  --transactions         Run every operation in a transaction",
+        "  --interval MS          Time series interval in milliseconds (default: 1000)",
+        "  --format FORMAT        csv or json (default: csv)",
+        "  --output PREFIX        Write to files starting with PREFIX instead of stdout",
+        "  --home PATH            KVDB home to create and drop (default: temporary)",
+        "  --kvdb-param K=V       KVDB parameter, may be repeated",
+        "  --kvs-param K=V        KVS parameter, may be repeated",
+        "  --help                 Print this help");
+    private static final double[] PERCENTILES = {50, 90, 99, 99.9, 99.99};
+    private static final int PERCENT = 100;
+    private static final long DEFAULT_RECORDS = 100_000;
+    private static final long DEFAULT_OPERATIONS = 1_000_000;
+    private static final int DEFAULT_VALUE_SIZE = 1000;
+    private static final long DEFAULT_INTERVAL_MS = 1000;
+    private static final int OPS = Operation.values().length;
+
+    private Workload workload = Workload.A;
+    private long records = DEFAULT_RECORDS;
+    private long operations = DEFAULT_OPERATIONS;
+    private long durationSecs;
+    private int threads = 1;
+    private String distribution;
+    private int valueSize = DEFAULT_VALUE_SIZE;
+    private boolean transactions;
+    private long intervalMillis = DEFAULT_INTERVAL_MS;
+    private boolean json;
+    private String output;
+    private Path home;
+    private final List<String> kvdbParams = new ArrayList<>();
+    private final List<String> kvsParams = new ArrayList<>();
+
+    private Kvdb kvdb;
+    private Kvs kvs;
+    private KeyChooser chooser;
+    /** Key number of the next insert. */
+    private final AtomicLong nextInsert = new AtomicLong();
+    /** Number of keys, counting from 0, whose inserts have all completed. */
+    private final AtomicLong inserted = new AtomicLong();
+    private final List<Phase> phases = new ArrayList<>();
+    private final List<Sample> samples = new ArrayList<>();
+
+    private Ycsb() {
+    }
+
+    /** Statistics of a phase, shared by its workers. */
+    private static final class Phase {
+        private final String name;
+        /** Completed operations, for the time series. */
+        private final LongAdder[] counts = new LongAdder[OPS];
+        /** Total latency of completed operations, for the time series. */
+        private final LongAdder[] nanos = new LongAdder[OPS];
+        /** Operations which failed. */
+        private final LongAdder[] errors = new LongAdder[OPS];
+        /** Reads, scans, and read-modify-writes which found no record. */
+        private final LongAdder[] misses = new LongAdder[OPS];
+        private final TransactionRetryPolicy[] policies = new TransactionRetryPolicy[OPS];
+        /** Latencies merged from every worker once the phase is over. */
+        private final LatencyHistogram[] histograms = new LatencyHistogram[OPS];
+        private long elapsedNanos;
+
+        Phase(final String name) {
+            this.name = name;
+            for (int i = 0; i < OPS; i++) {
+                this.counts[i] = new LongAdder();
+                this.nanos[i] = new LongAdder();
+                this.errors[i] = new LongAdder();
+                this.misses[i] = new LongAdder();
+                // One policy per operation shows which operations conflict.
+                this.policies[i] = new TransactionRetryPolicy();
+                this.histograms[i] = new LatencyHistogram();
+            }
+        }
+    }
+
+    /** One interval of the time series. */
+    private static final class Sample {
+        private final String phase;
+        private final double time;
+        private final String operation;
+        private final long count;
+        private final double opsPerSec;
+        private final double meanUs;
+
+        Sample(final String phase, final double time, final String operation, final long count,
+                final double opsPerSec, final double meanUs) {
+            this.phase = phase;
+            this.time = time;
+            this.operation = operation;
+            this.count = count;
+            this.opsPerSec = opsPerSec;
+            this.meanUs = meanUs;
+        }
+    }
+
+    /** Operation body, which runs in a transaction if {@code txn} is not null. */
+    @FunctionalInterface
+    private interface Op {
+        /**
+         * Run the operation.
+         *
+         * @param txn Transaction to run in, or {@code null}.
+         * @return Whether the operation found the record it looked for.
+         */
+        boolean run(KvdbTransaction txn) throws HseException;
+    }
+
+    /** Work of one thread during a phase. */
+    @FunctionalInterface
+    private interface Worker {
+        void run(int thread, Phase phase, LatencyHistogram[] histograms);
+    }
+
+    private static double micros(final double nanos) {
+        return nanos / TimeUnit.MICROSECONDS.toNanos(1);
+    }
+
+    private static double seconds(final long nanos) {
+        return (double) nanos / TimeUnit.SECONDS.toNanos(1);
+    }
+
+    private static Path defaultBase() {
+        return Paths.get(Optional.ofNullable(System.getenv("MESON_BUILD_ROOT"))
+            .orElse(System.getProperty("java.io.tmpdir")));
+    }
+
+    private static String value(final String[] args, final int i) {
+        if (i >= args.length) {
+            throw new IllegalArgumentException(args[i - 1] + " requires a value");
+        }
+
+        return args[i];
+    }
+
+    private void parse(final String[] args) {
+        for (int i = 0; i < args.length; i++) {
+            final String arg = args[i];
+
+            switch (arg) {
+            case "--workload":
+                this.workload = Workload.valueOf(value(args, ++i).toUpperCase(Locale.ROOT));
+                break;
+            case "--records":
+                this.records = Long.parseLong(value(args, ++i));
+                break;
+            case "--operations":
+                this.operations = Long.parseLong(value(args, ++i));
+                break;
+            case "--duration":
+                this.durationSecs = Long.parseLong(value(args, ++i));
+                break;
+            case "--threads":
+                this.threads = Integer.parseInt(value(args, ++i));
+                break;
+            case "--distribution":
+                this.distribution = value(args, ++i);
+                break;
+            case "--value-size":
+                this.valueSize = Integer.parseInt(value(args, ++i));
+                break;
+            case "--transactions":
+                this.transactions = true;
+                break;
+            case "--interval":
+                this.intervalMillis = Long.parseLong(value(args, ++i));
+                break;
+            case "--format":
+                this.json = "json".equals(value(args, ++i));
+                if (!this.json && !"csv".equals(args[i])) {
+                    throw new IllegalArgumentException("Unknown format: " + args[i]);
+                }
+                break;
+            case "--output":
+                this.output = value(args, ++i);
+                break;
+            case "--home":
+                this.home = Paths.get(value(args, ++i));
+                break;
+            case "--kvdb-param":
+                this.kvdbParams.add(value(args, ++i));
+                break;
+            case "--kvs-param":
+                this.kvsParams.add(value(args, ++i));
+                break;
+            default:
+                throw new IllegalArgumentException("Unknown option: " + arg);
+            }
+        }
+
+        if (this.records < 1 || this.threads < 1 || this.valueSize < 0
+                || this.intervalMillis < 1 || this.operations < 0 || this.durationSecs < 0) {
+            throw new IllegalArgumentException("Numeric options are out of range");
+        }
+        if (this.operations == 0 && this.durationSecs == 0) {
+            throw new IllegalArgumentException("One of --operations and --duration is required");
+        }
+
+        // Leave room for inserts, as YCSB sizes its zipfian key space.
+        final double expectedInserts = this.workload.getInsertProportion()
+            * (this.operations > 0 ? this.operations : this.records);
+        this.chooser = KeyChooser.of(Optional.ofNullable(this.distribution)
+            .orElse(this.workload.getDistribution()), this.records + 2 * (long) expectedInserts);
+    }
+
+    /**
+     * Run an operation, and record its outcome.
+     */
+    private void execute(final Phase phase, final LatencyHistogram[] histograms,
+            final Operation operation, final Op op) {
+        final int idx = operation.ordinal();
+        final long start = System.nanoTime();
+
+        try {
+            final boolean found = this.transactions
+                ? this.kvdb.runInTransaction(op::run, phase.policies[idx])
+                : op.run(null);
+            if (!found) {
+                phase.misses[idx].increment();
+            }
+        } catch (final HseException e) {
+            phase.errors[idx].increment();
+        }
+
+        final long elapsed = System.nanoTime() - start;
+        histograms[idx].record(elapsed);
+        phase.counts[idx].increment();
+        phase.nanos[idx].add(elapsed);
+    }
+
+    /**
+     * Mark an insert as complete. Choosers only see a key once every key
+     * before it was inserted, so that reads do not race inserts.
+     */
+    private void acknowledge(final long keyNum) {
+        while (!this.inserted.compareAndSet(keyNum, keyNum + 1)) {
+            Thread.yield();
+        }
+    }
+
+    private void insert(final Phase phase, final LatencyHistogram[] histograms,
+            final byte[] value) {
+        final long keyNum = this.nextInsert.getAndIncrement();
+        final byte[] key = Keys.key(keyNum);
+
+        try {
+            execute(phase, histograms, Operation.INSERT, txn -> {
+                this.kvs.put(key, value, txn);
+                return true;
+            });
+        } finally {
+            acknowledge(keyNum);
+        }
+    }
+
+    private boolean scan(final byte[] key, final int length, final KvdbTransaction txn)
+            throws HseException {
+        final KvsCursor.View view = new KvsCursor.View();
+
+        try (KvsCursor cursor = this.kvs.cursor(txn)) {
+            final boolean found = cursor.seek(key).isPresent();
+
+            int read = 0;
+            while (read < length && cursor.read(view)) {
+                read++;
+            }
+
+            return found;
+        }
+    }
+
+    private void load(final int thread, final Phase phase, final LatencyHistogram[] histograms) {
+        final byte[] value = new byte[this.valueSize];
+        final long perThread = this.records / this.threads;
+        final long count = thread == this.threads - 1
+            ? this.records - perThread * (this.threads - 1)
+            : perThread;
+
+        ThreadLocalRandom.current().nextBytes(value);
+        for (long i = 0; i < count; i++) {
+            insert(phase, histograms, value);
+        }
+    }
+
+    private void transact(final Phase phase, final LatencyHistogram[] histograms,
+            final AtomicLong remaining, final long deadline) {
+        final ThreadLocalRandom random = ThreadLocalRandom.current();
+        final byte[] value = new byte[this.valueSize];
+        final byte[] valueBuf = new byte[this.valueSize];
+
+        random.nextBytes(value);
+        while (remaining.getAndDecrement() > 0 && System.nanoTime() - deadline < 0) {
+            final Operation operation = this.workload.pick(random.nextInt(PERCENT));
+
+            if (operation == Operation.INSERT) {
+                insert(phase, histograms, value);
+                continue;
+            }
+
+            final byte[] key = Keys.key(this.chooser.next(this.inserted.get()));
+            switch (operation) {
+            case READ:
+                execute(phase, histograms, operation,
+                    txn -> this.kvs.get(key, valueBuf, txn).isPresent());
+                break;
+            case UPDATE:
+                execute(phase, histograms, operation, txn -> {
+                    this.kvs.put(key, value, txn);
+                    return true;
+                });
+                break;
+            case SCAN: {
+                final int length = 1 + random.nextInt(this.workload.getMaxScanLength());
+                execute(phase, histograms, operation, txn -> scan(key, length, txn));
+                break;
+            }
+            case READ_MODIFY_WRITE:
+                execute(phase, histograms, operation, txn -> {
+                    final boolean found = this.kvs.get(key, valueBuf, txn).isPresent();
+                    this.kvs.put(key, value, txn);
+                    return found;
+                });
+                break;
+            default:
+                throw new IllegalStateException("Unexpected operation: " + operation);
+            }
+        }
+    }
+
+    /** Sample the counters of a phase into the time series. */
+    private final class Sampler implements Runnable {
+        private final Phase phase;
+        private final long start;
+        private final long[] lastCounts = new long[OPS];
+        private final long[] lastNanos = new long[OPS];
+        private long last;
+
+        Sampler(final Phase phase, final long start) {
+            this.phase = phase;
+            this.start = start;
+            this.last = start;
+        }
+
+        @Override
+        public synchronized void run() {
+            final long now = System.nanoTime();
+            final double interval = seconds(now - this.last);
+            final double time = seconds(now - this.start);
+            long totalCount = 0;
+            long totalNanos = 0;
+
+            if (interval <= 0) {
+                return;
+            }
+
+            for (final Operation operation : Operation.values()) {
+                final int idx = operation.ordinal();
+                final long count = this.phase.counts[idx].sum();
+                final long nanos = this.phase.nanos[idx].sum();
+                final long dc = count - this.lastCounts[idx];
+                final long dn = nanos - this.lastNanos[idx];
+
+                this.lastCounts[idx] = count;
+                this.lastNanos[idx] = nanos;
+                totalCount += dc;
+                totalNanos += dn;
+                if (dc > 0) {
+                    record(time, operation.label(), dc, dn, interval);
+                }
+            }
+            record(time, "total", totalCount, totalNanos, interval);
+            this.last = now;
+
+            System.err.printf(Locale.ROOT, "%s %.1fs: %.0f ops/s%n", this.phase.name, time,
+                totalCount / interval);
+        }
+
+        private void record(final double time, final String operation, final long count,
+                final long nanos, final double interval) {
+            final Sample sample = new Sample(this.phase.name, time, operation, count,
+                count / interval, count == 0 ? 0 : micros((double) nanos / count));
+
+            synchronized (Ycsb.this.samples) {
+                Ycsb.this.samples.add(sample);
+            }
+        }
+    }
+
+    private void runPhase(final String name, final Worker worker) throws InterruptedException {
+        final Phase phase = new Phase(name);
+        final LatencyHistogram[][] histograms = new LatencyHistogram[this.threads][OPS];
+        final Thread[] workers = new Thread[this.threads];
+        final ScheduledExecutorService timer = Executors.newSingleThreadScheduledExecutor(r -> {
+            final Thread t = new Thread(r, "ycsb-sampler");
+            t.setDaemon(true);
+            return t;
+        });
+        final long start = System.nanoTime();
+        final Sampler sampler = new Sampler(phase, start);
+
+        for (int i = 0; i < this.threads; i++) {
+            final int thread = i;
+
+            for (int j = 0; j < OPS; j++) {
+                histograms[i][j] = new LatencyHistogram();
+            }
+            workers[i] = new Thread(() -> worker.run(thread, phase, histograms[thread]),
+                "ycsb-" + name + "-" + i);
+        }
+
+        timer.scheduleAtFixedRate(sampler, this.intervalMillis, this.intervalMillis,
+            TimeUnit.MILLISECONDS);
+        for (final Thread t : workers) {
+            t.start();
+        }
+        try {
+            for (final Thread t : workers) {
+                t.join();
+            }
+        } finally {
+            timer.shutdownNow();
+            timer.awaitTermination(1, TimeUnit.MINUTES);
+        }
+        phase.elapsedNanos = System.nanoTime() - start;
+        sampler.run();
+
+        for (final LatencyHistogram[] h : histograms) {
+            for (int j = 0; j < OPS; j++) {
+                phase.histograms[j].add(h[j]);
+            }
+        }
+        this.phases.add(phase);
+    }
+
+    private void run() throws HseException, IOException, InterruptedException {
+        final Path kvdbHome = this.home != null
+            ? this.home
+            : Files.createTempDirectory(defaultBase(), "ycsb-");
+        final List<String> kvsOpenParams = new ArrayList<>(this.kvsParams);
+
+        if (this.transactions) {
+            kvsOpenParams.add("transactions.enabled=true");
+        }
+
+        Hse.init("rest.enabled=false");
+        try {
+            Kvdb.create(kvdbHome, this.kvdbParams.toArray(new String[0]));
+            try {
+                this.kvdb = Kvdb.open(kvdbHome);
+                try {
+                    this.kvdb.kvsCreate(KVS_NAME);
+                    this.kvs = this.kvdb.kvsOpen(KVS_NAME, kvsOpenParams.toArray(new String[0]));
+                    try {
+                        runPhases();
+                    } finally {
+                        this.kvs.close();
+                    }
+                } finally {
+                    this.kvdb.close();
+                }
+            } finally {
+                Kvdb.drop(kvdbHome);
+            }
+        } finally {
+            Hse.fini();
+            if (this.home == null) {
+                Files.deleteIfExists(kvdbHome);
+            }
+        }
+    }
+
+    private void runPhases() throws HseException, InterruptedException {
+        runPhase("load", this::load);
+        this.kvdb.sync();
+
+        final AtomicLong remaining = new AtomicLong(this.operations == 0
+            ? Long.MAX_VALUE
+            : this.operations);
+        // Far enough away to never pass, yet safe from overflow.
+        final long deadline = System.nanoTime() + (this.durationSecs == 0
+            ? Long.MAX_VALUE / 2
+            : TimeUnit.SECONDS.toNanos(this.durationSecs));
+        runPhase("run", (thread, phase, histograms) ->
+            transact(phase, histograms, remaining, deadline));
+    }
+
+    private void writeTimeSeriesCsv(final PrintWriter timeSeries) {
+        timeSeries.println("phase,time_s,operation,ops,ops_per_s,mean_us");
+        for (final Sample s : this.samples) {
+            timeSeries.printf(Locale.ROOT, "%s,%.3f,%s,%d,%.1f,%.2f%n", s.phase, s.time,
+                s.operation, s.count, s.opsPerSec, s.meanUs);
+        }
+        timeSeries.flush();
+    }
+
+    private void writeSummaryCsv(final PrintWriter summary) {
+        final StringBuilder header = new StringBuilder(
+            "phase,operation,ops,errors,misses,ops_per_s,mean_us,min_us");
+        for (final double p : PERCENTILES) {
+            header.append(String.format(Locale.ROOT, ",p%s_us", percentileLabel(p)));
+        }
+        summary.println(header.append(",max_us,commits,conflicts,retries,exhausted"));
+        for (final Phase phase : this.phases) {
+            for (final Operation operation : Operation.values()) {
+                final int idx = operation.ordinal();
+                final LatencyHistogram h = phase.histograms[idx];
+                final TransactionRetryPolicy policy = phase.policies[idx];
+
+                if (h.getCount() == 0) {
+                    continue;
+                }
+
+                summary.printf(Locale.ROOT, "%s,%s,%d,%d,%d,%.1f,%.2f,%.2f", phase.name,
+                    operation.label(), h.getCount(), phase.errors[idx].sum(),
+                    phase.misses[idx].sum(), h.getCount() / seconds(phase.elapsedNanos),
+                    micros(h.getMean()), micros(h.getMin()));
+                for (final double p : PERCENTILES) {
+                    summary.printf(Locale.ROOT, ",%.2f", micros(h.getValueAtPercentile(p)));
+                }
+                summary.printf(Locale.ROOT, ",%.2f,%d,%d,%d,%d%n", micros(h.getMax()),
+                    policy.getCommits(), policy.getConflicts(), policy.getRetries(),
+                    policy.getExhausted());
+            }
+        }
+        summary.flush();
+    }
+
+    private void writeJson(final PrintWriter out) {
+        out.printf(Locale.ROOT, "{%n  \"workload\": \"%s\",%n  \"records\": %d,%n"
+            + "  \"threads\": %d,%n  \"value_size\": %d,%n  \"transactions\": %b,%n"
+            + "  \"timeseries\": [", this.workload.name().toLowerCase(Locale.ROOT),
+            this.records, this.threads, this.valueSize, this.transactions);
+        String sep = "";
+        for (final Sample s : this.samples) {
+            out.printf(Locale.ROOT, "%s%n    {\"phase\": \"%s\", \"time_s\": %.3f, "
+                + "\"operation\": \"%s\", \"ops\": %d, \"ops_per_s\": %.1f, "
+                + "\"mean_us\": %.2f}", sep, s.phase, s.time, s.operation, s.count,
+                s.opsPerSec, s.meanUs);
+            sep = ",";
+        }
+        out.printf("%n  ],%n  \"summary\": [");
+        sep = "";
+        for (final Phase phase : this.phases) {
+            for (final Operation operation : Operation.values()) {
+                final int idx = operation.ordinal();
+                final LatencyHistogram h = phase.histograms[idx];
+                final TransactionRetryPolicy policy = phase.policies[idx];
+
+                if (h.getCount() == 0) {
+                    continue;
+                }
+
+                out.printf(Locale.ROOT, "%s%n    {\"phase\": \"%s\", \"operation\": \"%s\", "
+                    + "\"ops\": %d, \"errors\": %d, \"misses\": %d, \"ops_per_s\": %.1f, "
+                    + "\"mean_us\": %.2f, \"min_us\": %.2f, \"max_us\": %.2f, "
+                    + "\"percentiles_us\": {", sep, phase.name, operation.label(),
+                    h.getCount(), phase.errors[idx].sum(), phase.misses[idx].sum(),
+                    h.getCount() / seconds(phase.elapsedNanos), micros(h.getMean()),
+                    micros(h.getMin()), micros(h.getMax()));
+                String psep = "";
+                for (final double p : PERCENTILES) {
+                    out.printf(Locale.ROOT, "%s\"%s\": %.2f", psep, percentileLabel(p),
+                        micros(h.getValueAtPercentile(p)));
+                    psep = ", ";
+                }
+                out.printf(Locale.ROOT, "}, \"transactions\": {\"commits\": %d, "
+                    + "\"conflicts\": %d, \"retries\": %d, \"exhausted\": %d}}",
+                    policy.getCommits(), policy.getConflicts(), policy.getRetries(),
+                    policy.getExhausted());
+                sep = ",";
+            }
+        }
+        out.printf("%n  ]%n}%n");
+        out.flush();
+    }
+
+    private static String percentileLabel(final double percentile) {
+        return percentile == Math.rint(percentile)
+            ? Long.toString((long) percentile)
+            : Double.toString(percentile);
+    }
+
+    private static PrintWriter writer(final Path path) throws IOException {
+        return new PrintWriter(Files.newBufferedWriter(path, StandardCharsets.UTF_8));
+    }
+
+    private void report() throws IOException {
+        if (this.output == null) {
+            final PrintWriter out = new PrintWriter(
+                new OutputStreamWriter(System.out, StandardCharsets.UTF_8));
+
+            if (this.json) {
+                writeJson(out);
+            } else {
+                writeTimeSeriesCsv(out);
+                out.println();
+                writeSummaryCsv(out);
+            }
+        } else if (this.json) {
+            try (PrintWriter out = writer(Paths.get(this.output + ".json"))) {
+                writeJson(out);
+            }
+        } else {
+            try (PrintWriter timeSeries = writer(Paths.get(this.output + ".timeseries.csv"));
+                    PrintWriter summary = writer(Paths.get(this.output + ".summary.csv"))) {
+                writeTimeSeriesCsv(timeSeries);
+                writeSummaryCsv(summary);
+            }
+        }
+    }
+
+    /**
+     * Entry point.
+     *
+     * @param args Options, see {@code --help}.
+     * @throws Exception Load generation failed.
+     */
+    public static void main(final String[] args) throws Exception {
+        final Ycsb ycsb = new Ycsb();
+
+        for (final String arg : args) {
+            if ("--help".equals(arg)) {
+                System.out.println(USAGE);
+                return;
+            }
+        }
+
+        try {
+            ycsb.parse(args);
+        } catch (final IllegalArgumentException e) {
+            System.err.println(e.getMessage());
+            System.err.println(USAGE);
+            System.exit(1);
+        }
+
+        ycsb.run();
+        ycsb.report();
+    }
+}
@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse.jmh;
+
+import java.lang.foreign.MemorySegment;
+import java.nio.ByteBuffer;
+import java.util.Optional;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import io.github.hse_project.hse.ForeignKvs;
+import io.github.hse_project.hse.HseException;
+
+/**
+ * Point operations through JNI against the same operations through
+ * {@link ForeignKvs}.
+ *
+ * <p>
+ * The JNI side uses the {@code byte[]} and direct {@link ByteBuffer}
+ * overloads of {@link io.github.hse_project.hse.Kvs}. The FFM side passes
+ * {@link MemorySegment}s over the very same direct buffers, so both read and
+ * write identical native memory and differ only in how HSE is called.
+ * </p>
+ *
+ * <p>
+ * Only built on Java 22 and later, with {@code -P meson,jmh,jmh22}.
+ * </p>
+ */
+@BenchmarkMode({Mode.Throughput, Mode.SampleTime})
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+@State(Scope.Thread)
+public class ForeignBenchmark {
+    /** Index of the next key. */
+    private int next;
+    /** Keys as segments over {@link KvsState#keyBuffers}. */
+    private MemorySegment[] keySegments;
+    /** Value as a segment over {@link KvsState#valueBuffer}. */
+    private MemorySegment valueSegment;
+    /** Destination of gets into a {@code byte[]}. */
+    private byte[] valueBuf;
+    /** Destination of gets into a direct {@link ByteBuffer}. */
+    private ByteBuffer valueBuffer;
+    /** Destination of gets into a segment, over {@link #valueBuffer}. */
+    private MemorySegment valueBufSegment;
+
+    @Setup(Level.Trial)
+    public void setup(final KvsState state) {
+        this.keySegments = new MemorySegment[state.records];
+        for (int i = 0; i < state.records; i++) {
+            this.keySegments[i] = MemorySegment.ofBuffer(state.keyBuffers[i]);
+        }
+        this.valueSegment = MemorySegment.ofBuffer(state.valueBuffer);
+        this.valueBuf = new byte[state.valueSize];
+        this.valueBuffer = ByteBuffer.allocateDirect(state.valueSize);
+        this.valueBufSegment = MemorySegment.ofBuffer(this.valueBuffer);
+    }
+
+    private int next(final KvsState state) {
+        final int i = this.next;
+
+        this.next = i + 1 == state.records ? 0 : i + 1;
+
+        return i;
+    }
+
+    private static ByteBuffer rewind(final ByteBuffer buf) {
+        buf.rewind();
+
+        return buf;
+    }
+
+    @Benchmark
+    public Optional<Integer> getJniBytes(final KvsState state) throws HseException {
+        return state.kvs.get(state.keyBytes[next(state)], this.valueBuf);
+    }
+
+    @Benchmark
+    public Optional<Integer> getJniBuffer(final KvsState state) throws HseException {
+        return state.kvs.get(rewind(state.keyBuffers[next(state)]), rewind(this.valueBuffer));
+    }
+
+    @Benchmark
+    public Optional<Integer> getForeign(final KvsState state) throws HseException {
+        return ForeignKvs.get(state.kvs, this.keySegments[next(state)], this.valueBufSegment);
+    }
+
+    @Benchmark
+    public void putJniBytes(final KvsState state) throws HseException {
+        state.kvs.put(state.keyBytes[next(state)], state.valueBytes);
+    }
+
+    @Benchmark
+    public void putJniBuffer(final KvsState state) throws HseException {
+        state.kvs.put(rewind(state.keyBuffers[next(state)]), rewind(state.valueBuffer));
+    }
+
+    @Benchmark
+    public void putForeign(final KvsState state) throws HseException {
+        ForeignKvs.put(state.kvs, this.keySegments[next(state)], this.valueSegment);
+    }
+}
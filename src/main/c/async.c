@@ -0,0 +1,532 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#include <assert.h>
+#include <jni.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <hse/hse.h>
+
+#include "async.h"
+#include "hsejni.h"
+
+#define LOCAL_FRAME_CAPACITY 8
+
+struct async_queue {
+    struct async_op *head;
+    struct async_op *tail;
+};
+
+/* Worker threads are attached to the JVM once, when they start, so completing
+ * a future never pays for an attach.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    /* Signaled whenever a worker is done with the handles of an operation. */
+    pthread_cond_t idle;
+    JavaVM *vm;
+    pthread_t *workers;
+    /* Operation each worker is running, so that async_drain() can wait for it. */
+    struct async_op **running;
+    unsigned int workers_len;
+    unsigned int threads;
+    bool stopping;
+    struct async_queue prio;
+    struct async_queue normal;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .idle = PTHREAD_COND_INITIALIZER,
+};
+
+static void
+queue_push(struct async_queue *queue, struct async_op *op)
+{
+    op->next = NULL;
+    if (queue->tail)
+        queue->tail->next = op;
+    else
+        queue->head = op;
+    queue->tail = op;
+}
+
+static struct async_op *
+queue_pop(struct async_queue *queue)
+{
+    struct async_op *op = queue->head;
+
+    if (!op)
+        return NULL;
+
+    queue->head = op->next;
+    if (!queue->head)
+        queue->tail = NULL;
+
+    return op;
+}
+
+/* Whether an operation uses a handle. NULL matches every operation. */
+static bool
+async_op_uses(const struct async_op *op, const void *handle)
+{
+    if (!handle || (const void *)op->txn == handle)
+        return true;
+
+    if (op->type == ASYNC_OP_READ_BATCH)
+        return (const void *)op->cursor == handle;
+
+    return (const void *)op->kvs == handle;
+}
+
+/* Moves every operation which uses a handle from one queue to the tail of
+ * another, keeping their order.
+ */
+static void
+queue_take(struct async_queue *queue, const void *handle, struct async_queue *taken)
+{
+    struct async_op *op;
+    struct async_queue kept = { 0 };
+
+    while ((op = queue_pop(queue)))
+        queue_push(async_op_uses(op, handle) ? taken : &kept, op);
+
+    *queue = kept;
+}
+
+/* Must be called with the pool lock held. */
+static bool
+async_running(const void *handle)
+{
+    for (unsigned int i = 0; i < pool.workers_len; i++) {
+        if (pool.running[i] && async_op_uses(pool.running[i], handle))
+            return true;
+    }
+
+    return false;
+}
+
+/* Pops the first operation which may run now. HSE allows only one thread at a
+ * time to operate on a transaction, so operations whose transaction another
+ * worker is using stay queued. Must be called with the pool lock held.
+ */
+static struct async_op *
+queue_pop_runnable(struct async_queue *queue)
+{
+    struct async_op *prev = NULL;
+
+    for (struct async_op *op = queue->head; op; prev = op, op = op->next) {
+        if (op->txn && async_running(op->txn))
+            continue;
+
+        if (prev)
+            prev->next = op->next;
+        else
+            queue->head = op->next;
+        if (queue->tail == op)
+            queue->tail = prev;
+
+        return op;
+    }
+
+    return NULL;
+}
+
+/* Blocks until an operation may run, and records it as the one the worker is
+ * running. Returns NULL once the pool is stopping and both queues have been
+ * drained.
+ */
+static struct async_op *
+async_dequeue(unsigned int worker)
+{
+    struct async_op *op;
+
+    pthread_mutex_lock(&pool.lock);
+    while (true) {
+        op = queue_pop_runnable(&pool.prio);
+        if (!op)
+            op = queue_pop_runnable(&pool.normal);
+        if (op || (pool.stopping && !pool.prio.head && !pool.normal.head))
+            break;
+
+        pthread_cond_wait(&pool.cond, &pool.lock);
+    }
+    pool.running[worker] = op;
+    pthread_mutex_unlock(&pool.lock);
+
+    return op;
+}
+
+static jobject
+async_op_run(JNIEnv *env, struct async_op *op)
+{
+    hse_err_t err;
+    jobject value;
+    jlong packed;
+
+    switch (op->type) {
+    case ASYNC_OP_DELETE:
+        err = hse_kvs_delete(op->kvs, op->flags, op->txn, op->key, op->key_len);
+        if (err)
+            throw_new_hse_exception(env, err);
+        return NULL;
+    case ASYNC_OP_GET:
+        value = get_value_array(env, op->kvs, op->flags, op->txn, op->key, op->key_len);
+        if ((*env)->ExceptionCheck(env))
+            return NULL;
+
+        return (*env)->CallStaticObjectMethod(
+            env, globals.java.util.Optional.class, globals.java.util.Optional.ofNullable, value);
+    case ASYNC_OP_PUT:
+        err = hse_kvs_put(
+            op->kvs, op->flags, op->txn, op->key, op->key_len, op->value, op->value_len);
+        if (err)
+            throw_new_hse_exception(env, err);
+        return NULL;
+    case ASYNC_OP_READ_BATCH:
+        packed = read_batch(env, op->cursor, op->buf, op->buf_sz, op->max_records, op->flags);
+        if ((*env)->ExceptionCheck(env))
+            return NULL;
+
+        return (*env)->CallStaticObjectMethod(
+            env, globals.java.lang.Long.class, globals.java.lang.Long.valueOf, packed);
+    }
+
+    abort();
+}
+
+static void
+async_op_complete(JNIEnv *env, struct async_op *op, struct async_op **running)
+{
+    jobject result;
+    jthrowable exception;
+
+    result = async_op_run(env, op);
+
+    /* The handles are not touched past this point. Dependent stages of the
+     * future may close them, which must not wait on this operation.
+     */
+    if (running) {
+        pthread_mutex_lock(&pool.lock);
+        *running = NULL;
+        pthread_cond_broadcast(&pool.idle);
+        /* Queued operations on the transaction may have been passed over. */
+        if (op->txn)
+            pthread_cond_broadcast(&pool.cond);
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    exception = (*env)->ExceptionOccurred(env);
+    if (exception) {
+        (*env)->ExceptionClear(env);
+        (*env)->CallBooleanMethod(
+            env, op->future, globals.java.util.concurrent.CompletableFuture.completeExceptionally,
+            exception);
+    } else {
+        (*env)->CallBooleanMethod(
+            env, op->future, globals.java.util.concurrent.CompletableFuture.complete, result);
+    }
+
+    /* Dependent stages capture their own exceptions, so this can only be
+     * something like an OutOfMemoryError, and there is nobody to report it to.
+     */
+    if ((*env)->ExceptionCheck(env)) {
+        (*env)->ExceptionDescribe(env);
+        (*env)->ExceptionClear(env);
+    }
+
+    if (exception)
+        (*env)->DeleteLocalRef(env, exception);
+    if (result)
+        (*env)->DeleteLocalRef(env, result);
+}
+
+/* Completes an operation on the calling thread, and frees it. running is the
+ * worker's slot in pool.running, or NULL if the caller is not a worker.
+ */
+static void
+async_op_finish(JNIEnv *env, struct async_op *op, struct async_op **running)
+{
+    bool pushed;
+
+    /* Operations create a handful of local references, which would otherwise
+     * accumulate for the lifetime of the thread. The future must be completed
+     * regardless.
+     */
+    pushed = (*env)->PushLocalFrame(env, LOCAL_FRAME_CAPACITY) == 0;
+    if (!pushed)
+        (*env)->ExceptionClear(env);
+
+    async_op_complete(env, op, running);
+
+    if (pushed)
+        (*env)->PopLocalFrame(env, NULL);
+
+    async_op_free(env, op);
+}
+
+/* Completes an operation which will never run exceptionally, and frees it. */
+static void
+async_op_fail(JNIEnv *env, struct async_op *op, const char *message)
+{
+    jthrowable exception;
+
+    (*env)->ThrowNew(env, globals.java.lang.IllegalStateException.class, message);
+    exception = (*env)->ExceptionOccurred(env);
+    (*env)->ExceptionClear(env);
+
+    if (exception)
+        (*env)->CallBooleanMethod(
+            env, op->future, globals.java.util.concurrent.CompletableFuture.completeExceptionally,
+            exception);
+
+    /* As in async_op_complete(), there is nobody to report a failure to. */
+    if ((*env)->ExceptionCheck(env)) {
+        (*env)->ExceptionDescribe(env);
+        (*env)->ExceptionClear(env);
+    }
+
+    if (exception)
+        (*env)->DeleteLocalRef(env, exception);
+
+    async_op_free(env, op);
+}
+
+static void *
+async_worker(void *arg)
+{
+    JNIEnv *env;
+    char name[16];
+    struct async_op *op;
+    JavaVMAttachArgs args;
+    const unsigned int worker = (unsigned int)(uintptr_t)arg;
+
+    snprintf(name, sizeof(name), "hse-async-%u", worker);
+
+    args.version = HSE_JNI_VERSION;
+    args.name = name;
+    args.group = NULL;
+
+    /* Daemon threads do not keep the JVM alive if the application never calls
+     * Hse.fini().
+     */
+    if ((*pool.vm)->AttachCurrentThreadAsDaemon(pool.vm, (void **)&env, &args) != JNI_OK)
+        return NULL;
+
+    while ((op = async_dequeue(worker)))
+        async_op_finish(env, op, &pool.running[worker]);
+
+    (*pool.vm)->DetachCurrentThread(pool.vm);
+
+    return NULL;
+}
+
+/* Must be called with the pool lock held. */
+static bool
+async_start(JNIEnv *env)
+{
+    long cpus;
+    unsigned int threads;
+
+    if (pool.workers_len > 0)
+        return true;
+
+    if (!pool.vm && (*env)->GetJavaVM(env, &pool.vm) != JNI_OK)
+        return false;
+
+    threads = pool.threads;
+    if (threads == 0) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned int)cpus : 1;
+    }
+
+    pool.workers = malloc(threads * sizeof(*pool.workers));
+    pool.running = calloc(threads, sizeof(*pool.running));
+    if (!pool.workers || !pool.running) {
+        free(pool.workers);
+        free(pool.running);
+        pool.workers = NULL;
+        pool.running = NULL;
+        return false;
+    }
+
+    pool.stopping = false;
+    for (unsigned int i = 0; i < threads; i++) {
+        if (pthread_create(&pool.workers[i], NULL, async_worker, (void *)(uintptr_t)i) != 0)
+            break;
+        pool.workers_len++;
+    }
+
+    /* A partial pool still makes progress. */
+    if (pool.workers_len == 0) {
+        free(pool.workers);
+        free(pool.running);
+        pool.workers = NULL;
+        pool.running = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+struct async_op *
+async_op_alloc(JNIEnv *env, enum async_op_type type, size_t data_sz)
+{
+    jobject future;
+    struct async_op *op;
+
+    op = malloc(sizeof(*op) + data_sz);
+    if (!op) {
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for asynchronous operation");
+        return NULL;
+    }
+
+    future = (*env)->NewObject(
+        env, globals.java.util.concurrent.CompletableFuture.class,
+        globals.java.util.concurrent.CompletableFuture.init);
+    if (!future) {
+        free(op);
+        return NULL;
+    }
+
+    op->type = type;
+    op->future = (*env)->NewGlobalRef(env, future);
+    (*env)->DeleteLocalRef(env, future);
+    if (!op->future) {
+        free(op);
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for asynchronous operation");
+        return NULL;
+    }
+
+    return op;
+}
+
+void
+async_op_free(JNIEnv *env, struct async_op *op)
+{
+    if (!op)
+        return;
+
+    (*env)->DeleteGlobalRef(env, op->future);
+    free(op);
+}
+
+jobject
+async_submit(JNIEnv *env, struct async_op *op, bool prio)
+{
+    jobject future;
+
+    assert(op);
+
+    /* Once queued, the operation may be completed and freed at any moment. */
+    future = (*env)->NewLocalRef(env, op->future);
+    if (!future) {
+        async_op_free(env, op);
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for future reference");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    /* async_fini() has already let the workers go, so nothing would run the
+     * operation, and HSE is about to be shut down underneath it.
+     */
+    if (pool.stopping) {
+        pthread_mutex_unlock(&pool.lock);
+        async_op_fail(env, op, "HSE is being finalized");
+        return future;
+    }
+
+    if (!async_start(env)) {
+        pthread_mutex_unlock(&pool.lock);
+        (*env)->DeleteLocalRef(env, future);
+        async_op_free(env, op);
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to start asynchronous worker threads");
+        return NULL;
+    }
+
+    queue_push(prio ? &pool.prio : &pool.normal, op);
+    pthread_cond_signal(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+
+    return future;
+}
+
+void
+async_set_threads(unsigned int threads)
+{
+    pthread_mutex_lock(&pool.lock);
+    pool.threads = threads;
+    pthread_mutex_unlock(&pool.lock);
+}
+
+void
+async_drain(JNIEnv *env, const void *handle)
+{
+    struct async_op *op;
+    struct async_queue taken = { 0 };
+
+    pthread_mutex_lock(&pool.lock);
+    queue_take(&pool.prio, handle, &taken);
+    queue_take(&pool.normal, handle, &taken);
+    while (async_running(handle))
+        pthread_cond_wait(&pool.idle, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+
+    /* Running them here rather than waiting for a worker cannot deadlock when
+     * the caller is a dependent stage on a worker thread.
+     */
+    while ((op = queue_pop(&taken)))
+        async_op_finish(env, op, NULL);
+}
+
+void
+async_fini(JNIEnv *env)
+{
+    pthread_t *workers;
+    struct async_op *op;
+    unsigned int workers_len;
+    struct async_queue leftover = { 0 };
+
+    pthread_mutex_lock(&pool.lock);
+    workers = pool.workers;
+    workers_len = pool.workers_len;
+    pool.stopping = true;
+    pthread_cond_broadcast(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (unsigned int i = 0; i < workers_len; i++)
+        pthread_join(workers[i], NULL);
+
+    /* Workers only exit once the queues are empty, but not every worker may
+     * have managed to attach to the JVM. Submissions are refused while
+     * stopping, so nothing else can be queued here.
+     */
+    pthread_mutex_lock(&pool.lock);
+    queue_take(&pool.prio, NULL, &leftover);
+    queue_take(&pool.normal, NULL, &leftover);
+    free(pool.workers);
+    free(pool.running);
+    pool.workers = NULL;
+    pool.running = NULL;
+    pool.workers_len = 0;
+    pool.stopping = false;
+    pthread_mutex_unlock(&pool.lock);
+
+    while ((op = queue_pop(&leftover)))
+        async_op_fail(env, op, "HSE was finalized before the operation ran");
+}
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#ifndef HSE_JAVA_ASYNC_H
+#define HSE_JAVA_ASYNC_H
+
+#include <jni.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <hse/types.h>
+
+enum async_op_type {
+    ASYNC_OP_DELETE,
+    ASYNC_OP_GET,
+    ASYNC_OP_PUT,
+    ASYNC_OP_READ_BATCH,
+};
+
+/* An operation which is run by a worker thread on behalf of a Java thread.
+ * Everything the operation needs is owned by it, since the submitting thread
+ * will have returned from native code by the time the operation runs.
+ */
+struct async_op {
+    struct async_op *next;
+    enum async_op_type type;
+    /* Global reference to the CompletableFuture to complete. */
+    jobject future;
+    unsigned int flags;
+    struct hse_kvdb_txn *txn;
+    union {
+        struct hse_kvs *kvs;
+        struct cursor *cursor;
+    };
+    union {
+        struct {
+            /* Point into data, or are NULL for null Java arrays. */
+            const void *key;
+            size_t key_len;
+            const void *value;
+            size_t value_len;
+        };
+        struct {
+            /* Address of a direct buffer which the caller keeps alive. */
+            void *buf;
+            size_t buf_sz;
+            jint max_records;
+        };
+    };
+    /* Key, followed by value. */
+    char data[];
+};
+
+/* Allocates an operation with data_sz bytes of data, along with the future it
+ * will complete. Returns NULL with a pending exception on failure.
+ */
+struct async_op *
+async_op_alloc(JNIEnv *env, enum async_op_type type, size_t data_sz);
+
+/* Frees an operation which was never submitted. */
+void
+async_op_free(JNIEnv *env, struct async_op *op);
+
+/* Queues an operation onto the worker pool, starting the pool if it is not
+ * running. Operations on the priority lane are run before any others. Returns
+ * a local reference to the operation's future. On failure, the operation is
+ * freed, and NULL is returned with a pending exception.
+ */
+jobject
+async_submit(JNIEnv *env, struct async_op *op, bool prio);
+
+/* Sets the number of worker threads used the next time the pool starts. */
+void
+async_set_threads(unsigned int threads);
+
+/* Runs or waits for every queued or running operation which uses a KVS,
+ * cursor, or transaction handle, so that the handle may be closed or reused.
+ * Queued operations are run on the calling thread. A NULL handle matches every
+ * operation.
+ */
+void
+async_drain(JNIEnv *env, const void *handle);
+
+/* Runs every queued operation, then stops the worker threads. Operations
+ * submitted meanwhile, or which no worker could run, are completed
+ * exceptionally with an IllegalStateException.
+ */
+void
+async_fini(JNIEnv *env);
+
+#endif
@@ -0,0 +1,396 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+/* Drives HSE directly with the same workloads as BindingOverhead.java, so that
+ * the cost the bindings add to an operation can be told apart from the cost of
+ * HSE itself.
+ *
+ * Usage: hsejni-bench KVDB_HOME
+ *
+ * Every workload starts from a fresh KVS: empty for puts, and loaded with the
+ * same records for everything else. Puts get a new KVS for every run, while
+ * the other operations, which do not change the KVS, run repeatedly on the
+ * same one. Each workload is run WARMUP_RUNS times untimed, then RUNS times
+ * timed.
+ *
+ * Prints one CSV row per operation and key/value size, with the mean and
+ * sample standard deviation across the timed runs:
+ * op,key_size,value_size,ops,runs,ns_per_op,stddev_ns
+ *
+ * The get_malloc and get_scratch rows compare the buffer strategies of
+ * allocating gets before and after the per-thread scratch buffer.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hse/hse.h>
+#include <hse/limits.h>
+
+#define MAX_RECORDS   65536
+#define DATASET_BYTES (64 << 20)
+#define PASSES        4
+#define WARMUP_RUNS   2
+#define RUNS          5
+#define KVS_NAME      "bench"
+
+/* Initial size of the per-thread scratch buffer in hsejni.c. */
+#define SCRATCH_SZ_MIN (4 * 1024)
+
+static const size_t key_sizes[] = { 16, 64, 256 };
+static const size_t value_sizes[] = { 16, 1024, 65536 };
+
+/* What a workload needs from its KVS. */
+enum kind {
+    KIND_PUT,    /* An empty KVS per run. */
+    KIND_GET,    /* A loaded KVS. */
+    KIND_CURSOR, /* A loaded KVS, and a cursor at its first key at every run. */
+};
+
+struct workload {
+    struct hse_kvdb *kvdb;
+    struct hse_kvs *kvs;
+    struct hse_kvs_cursor *cursor;
+    size_t key_sz;
+    size_t value_sz;
+    size_t records;
+    size_t ops;
+    char *keys;
+    char *value;
+    char *key_buf;
+    char *value_buf;
+    char *scratch;
+    size_t scratch_sz;
+};
+
+typedef hse_err_t (*op_fn)(struct workload *w, size_t i);
+
+static void
+check(const hse_err_t err, const char *const what)
+{
+    char buf[256];
+
+    if (!err)
+        return;
+
+    hse_strerror(err, buf, sizeof(buf));
+    fprintf(stderr, "%s: %s\n", what, buf);
+
+    exit(EXIT_FAILURE);
+}
+
+static void *
+xmalloc(const size_t sz)
+{
+    void *const mem = malloc(sz);
+
+    if (!mem) {
+        fprintf(stderr, "Failed to allocate %zu bytes\n", sz);
+        exit(EXIT_FAILURE);
+    }
+
+    return mem;
+}
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static const char *
+key_at(const struct workload *const w, const size_t i)
+{
+    return w->keys + (i % w->records) * w->key_sz;
+}
+
+static hse_err_t
+op_put(struct workload *const w, const size_t i)
+{
+    return hse_kvs_put(w->kvs, 0, NULL, key_at(w, i), w->key_sz, w->value, w->value_sz);
+}
+
+static hse_err_t
+op_get(struct workload *const w, const size_t i)
+{
+    bool found;
+    size_t value_len;
+
+    return hse_kvs_get(
+        w->kvs, 0, NULL, key_at(w, i), w->key_sz, &found, w->value_buf, w->value_sz,
+        &value_len);
+}
+
+/* How allocating gets in the bindings used to size their buffer: a
+ * HSE_KVS_VALUE_LEN_MAX allocation per lookup.
+ */
+static hse_err_t
+op_get_malloc(struct workload *const w, const size_t i)
+{
+    bool found;
+    hse_err_t err;
+    size_t value_len;
+    void *buf;
+
+    buf = xmalloc(HSE_KVS_VALUE_LEN_MAX);
+
+    err = hse_kvs_get(
+        w->kvs, 0, NULL, key_at(w, i), w->key_sz, &found, buf, HSE_KVS_VALUE_LEN_MAX, &value_len);
+
+    free(buf);
+
+    return err;
+}
+
+/* How allocating gets in the bindings size their buffer now: a buffer reused
+ * across lookups, grown to the reported length when a value does not fit.
+ */
+static hse_err_t
+op_get_scratch(struct workload *const w, const size_t i)
+{
+    bool found;
+    hse_err_t err;
+    size_t value_len;
+
+    while (true) {
+        err = hse_kvs_get(
+            w->kvs, 0, NULL, key_at(w, i), w->key_sz, &found, w->scratch, w->scratch_sz,
+            &value_len);
+        if (err || !found || value_len <= w->scratch_sz)
+            return err;
+
+        free(w->scratch);
+        w->scratch_sz = value_len;
+        w->scratch = xmalloc(w->scratch_sz);
+    }
+}
+
+/* Like the Java driver, wrap around to the first key at the end of the cursor. */
+static hse_err_t
+rewind_cursor(struct workload *const w)
+{
+    const void *found;
+    size_t found_len;
+
+    return hse_kvs_cursor_seek(w->cursor, 0, w->keys, w->key_sz, &found, &found_len);
+}
+
+static hse_err_t
+op_cursor_read(struct workload *const w, const size_t i)
+{
+    hse_err_t err;
+    const void *key, *value;
+    size_t key_len, value_len;
+    bool eof;
+
+    (void)i;
+
+    err = hse_kvs_cursor_read(w->cursor, 0, &key, &key_len, &value, &value_len, &eof);
+    if (!err && eof)
+        err = rewind_cursor(w);
+
+    return err;
+}
+
+static hse_err_t
+op_cursor_read_copy(struct workload *const w, const size_t i)
+{
+    hse_err_t err;
+    size_t key_len, value_len;
+    bool eof;
+
+    (void)i;
+
+    err = hse_kvs_cursor_read_copy(
+        w->cursor, 0, w->key_buf, w->key_sz, &key_len, w->value_buf, w->value_sz, &value_len,
+        &eof);
+    if (!err && eof)
+        err = rewind_cursor(w);
+
+    return err;
+}
+
+static hse_err_t
+op_seek(struct workload *const w, const size_t i)
+{
+    const void *found;
+    size_t found_len;
+
+    return hse_kvs_cursor_seek(w->cursor, 0, key_at(w, i), w->key_sz, &found, &found_len);
+}
+
+static void
+kvs_setup(struct workload *const w, const enum kind kind)
+{
+    check(hse_kvdb_kvs_create(w->kvdb, KVS_NAME, 0, NULL), "hse_kvdb_kvs_create");
+    check(hse_kvdb_kvs_open(w->kvdb, KVS_NAME, 0, NULL, &w->kvs), "hse_kvdb_kvs_open");
+
+    if (kind == KIND_PUT)
+        return;
+
+    for (size_t i = 0; i < w->records; i++)
+        check(op_put(w, i), "hse_kvs_put");
+    check(hse_kvdb_sync(w->kvdb, 0), "hse_kvdb_sync");
+
+    if (kind == KIND_CURSOR)
+        check(hse_kvs_cursor_create(w->kvs, 0, NULL, NULL, 0, &w->cursor), "hse_kvs_cursor_create");
+}
+
+static void
+kvs_teardown(struct workload *const w)
+{
+    if (w->cursor) {
+        check(hse_kvs_cursor_destroy(w->cursor), "hse_kvs_cursor_destroy");
+        w->cursor = NULL;
+    }
+
+    check(hse_kvdb_kvs_close(w->kvs), "hse_kvdb_kvs_close");
+    w->kvs = NULL;
+    check(hse_kvdb_kvs_drop(w->kvdb, KVS_NAME), "hse_kvdb_kvs_drop");
+}
+
+/* Runs the operation over the workload once.
+ *
+ * Returns the nanoseconds per operation.
+ */
+static double
+run_once(struct workload *const w, const char *const name, const op_fn fn)
+{
+    uint64_t start;
+
+    start = now_ns();
+    for (size_t i = 0; i < w->ops; i++)
+        check(fn(w, i), name);
+
+    return (double)(now_ns() - start) / w->ops;
+}
+
+/* Runs the operation the same way the Java driver does: WARMUP_RUNS times
+ * untimed, which also lets the JIT compile the Java loops, then RUNS times
+ * timed.
+ */
+static void
+run(struct workload *const w, const char *const name, const enum kind kind, const op_fn fn)
+{
+    double samples[RUNS];
+    double mean = 0;
+    double var = 0;
+
+    if (kind != KIND_PUT)
+        kvs_setup(w, kind);
+
+    for (int r = -WARMUP_RUNS; r < RUNS; r++) {
+        double ns;
+
+        if (kind == KIND_PUT)
+            kvs_setup(w, kind);
+        else if (kind == KIND_CURSOR)
+            check(rewind_cursor(w), "hse_kvs_cursor_seek");
+
+        ns = run_once(w, name, fn);
+
+        if (kind == KIND_PUT)
+            kvs_teardown(w);
+        if (r >= 0)
+            samples[r] = ns;
+    }
+
+    if (kind != KIND_PUT)
+        kvs_teardown(w);
+
+    for (int r = 0; r < RUNS; r++)
+        mean += samples[r];
+    mean /= RUNS;
+    for (int r = 0; r < RUNS; r++)
+        var += (samples[r] - mean) * (samples[r] - mean);
+    var /= RUNS - 1;
+
+    printf("%s,%zu,%zu,%zu,%d,%.1f,%.1f\n", name, w->key_sz, w->value_sz, w->ops, RUNS, mean,
+        sqrt(var));
+    fflush(stdout);
+}
+
+static void
+bench(struct hse_kvdb *const kvdb, const size_t key_sz, const size_t value_sz)
+{
+    struct workload w = { 0 };
+    char fmt[32];
+
+    w.kvdb = kvdb;
+    w.key_sz = key_sz;
+    w.value_sz = value_sz;
+    w.records = DATASET_BYTES / (key_sz + value_sz);
+    if (w.records > MAX_RECORDS)
+        w.records = MAX_RECORDS;
+    w.ops = w.records * PASSES;
+
+    w.keys = malloc(w.records * key_sz + 1);
+    w.value = malloc(value_sz);
+    w.key_buf = malloc(key_sz);
+    w.value_buf = malloc(value_sz);
+    w.scratch_sz = SCRATCH_SZ_MIN;
+    w.scratch = malloc(w.scratch_sz);
+    if (!w.keys || !w.value || !w.key_buf || !w.value_buf || !w.scratch) {
+        fprintf(stderr, "Failed to allocate workload\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Zero-padded decimal keys, which sort in index order. */
+    snprintf(fmt, sizeof(fmt), "%%0%zuzu", key_sz);
+    for (size_t i = 0; i < w.records; i++)
+        snprintf(w.keys + i * key_sz, key_sz + 1, fmt, i);
+    memset(w.value, 'v', value_sz);
+
+    run(&w, "put", KIND_PUT, op_put);
+    run(&w, "get", KIND_GET, op_get);
+    run(&w, "get_malloc", KIND_GET, op_get_malloc);
+    run(&w, "get_scratch", KIND_GET, op_get_scratch);
+    run(&w, "cursor_read", KIND_CURSOR, op_cursor_read);
+    run(&w, "cursor_read_copy", KIND_CURSOR, op_cursor_read_copy);
+    run(&w, "seek", KIND_CURSOR, op_seek);
+
+    free(w.keys);
+    free(w.value);
+    free(w.key_buf);
+    free(w.value_buf);
+    free(w.scratch);
+}
+
+int
+main(const int argc, const char *const argv[])
+{
+    struct hse_kvdb *kvdb;
+    const char *const paramv[] = { "rest.enabled=false" };
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s KVDB_HOME\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    check(hse_init(NULL, 1, paramv), "hse_init");
+    check(hse_kvdb_create(argv[1], 0, NULL), "hse_kvdb_create");
+    check(hse_kvdb_open(argv[1], 0, NULL, &kvdb), "hse_kvdb_open");
+
+    printf("op,key_size,value_size,ops,runs,ns_per_op,stddev_ns\n");
+    for (size_t k = 0; k < sizeof(key_sizes) / sizeof(key_sizes[0]); k++) {
+        for (size_t v = 0; v < sizeof(value_sizes) / sizeof(value_sizes[0]); v++)
+            bench(kvdb, key_sizes[k], value_sizes[v]);
+    }
+
+    check(hse_kvdb_close(kvdb), "hse_kvdb_close");
+    check(hse_kvdb_drop(argv[1]), "hse_kvdb_drop");
+    hse_fini();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1943 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+/* In-memory stand-in for the subset of libhse which the bindings use. Built
+ * instead of linking HSE when the fake_hse option is enabled, so that the
+ * bindings can be profiled and tested without storage.
+ *
+ * Every KVS is a skip list of keys, each with a chain of versions, newest
+ * first, stamped with the sequence number of the KVDB at the time of the
+ * write. Readers see the newest version no newer than their view, and
+ * versions which no open view can see are freed as new ones are written.
+ * Nodes are never removed while their KVS exists, so cursors can point into
+ * them.
+ *
+ * Transactions buffer their writes in a private skip list per KVS, and take a
+ * write lock on each key they write. A write conflicts with ECANCELED if
+ * another transaction holds the key's lock, or if the key was written after
+ * the transaction's view, as in HSE. Commits apply all writes at a single
+ * sequence number.
+ *
+ * Cursors collect the records they can see when created or when their view is
+ * updated: references to the records of the KVS, and copies of the writes of
+ * their transaction, which are freed when the transaction ends. KVDBs exist
+ * only in the memory of the process, and are keyed by their home.
+ *
+ * Each KVDB is guarded by a single mutex, which serializes every operation on
+ * it and on its KVSs, cursors, and transactions. Throughput through the fake
+ * therefore does not grow with threads, so it is unsuitable for scalability
+ * runs; use it to measure the single-threaded cost of the bindings.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/hse.h>
+#include <hse/limits.h>
+
+#ifdef HSE_JAVA_EXPERIMENTAL
+#include <hse/experimental.h>
+#endif
+
+#define SKIPLIST_HEIGHT_MAX 16
+#define MCLASS_ALLOCATED_BYTES (1ULL << 30)
+
+struct params {
+    size_t paramc;
+    char **paramv;
+};
+
+struct version {
+    struct version *older;
+    uint64_t seq;
+    bool tomb;
+    size_t len;
+    char data[];
+};
+
+struct node {
+    struct version *newest;
+    /* Transaction holding the write lock of the key. */
+    struct hse_kvdb_txn *writer;
+    char *key;
+    size_t key_len;
+    int height;
+    struct node *next[];
+};
+
+struct skiplist {
+    struct node *head;
+    int height;
+    uint64_t rand;
+};
+
+/* An open view, which keeps the versions it can see from being freed. */
+struct snapshot {
+    struct snapshot *next;
+    uint64_t seq;
+};
+
+/* A KVS, which outlives its handles. */
+struct store {
+    struct store *next;
+    char name[HSE_KVS_NAME_LEN_MAX];
+    struct params cparams;
+    struct skiplist map;
+    struct hse_kvs *handle;
+};
+
+struct hse_kvs {
+    struct hse_kvdb *kvdb;
+    struct store *store;
+    struct params rparams;
+};
+
+/* A KVDB, which is its own handle while open. */
+struct hse_kvdb {
+    struct hse_kvdb *next;
+    char *home;
+    pthread_mutex_t lock;
+    bool open;
+    uint64_t seq;
+    uint64_t used_bytes;
+    struct params rparams;
+    struct store *stores;
+    struct snapshot *snapshots;
+};
+
+struct prefix {
+    struct prefix *next;
+    size_t len;
+    char data[];
+};
+
+/* Writes of a transaction to one KVS. */
+struct txn_kvs {
+    struct txn_kvs *next;
+    struct store *store;
+    struct skiplist writes;
+    struct prefix *pdels;
+};
+
+struct hse_kvdb_txn {
+    struct hse_kvdb *kvdb;
+    enum hse_kvdb_txn_state state;
+    struct snapshot snap;
+    struct txn_kvs *kvss;
+};
+
+struct record {
+    const char *key;
+    size_t key_len;
+    const char *value;
+    size_t value_len;
+    /* Copy holding key and value, for records written by the cursor's
+     * transaction, or NULL.
+     */
+    char *copy;
+};
+
+struct hse_kvs_cursor {
+    struct hse_kvs *kvs;
+    struct hse_kvdb_txn *txn;
+    bool rev;
+    char *filter;
+    size_t filter_len;
+    struct snapshot snap;
+    struct record *records;
+    size_t records_len;
+    /* Index of the next record, or one past it for reverse cursors. */
+    size_t pos;
+    char *min;
+    size_t min_len;
+    char *max;
+    size_t max_len;
+    bool bounded;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    struct hse_kvdb *kvdbs;
+    struct params params;
+} fake = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static int
+key_cmp(const void *const a, const size_t a_len, const void *const b, const size_t b_len)
+{
+    const int rc = memcmp(a, b, a_len < b_len ? a_len : b_len);
+
+    if (rc)
+        return rc;
+
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static bool
+has_prefix(const void *const key, const size_t key_len, const void *const pfx,
+    const size_t pfx_len)
+{
+    return key_len >= pfx_len && memcmp(key, pfx, pfx_len) == 0;
+}
+
+static hse_err_t
+params_init(struct params *const params, const size_t paramc, const char *const *const paramv)
+{
+    params->paramc = 0;
+    params->paramv = NULL;
+
+    if (paramc == 0)
+        return 0;
+
+    if (!paramv)
+        return ENOMEM;
+
+    params->paramv = calloc(paramc, sizeof(*params->paramv));
+    if (!params->paramv)
+        return ENOMEM;
+
+    for (size_t i = 0; i < paramc; i++) {
+        if (!paramv[i] || !strchr(paramv[i], '='))
+            return EINVAL;
+
+        params->paramv[i] = strdup(paramv[i]);
+        if (!params->paramv[i])
+            return ENOMEM;
+
+        params->paramc++;
+    }
+
+    return 0;
+}
+
+static void
+params_fini(struct params *const params)
+{
+    for (size_t i = 0; i < params->paramc; i++)
+        free(params->paramv[i]);
+    free(params->paramv);
+
+    params->paramc = 0;
+    params->paramv = NULL;
+}
+
+static const char *
+params_find(const struct params *const params, const char *const param)
+{
+    const size_t param_len = strlen(param);
+
+    /* Later parameters override earlier ones. */
+    for (size_t i = params->paramc; i > 0; i--) {
+        const char *const p = params->paramv[i - 1];
+
+        if (strncmp(p, param, param_len) == 0 && p[param_len] == '=')
+            return p + param_len + 1;
+    }
+
+    return NULL;
+}
+
+static hse_err_t
+param_copy(
+    const char *const value,
+    char *const buf,
+    const size_t buf_sz,
+    size_t *const needed_sz)
+{
+    const size_t len = strlen(value);
+
+    if (needed_sz)
+        *needed_sz = len;
+    if (buf && buf_sz > 0)
+        snprintf(buf, buf_sz, "%s", value);
+
+    return 0;
+}
+
+static hse_err_t
+check_key(const void *const key, const size_t key_len)
+{
+    if (!key || key_len == 0)
+        return EINVAL;
+    if (key_len > HSE_KVS_KEY_LEN_MAX)
+        return EMSGSIZE;
+
+    return 0;
+}
+
+static uint64_t
+horizon(const struct hse_kvdb *const kvdb)
+{
+    uint64_t seq = kvdb->seq;
+
+    for (const struct snapshot *s = kvdb->snapshots; s; s = s->next) {
+        if (s->seq < seq)
+            seq = s->seq;
+    }
+
+    return seq;
+}
+
+static void
+snapshot_register(struct hse_kvdb *const kvdb, struct snapshot *const snap, const uint64_t seq)
+{
+    snap->seq = seq;
+    snap->next = kvdb->snapshots;
+    kvdb->snapshots = snap;
+}
+
+static void
+snapshot_unregister(struct hse_kvdb *const kvdb, struct snapshot *const snap)
+{
+    for (struct snapshot **s = &kvdb->snapshots; *s; s = &(*s)->next) {
+        if (*s == snap) {
+            *s = snap->next;
+            break;
+        }
+    }
+}
+
+static hse_err_t
+skiplist_init(struct skiplist *const sl)
+{
+    sl->head = calloc(1, sizeof(*sl->head) + SKIPLIST_HEIGHT_MAX * sizeof(sl->head->next[0]));
+    if (!sl->head)
+        return ENOMEM;
+
+    sl->head->height = SKIPLIST_HEIGHT_MAX;
+    sl->height = 1;
+    /* A fixed seed keeps runs deterministic. */
+    sl->rand = 0x9e3779b97f4a7c15ULL;
+
+    return 0;
+}
+
+static void
+versions_free(struct version *v)
+{
+    while (v) {
+        struct version *const older = v->older;
+
+        free(v);
+        v = older;
+    }
+}
+
+static void
+skiplist_fini(struct skiplist *const sl)
+{
+    struct node *node;
+
+    if (!sl->head)
+        return;
+
+    node = sl->head->next[0];
+    while (node) {
+        struct node *const next = node->next[0];
+
+        versions_free(node->newest);
+        free(node->key);
+        free(node);
+        node = next;
+    }
+
+    free(sl->head);
+    sl->head = NULL;
+}
+
+/* Finds the first node not less than key, filling in the last node before it
+ * at every level if update is given.
+ */
+static struct node *
+skiplist_seek(
+    const struct skiplist *const sl,
+    const void *const key,
+    const size_t key_len,
+    struct node **const update)
+{
+    struct node *node = sl->head;
+
+    for (int level = SKIPLIST_HEIGHT_MAX - 1; level >= 0; level--) {
+        while (node->next[level] &&
+               key_cmp(node->next[level]->key, node->next[level]->key_len, key, key_len) < 0)
+            node = node->next[level];
+        if (update)
+            update[level] = node;
+    }
+
+    return node->next[0];
+}
+
+static struct node *
+skiplist_find(const struct skiplist *const sl, const void *const key, const size_t key_len)
+{
+    struct node *const node = skiplist_seek(sl, key, key_len, NULL);
+
+    if (node && key_cmp(node->key, node->key_len, key, key_len) == 0)
+        return node;
+
+    return NULL;
+}
+
+static struct node *
+skiplist_insert(struct skiplist *const sl, const void *const key, const size_t key_len)
+{
+    struct node *update[SKIPLIST_HEIGHT_MAX];
+    struct node *node;
+    int height = 1;
+
+    node = skiplist_seek(sl, key, key_len, update);
+    if (node && key_cmp(node->key, node->key_len, key, key_len) == 0)
+        return node;
+
+    /* xorshift64, one level per trailing set bit pair. */
+    sl->rand ^= sl->rand << 13;
+    sl->rand ^= sl->rand >> 7;
+    sl->rand ^= sl->rand << 17;
+    while (height < SKIPLIST_HEIGHT_MAX && ((sl->rand >> (2 * height)) & 3) == 3)
+        height++;
+
+    node = calloc(1, sizeof(*node) + height * sizeof(node->next[0]));
+    if (!node)
+        return NULL;
+
+    node->key = malloc(key_len);
+    if (!node->key) {
+        free(node);
+        return NULL;
+    }
+    memcpy(node->key, key, key_len);
+    node->key_len = key_len;
+    node->height = height;
+
+    for (int level = 0; level < height; level++) {
+        node->next[level] = update[level]->next[level];
+        update[level]->next[level] = node;
+    }
+
+    return node;
+}
+
+static hse_err_t
+version_push(
+    struct node *const node,
+    const uint64_t seq,
+    const bool tomb,
+    const void *const data,
+    const size_t len)
+{
+    struct version *const v = malloc(sizeof(*v) + len);
+
+    if (!v)
+        return ENOMEM;
+
+    v->seq = seq;
+    v->tomb = tomb;
+    v->len = len;
+    if (len > 0)
+        memcpy(v->data, data, len);
+    v->older = node->newest;
+    node->newest = v;
+
+    return 0;
+}
+
+/* Frees the versions which are hidden from every open view. */
+static void
+version_prune(struct node *const node, const uint64_t horizon)
+{
+    for (struct version *v = node->newest; v; v = v->older) {
+        if (v->seq <= horizon) {
+            versions_free(v->older);
+            v->older = NULL;
+            break;
+        }
+    }
+}
+
+static const struct version *
+version_visible(const struct node *const node, const uint64_t seq)
+{
+    for (const struct version *v = node->newest; v; v = v->older) {
+        if (v->seq <= seq)
+            return v->tomb ? NULL : v;
+    }
+
+    return NULL;
+}
+
+static struct hse_kvdb *
+kvdb_find(const char *const home)
+{
+    for (struct hse_kvdb *kvdb = fake.kvdbs; kvdb; kvdb = kvdb->next) {
+        if (strcmp(kvdb->home, home) == 0)
+            return kvdb;
+    }
+
+    return NULL;
+}
+
+static struct store *
+store_find(const struct hse_kvdb *const kvdb, const char *const name)
+{
+    for (struct store *store = kvdb->stores; store; store = store->next) {
+        if (strcmp(store->name, name) == 0)
+            return store;
+    }
+
+    return NULL;
+}
+
+static void
+store_free(struct store *const store)
+{
+    skiplist_fini(&store->map);
+    params_fini(&store->cparams);
+    free(store);
+}
+
+static struct txn_kvs *
+txn_kvs_get(struct hse_kvdb_txn *const txn, struct store *const store, const bool create)
+{
+    struct txn_kvs *tk;
+
+    for (tk = txn->kvss; tk; tk = tk->next) {
+        if (tk->store == store)
+            return tk;
+    }
+
+    if (!create)
+        return NULL;
+
+    tk = calloc(1, sizeof(*tk));
+    if (!tk)
+        return NULL;
+
+    if (skiplist_init(&tk->writes)) {
+        free(tk);
+        return NULL;
+    }
+
+    tk->store = store;
+    tk->next = txn->kvss;
+    txn->kvss = tk;
+
+    return tk;
+}
+
+static bool
+txn_pdeleted(const struct txn_kvs *const tk, const void *const key, const size_t key_len)
+{
+    for (const struct prefix *p = tk->pdels; p; p = p->next) {
+        if (has_prefix(key, key_len, p->data, p->len))
+            return true;
+    }
+
+    return false;
+}
+
+/* Releases the locks and writes of a transaction. Must hold the KVDB lock. */
+static void
+txn_reset(struct hse_kvdb_txn *const txn, const enum hse_kvdb_txn_state state)
+{
+    while (txn->kvss) {
+        struct txn_kvs *const tk = txn->kvss;
+
+        for (struct node *n = tk->writes.head->next[0]; n; n = n->next[0]) {
+            struct node *const node = skiplist_find(&tk->store->map, n->key, n->key_len);
+
+            if (node && node->writer == txn)
+                node->writer = NULL;
+        }
+
+        while (tk->pdels) {
+            struct prefix *const p = tk->pdels;
+
+            tk->pdels = p->next;
+            free(p);
+        }
+
+        skiplist_fini(&tk->writes);
+        txn->kvss = tk->next;
+        free(tk);
+    }
+
+    if (txn->state == HSE_KVDB_TXN_ACTIVE)
+        snapshot_unregister(txn->kvdb, &txn->snap);
+    txn->state = state;
+}
+
+static hse_err_t
+write_locked(
+    struct hse_kvs *const kvs,
+    struct hse_kvdb_txn *const txn,
+    const void *const key,
+    const size_t key_len,
+    const bool tomb,
+    const void *const value,
+    const size_t value_len)
+{
+    struct hse_kvdb *const kvdb = kvs->kvdb;
+    struct node *node;
+    struct txn_kvs *tk;
+    hse_err_t err;
+
+    if (!txn) {
+        node = skiplist_insert(&kvs->store->map, key, key_len);
+        if (!node)
+            return ENOMEM;
+
+        err = version_push(node, ++kvdb->seq, tomb, value, value_len);
+        if (err)
+            return err;
+
+        kvdb->used_bytes += key_len + value_len;
+        version_prune(node, horizon(kvdb));
+
+        return 0;
+    }
+
+    if (txn->state != HSE_KVDB_TXN_ACTIVE)
+        return EINVAL;
+
+    node = skiplist_insert(&kvs->store->map, key, key_len);
+    if (!node)
+        return ENOMEM;
+
+    if ((node->writer && node->writer != txn) ||
+        (node->newest && node->newest->seq > txn->snap.seq))
+        return ECANCELED;
+
+    tk = txn_kvs_get(txn, kvs->store, true);
+    if (!tk)
+        return ENOMEM;
+
+    node->writer = txn;
+    node = skiplist_insert(&tk->writes, key, key_len);
+    if (!node)
+        return ENOMEM;
+
+    /* Cursors copy the transaction's writes, so only the newest is kept. */
+    err = version_push(node, 0, tomb, value, value_len);
+    if (!err)
+        version_prune(node, 0);
+
+    return err;
+}
+
+static hse_err_t
+write_op(
+    struct hse_kvs *const kvs,
+    struct hse_kvdb_txn *const txn,
+    const void *const key,
+    const size_t key_len,
+    const bool tomb,
+    const void *const value,
+    const size_t value_len)
+{
+    hse_err_t err;
+
+    if (!kvs)
+        return EINVAL;
+
+    err = check_key(key, key_len);
+    if (err)
+        return err;
+
+    if (value_len > HSE_KVS_VALUE_LEN_MAX)
+        return EMSGSIZE;
+    if (!value && value_len > 0)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvs->kvdb->lock);
+    err = write_locked(kvs, txn, key, key_len, tomb, value, value_len);
+    pthread_mutex_unlock(&kvs->kvdb->lock);
+
+    return err;
+}
+
+int
+hse_err_to_errno(const hse_err_t err)
+{
+    return (int)err;
+}
+
+enum hse_err_ctx
+hse_err_to_ctx(const hse_err_t err)
+{
+    (void)err;
+
+    return HSE_ERR_CTX_NONE;
+}
+
+size_t
+hse_strerror(const hse_err_t err, char *const buf, const size_t buf_sz)
+{
+    const char *const msg = strerror(hse_err_to_errno(err));
+
+    if (buf && buf_sz > 0)
+        snprintf(buf, buf_sz, "%s", msg);
+
+    return strlen(msg);
+}
+
+hse_err_t
+hse_init(const char *const config, const size_t paramc, const char *const *const paramv)
+{
+    hse_err_t err;
+
+    (void)config;
+
+    pthread_mutex_lock(&fake.lock);
+    params_fini(&fake.params);
+    err = params_init(&fake.params, paramc, paramv);
+    pthread_mutex_unlock(&fake.lock);
+
+    return err;
+}
+
+void
+hse_fini(void)
+{
+    pthread_mutex_lock(&fake.lock);
+    params_fini(&fake.params);
+    pthread_mutex_unlock(&fake.lock);
+}
+
+hse_err_t
+hse_param_get(const char *const param, char *const buf, const size_t buf_sz,
+    size_t *const needed_sz)
+{
+    const char *value;
+    hse_err_t err;
+
+    if (!param)
+        return EINVAL;
+
+    pthread_mutex_lock(&fake.lock);
+    value = params_find(&fake.params, param);
+    if (!value && strcmp(param, "logging.enabled") == 0)
+        value = "true";
+    err = value ? param_copy(value, buf, buf_sz, needed_sz) : EINVAL;
+    pthread_mutex_unlock(&fake.lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_create(const char *kvdb_home, const size_t paramc, const char *const *const paramv)
+{
+    struct hse_kvdb *kvdb;
+    struct params params;
+    hse_err_t err;
+
+    if (!kvdb_home)
+        kvdb_home = ".";
+
+    /* Create-time parameters are validated, but have no effect in memory. */
+    err = params_init(&params, paramc, paramv);
+    params_fini(&params);
+    if (err)
+        return err;
+
+    pthread_mutex_lock(&fake.lock);
+
+    if (kvdb_find(kvdb_home)) {
+        err = EEXIST;
+        goto out;
+    }
+
+    kvdb = calloc(1, sizeof(*kvdb));
+    if (!kvdb) {
+        err = ENOMEM;
+        goto out;
+    }
+
+    kvdb->home = strdup(kvdb_home);
+    if (!kvdb->home) {
+        free(kvdb);
+        err = ENOMEM;
+        goto out;
+    }
+
+    pthread_mutex_init(&kvdb->lock, NULL);
+    kvdb->next = fake.kvdbs;
+    fake.kvdbs = kvdb;
+
+out:
+    pthread_mutex_unlock(&fake.lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_drop(const char *kvdb_home)
+{
+    hse_err_t err = ENOENT;
+
+    if (!kvdb_home)
+        kvdb_home = ".";
+
+    pthread_mutex_lock(&fake.lock);
+
+    for (struct hse_kvdb **k = &fake.kvdbs; *k; k = &(*k)->next) {
+        struct hse_kvdb *const kvdb = *k;
+
+        if (strcmp(kvdb->home, kvdb_home) != 0)
+            continue;
+
+        if (kvdb->open) {
+            err = EBUSY;
+            break;
+        }
+
+        *k = kvdb->next;
+        while (kvdb->stores) {
+            struct store *const store = kvdb->stores;
+
+            kvdb->stores = store->next;
+            store_free(store);
+        }
+        pthread_mutex_destroy(&kvdb->lock);
+        free(kvdb->home);
+        free(kvdb);
+        err = 0;
+        break;
+    }
+
+    pthread_mutex_unlock(&fake.lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_open(
+    const char *kvdb_home,
+    const size_t paramc,
+    const char *const *const paramv,
+    struct hse_kvdb **const kvdb_out)
+{
+    struct hse_kvdb *kvdb;
+    hse_err_t err = 0;
+
+    if (!kvdb_out)
+        return EINVAL;
+
+    if (!kvdb_home)
+        kvdb_home = ".";
+
+    pthread_mutex_lock(&fake.lock);
+
+    kvdb = kvdb_find(kvdb_home);
+    if (!kvdb) {
+        err = ENOENT;
+    } else if (kvdb->open) {
+        err = EBUSY;
+    } else {
+        err = params_init(&kvdb->rparams, paramc, paramv);
+        if (err) {
+            params_fini(&kvdb->rparams);
+        } else {
+            kvdb->open = true;
+            *kvdb_out = kvdb;
+        }
+    }
+
+    pthread_mutex_unlock(&fake.lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_close(struct hse_kvdb *const kvdb)
+{
+    if (!kvdb)
+        return EINVAL;
+
+    pthread_mutex_lock(&fake.lock);
+    params_fini(&kvdb->rparams);
+    kvdb->open = false;
+    pthread_mutex_unlock(&fake.lock);
+
+    return 0;
+}
+
+const char *
+hse_kvdb_home_get(struct hse_kvdb *const kvdb)
+{
+    return kvdb ? kvdb->home : NULL;
+}
+
+hse_err_t
+hse_kvdb_param_get(
+    struct hse_kvdb *const kvdb,
+    const char *const param,
+    char *const buf,
+    const size_t buf_sz,
+    size_t *const needed_sz)
+{
+    const char *value;
+
+    if (!kvdb || !param)
+        return EINVAL;
+
+    value = params_find(&kvdb->rparams, param);
+    if (!value)
+        return EINVAL;
+
+    return param_copy(value, buf, buf_sz, needed_sz);
+}
+
+hse_err_t
+hse_kvdb_storage_add(const char *const kvdb_home, const size_t paramc,
+    const char *const *const paramv)
+{
+    (void)kvdb_home;
+    (void)paramc;
+    (void)paramv;
+
+    return ENOTSUP;
+}
+
+bool
+hse_kvdb_mclass_is_configured(struct hse_kvdb *const kvdb, const enum hse_mclass mclass)
+{
+    return kvdb && mclass == HSE_MCLASS_CAPACITY;
+}
+
+hse_err_t
+hse_kvdb_mclass_info_get(
+    struct hse_kvdb *const kvdb,
+    const enum hse_mclass mclass,
+    struct hse_mclass_info *const info)
+{
+    if (!kvdb || !info)
+        return EINVAL;
+
+    if (mclass != HSE_MCLASS_CAPACITY)
+        return ENOENT;
+
+    memset(info, 0, sizeof(*info));
+    snprintf(info->mi_path, sizeof(info->mi_path), "%s/capacity", kvdb->home);
+
+    pthread_mutex_lock(&kvdb->lock);
+    info->mi_allocated_bytes = MCLASS_ALLOCATED_BYTES;
+    /* Never 0, like a freshly created KVDB on disk. */
+    info->mi_used_bytes = kvdb->used_bytes + 1;
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return 0;
+}
+
+hse_err_t
+hse_kvdb_sync(struct hse_kvdb *const kvdb, const unsigned int flags)
+{
+    (void)flags;
+
+    return kvdb ? 0 : EINVAL;
+}
+
+#ifdef HSE_JAVA_EXPERIMENTAL
+hse_err_t
+hse_kvdb_compact(struct hse_kvdb *const kvdb, const unsigned int flags)
+{
+    (void)flags;
+
+    return kvdb ? 0 : EINVAL;
+}
+
+hse_err_t
+hse_kvdb_compact_status_get(
+    struct hse_kvdb *const kvdb,
+    struct hse_kvdb_compact_status *const status)
+{
+    if (!kvdb || !status)
+        return EINVAL;
+
+    memset(status, 0, sizeof(*status));
+
+    return 0;
+}
+#endif
+
+hse_err_t
+hse_kvdb_kvs_names_get(struct hse_kvdb *const kvdb, size_t *const namec, char ***const namev)
+{
+    size_t count = 0;
+    char **names;
+    hse_err_t err = 0;
+
+    if (!kvdb || !namev)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvdb->lock);
+
+    for (const struct store *store = kvdb->stores; store; store = store->next)
+        count++;
+
+    names = calloc(count + 1, sizeof(*names));
+    if (!names) {
+        err = ENOMEM;
+        goto out;
+    }
+
+    count = 0;
+    for (const struct store *store = kvdb->stores; store; store = store->next) {
+        names[count] = strdup(store->name);
+        if (!names[count]) {
+            hse_kvdb_kvs_names_free(kvdb, names);
+            err = ENOMEM;
+            goto out;
+        }
+        count++;
+    }
+
+    if (namec)
+        *namec = count;
+    *namev = names;
+
+out:
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return err;
+}
+
+void
+hse_kvdb_kvs_names_free(struct hse_kvdb *const kvdb, char **const namev)
+{
+    (void)kvdb;
+
+    if (!namev)
+        return;
+
+    for (char **name = namev; *name; name++)
+        free(*name);
+    free(namev);
+}
+
+hse_err_t
+hse_kvdb_kvs_create(
+    struct hse_kvdb *const kvdb,
+    const char *const kvs_name,
+    const size_t paramc,
+    const char *const *const paramv)
+{
+    struct store *store;
+    size_t count = 0;
+    hse_err_t err;
+
+    if (!kvdb || !kvs_name || kvs_name[0] == '\0')
+        return EINVAL;
+    if (strlen(kvs_name) >= HSE_KVS_NAME_LEN_MAX)
+        return ENAMETOOLONG;
+
+    store = calloc(1, sizeof(*store));
+    if (!store)
+        return ENOMEM;
+
+    strcpy(store->name, kvs_name);
+
+    err = params_init(&store->cparams, paramc, paramv);
+    if (!err)
+        err = skiplist_init(&store->map);
+    if (err) {
+        store_free(store);
+        return err;
+    }
+
+    pthread_mutex_lock(&kvdb->lock);
+
+    for (const struct store *s = kvdb->stores; s; s = s->next)
+        count++;
+
+    if (store_find(kvdb, kvs_name)) {
+        err = EEXIST;
+    } else if (count >= HSE_KVS_COUNT_MAX) {
+        err = ENOSPC;
+    } else {
+        store->next = kvdb->stores;
+        kvdb->stores = store;
+        store = NULL;
+    }
+
+    pthread_mutex_unlock(&kvdb->lock);
+
+    if (store)
+        store_free(store);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_kvs_drop(struct hse_kvdb *const kvdb, const char *const kvs_name)
+{
+    hse_err_t err = ENOENT;
+
+    if (!kvdb || !kvs_name)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvdb->lock);
+
+    for (struct store **s = &kvdb->stores; *s; s = &(*s)->next) {
+        struct store *const store = *s;
+
+        if (strcmp(store->name, kvs_name) != 0)
+            continue;
+
+        if (store->handle) {
+            err = EBUSY;
+            break;
+        }
+
+        *s = store->next;
+        store_free(store);
+        err = 0;
+        break;
+    }
+
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_kvs_open(
+    struct hse_kvdb *const kvdb,
+    const char *const kvs_name,
+    const size_t paramc,
+    const char *const *const paramv,
+    struct hse_kvs **const kvs_out)
+{
+    struct hse_kvs *kvs;
+    struct store *store;
+    hse_err_t err = 0;
+
+    if (!kvdb || !kvs_name || !kvs_out)
+        return EINVAL;
+
+    kvs = calloc(1, sizeof(*kvs));
+    if (!kvs)
+        return ENOMEM;
+
+    err = params_init(&kvs->rparams, paramc, paramv);
+    if (err) {
+        params_fini(&kvs->rparams);
+        free(kvs);
+        return err;
+    }
+
+    pthread_mutex_lock(&kvdb->lock);
+
+    store = store_find(kvdb, kvs_name);
+    if (!store) {
+        err = ENOENT;
+    } else if (store->handle) {
+        err = EBUSY;
+    } else {
+        kvs->kvdb = kvdb;
+        kvs->store = store;
+        store->handle = kvs;
+        *kvs_out = kvs;
+        kvs = NULL;
+    }
+
+    pthread_mutex_unlock(&kvdb->lock);
+
+    if (kvs) {
+        params_fini(&kvs->rparams);
+        free(kvs);
+    }
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_kvs_close(struct hse_kvs *const kvs)
+{
+    if (!kvs)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvs->kvdb->lock);
+    kvs->store->handle = NULL;
+    pthread_mutex_unlock(&kvs->kvdb->lock);
+
+    params_fini(&kvs->rparams);
+    free(kvs);
+
+    return 0;
+}
+
+const char *
+hse_kvs_name_get(struct hse_kvs *const kvs)
+{
+    return kvs ? kvs->store->name : NULL;
+}
+
+hse_err_t
+hse_kvs_param_get(
+    struct hse_kvs *const kvs,
+    const char *const param,
+    char *const buf,
+    const size_t buf_sz,
+    size_t *const needed_sz)
+{
+    const char *value;
+
+    if (!kvs || !param)
+        return EINVAL;
+
+    value = params_find(&kvs->rparams, param);
+    if (!value)
+        value = params_find(&kvs->store->cparams, param);
+    if (!value && strcmp(param, "transactions.enabled") == 0)
+        value = "false";
+    if (!value && strcmp(param, "prefix.length") == 0)
+        value = "0";
+    if (!value)
+        return EINVAL;
+
+    return param_copy(value, buf, buf_sz, needed_sz);
+}
+
+hse_err_t
+hse_kvs_put(
+    struct hse_kvs *const kvs,
+    const unsigned int flags,
+    struct hse_kvdb_txn *const txn,
+    const void *const key,
+    const size_t key_len,
+    const void *const val,
+    const size_t val_len)
+{
+    (void)flags;
+
+    return write_op(kvs, txn, key, key_len, false, val, val_len);
+}
+
+hse_err_t
+hse_kvs_delete(
+    struct hse_kvs *const kvs,
+    const unsigned int flags,
+    struct hse_kvdb_txn *const txn,
+    const void *const key,
+    const size_t key_len)
+{
+    (void)flags;
+
+    return write_op(kvs, txn, key, key_len, true, NULL, 0);
+}
+
+hse_err_t
+hse_kvs_get(
+    struct hse_kvs *const kvs,
+    const unsigned int flags,
+    struct hse_kvdb_txn *const txn,
+    const void *const key,
+    const size_t key_len,
+    bool *const found,
+    void *const buf,
+    const size_t buf_len,
+    size_t *const val_len)
+{
+    const struct version *v = NULL;
+    const struct node *node;
+    hse_err_t err;
+
+    (void)flags;
+
+    if (!kvs || !found || !val_len)
+        return EINVAL;
+
+    err = check_key(key, key_len);
+    if (err)
+        return err;
+
+    pthread_mutex_lock(&kvs->kvdb->lock);
+
+    if (txn && txn->state != HSE_KVDB_TXN_ACTIVE) {
+        err = EINVAL;
+        goto out;
+    }
+
+    if (txn) {
+        const struct txn_kvs *const tk = txn_kvs_get(txn, kvs->store, false);
+
+        node = tk ? skiplist_find(&tk->writes, key, key_len) : NULL;
+        if (node) {
+            v = node->newest->tomb ? NULL : node->newest;
+        } else if (!tk || !txn_pdeleted(tk, key, key_len)) {
+            node = skiplist_find(&kvs->store->map, key, key_len);
+            v = node ? version_visible(node, txn->snap.seq) : NULL;
+        }
+    } else {
+        node = skiplist_find(&kvs->store->map, key, key_len);
+        v = node ? version_visible(node, kvs->kvdb->seq) : NULL;
+    }
+
+    *found = v != NULL;
+    if (v) {
+        *val_len = v->len;
+        if (buf && buf_len > 0)
+            memcpy(buf, v->data, v->len < buf_len ? v->len : buf_len);
+    }
+
+out:
+    pthread_mutex_unlock(&kvs->kvdb->lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_prefix_delete(
+    struct hse_kvs *const kvs,
+    const unsigned int flags,
+    struct hse_kvdb_txn *const txn,
+    const void *const pfx,
+    const size_t pfx_len)
+{
+    struct hse_kvdb *kvdb;
+    hse_err_t err = 0;
+
+    (void)flags;
+
+    if (!kvs || !pfx || pfx_len == 0)
+        return EINVAL;
+    if (pfx_len > HSE_KVS_PFX_LEN_MAX)
+        return EINVAL;
+
+    kvdb = kvs->kvdb;
+    pthread_mutex_lock(&kvdb->lock);
+
+    if (!txn) {
+        const uint64_t seq = ++kvdb->seq;
+        const uint64_t h = horizon(kvdb);
+
+        for (struct node *n = skiplist_seek(&kvs->store->map, pfx, pfx_len, NULL);
+             n && has_prefix(n->key, n->key_len, pfx, pfx_len); n = n->next[0]) {
+            if (!version_visible(n, seq))
+                continue;
+
+            err = version_push(n, seq, true, NULL, 0);
+            if (err)
+                break;
+            version_prune(n, h);
+        }
+    } else if (txn->state != HSE_KVDB_TXN_ACTIVE) {
+        err = EINVAL;
+    } else {
+        struct txn_kvs *const tk = txn_kvs_get(txn, kvs->store, true);
+        struct prefix *p;
+
+        if (!tk) {
+            err = ENOMEM;
+            goto out;
+        }
+
+        p = malloc(sizeof(*p) + pfx_len);
+        if (!p) {
+            err = ENOMEM;
+            goto out;
+        }
+
+        /* Earlier writes of the transaction are deleted too. */
+        for (struct node *n = skiplist_seek(&tk->writes, pfx, pfx_len, NULL);
+             n && has_prefix(n->key, n->key_len, pfx, pfx_len); n = n->next[0]) {
+            err = version_push(n, 0, true, NULL, 0);
+            if (err) {
+                free(p);
+                goto out;
+            }
+        }
+
+        memcpy(p->data, pfx, pfx_len);
+        p->len = pfx_len;
+        p->next = tk->pdels;
+        tk->pdels = p;
+    }
+
+out:
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return err;
+}
+
+struct hse_kvdb_txn *
+hse_kvdb_txn_alloc(struct hse_kvdb *const kvdb)
+{
+    struct hse_kvdb_txn *txn;
+
+    if (!kvdb)
+        return NULL;
+
+    txn = calloc(1, sizeof(*txn));
+    if (!txn)
+        return NULL;
+
+    txn->kvdb = kvdb;
+    txn->state = HSE_KVDB_TXN_INVALID;
+
+    return txn;
+}
+
+void
+hse_kvdb_txn_free(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    if (!kvdb || !txn)
+        return;
+
+    pthread_mutex_lock(&kvdb->lock);
+    txn_reset(txn, HSE_KVDB_TXN_ABORTED);
+    pthread_mutex_unlock(&kvdb->lock);
+
+    free(txn);
+}
+
+hse_err_t
+hse_kvdb_txn_begin(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    hse_err_t err = 0;
+
+    if (!kvdb || !txn)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvdb->lock);
+
+    if (txn->state == HSE_KVDB_TXN_ACTIVE) {
+        err = EINVAL;
+    } else {
+        txn_reset(txn, HSE_KVDB_TXN_ACTIVE);
+        snapshot_register(kvdb, &txn->snap, kvdb->seq);
+    }
+
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return err;
+}
+
+static hse_err_t
+txn_commit_locked(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    uint64_t seq;
+    hse_err_t err;
+
+    if (txn->state != HSE_KVDB_TXN_ACTIVE)
+        return EINVAL;
+
+    for (const struct txn_kvs *tk = txn->kvss; tk; tk = tk->next) {
+        for (const struct node *n = tk->writes.head->next[0]; n; n = n->next[0]) {
+            const struct node *const node = skiplist_find(&tk->store->map, n->key, n->key_len);
+
+            /* Non-transactional writes do not take locks. */
+            if (node && node->newest && node->newest->seq > txn->snap.seq) {
+                txn_reset(txn, HSE_KVDB_TXN_ABORTED);
+                return ECANCELED;
+            }
+        }
+    }
+
+    seq = ++kvdb->seq;
+
+    for (const struct txn_kvs *tk = txn->kvss; tk; tk = tk->next) {
+        for (const struct prefix *p = tk->pdels; p; p = p->next) {
+            for (struct node *n = skiplist_seek(&tk->store->map, p->data, p->len, NULL);
+                 n && has_prefix(n->key, n->key_len, p->data, p->len); n = n->next[0]) {
+                if (!version_visible(n, seq))
+                    continue;
+
+                err = version_push(n, seq, true, NULL, 0);
+                if (err)
+                    return err;
+            }
+        }
+
+        for (const struct node *n = tk->writes.head->next[0]; n; n = n->next[0]) {
+            struct node *const node = skiplist_insert(&tk->store->map, n->key, n->key_len);
+
+            if (!node)
+                return ENOMEM;
+
+            err = version_push(node, seq, n->newest->tomb, n->newest->data, n->newest->len);
+            if (err)
+                return err;
+
+            kvdb->used_bytes += n->key_len + n->newest->len;
+        }
+    }
+
+    txn_reset(txn, HSE_KVDB_TXN_COMMITTED);
+
+    return 0;
+}
+
+hse_err_t
+hse_kvdb_txn_commit(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    hse_err_t err;
+
+    if (!kvdb || !txn)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvdb->lock);
+    err = txn_commit_locked(kvdb, txn);
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_txn_abort(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    if (!kvdb || !txn)
+        return EINVAL;
+
+    pthread_mutex_lock(&kvdb->lock);
+    if (txn->state == HSE_KVDB_TXN_ACTIVE)
+        txn_reset(txn, HSE_KVDB_TXN_ABORTED);
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return 0;
+}
+
+enum hse_kvdb_txn_state
+hse_kvdb_txn_state_get(struct hse_kvdb *const kvdb, struct hse_kvdb_txn *const txn)
+{
+    enum hse_kvdb_txn_state state;
+
+    if (!kvdb || !txn)
+        return HSE_KVDB_TXN_INVALID;
+
+    pthread_mutex_lock(&kvdb->lock);
+    state = txn->state;
+    pthread_mutex_unlock(&kvdb->lock);
+
+    return state;
+}
+
+static void
+cursor_records_free(struct hse_kvs_cursor *const cursor)
+{
+    for (size_t i = 0; i < cursor->records_len; i++)
+        free(cursor->records[i].copy);
+
+    free(cursor->records);
+    cursor->records = NULL;
+    cursor->records_len = 0;
+}
+
+/* Adds a record, copying it if it lives only as long as the transaction. */
+static hse_err_t
+cursor_record_add(
+    struct hse_kvs_cursor *const cursor,
+    size_t *const cap,
+    const struct node *const node,
+    const struct version *const v,
+    const bool copy)
+{
+    struct record *r;
+
+    if (cursor->records_len == *cap) {
+        const size_t new_cap = *cap ? *cap * 2 : 64;
+        struct record *const records = realloc(cursor->records, new_cap * sizeof(*records));
+
+        if (!records)
+            return ENOMEM;
+
+        cursor->records = records;
+        *cap = new_cap;
+    }
+
+    r = &cursor->records[cursor->records_len];
+    *r = (struct record){
+        .key = node->key,
+        .key_len = node->key_len,
+        .value = v->data,
+        .value_len = v->len,
+    };
+
+    if (copy) {
+        r->copy = malloc(node->key_len + v->len);
+        if (!r->copy)
+            return ENOMEM;
+
+        memcpy(r->copy, node->key, node->key_len);
+        if (v->len > 0)
+            memcpy(r->copy + node->key_len, v->data, v->len);
+        r->key = r->copy;
+        r->value = r->copy + node->key_len;
+    }
+
+    cursor->records_len++;
+
+    return 0;
+}
+
+/* Collects the records the cursor can see, merging the writes of its
+ * transaction over the KVS. Must hold the KVDB lock.
+ */
+static hse_err_t
+cursor_collect(struct hse_kvs_cursor *const cursor)
+{
+    const struct txn_kvs *const tk =
+        cursor->txn ? txn_kvs_get(cursor->txn, cursor->kvs->store, false) : NULL;
+    const struct node *n;
+    const struct node *t;
+    size_t cap = 0;
+    hse_err_t err = 0;
+
+    cursor_records_free(cursor);
+
+    n = skiplist_seek(&cursor->kvs->store->map, cursor->filter, cursor->filter_len, NULL);
+    t = tk ? skiplist_seek(&tk->writes, cursor->filter, cursor->filter_len, NULL) : NULL;
+
+    while (!err) {
+        const bool n_in = n && has_prefix(n->key, n->key_len, cursor->filter, cursor->filter_len);
+        const bool t_in = t && has_prefix(t->key, t->key_len, cursor->filter, cursor->filter_len);
+        int cmp;
+
+        if (!n_in && !t_in)
+            break;
+
+        cmp = !t_in ? -1 : !n_in ? 1 : key_cmp(n->key, n->key_len, t->key, t->key_len);
+
+        if (cmp >= 0) {
+            /* The transaction's own write wins. */
+            if (!t->newest->tomb)
+                err = cursor_record_add(cursor, &cap, t, t->newest, true);
+            t = t->next[0];
+            if (cmp == 0)
+                n = n->next[0];
+        } else {
+            const struct version *const v = version_visible(n, cursor->snap.seq);
+
+            if (v && !(tk && txn_pdeleted(tk, n->key, n->key_len)))
+                err = cursor_record_add(cursor, &cap, n, v, false);
+            n = n->next[0];
+        }
+    }
+
+    return err;
+}
+
+/* Index of the first record not less than key, or greater than key if after. */
+static size_t
+cursor_bound(const struct hse_kvs_cursor *const cursor, const void *const key,
+    const size_t key_len, const bool after)
+{
+    size_t lo = 0;
+    size_t hi = cursor->records_len;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const struct record *const r = &cursor->records[mid];
+        const int cmp = key_cmp(r->key, r->key_len, key, key_len);
+
+        if (cmp < 0 || (after && cmp == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static const struct record *
+cursor_peek(const struct hse_kvs_cursor *const cursor)
+{
+    const struct record *r;
+
+    if (cursor->rev) {
+        if (cursor->pos == 0)
+            return NULL;
+
+        r = &cursor->records[cursor->pos - 1];
+        if (cursor->bounded && key_cmp(r->key, r->key_len, cursor->min, cursor->min_len) < 0)
+            return NULL;
+    } else {
+        if (cursor->pos >= cursor->records_len)
+            return NULL;
+
+        r = &cursor->records[cursor->pos];
+        if (cursor->bounded && key_cmp(r->key, r->key_len, cursor->max, cursor->max_len) > 0)
+            return NULL;
+    }
+
+    return r;
+}
+
+static void
+cursor_position(struct hse_kvs_cursor *const cursor, const void *const key, const size_t key_len)
+{
+    if (!key) {
+        cursor->pos = cursor->rev ? cursor->records_len : 0;
+        return;
+    }
+
+    /* Reverse cursors land on the last key not greater than key. */
+    cursor->pos = cursor_bound(cursor, key, key_len, cursor->rev);
+}
+
+hse_err_t
+hse_kvs_cursor_create(
+    struct hse_kvs *const kvs,
+    const unsigned int flags,
+    struct hse_kvdb_txn *const txn,
+    const void *const filter,
+    const size_t filter_len,
+    struct hse_kvs_cursor **const cursor_out)
+{
+    struct hse_kvs_cursor *cursor;
+    struct hse_kvdb *kvdb;
+    hse_err_t err = 0;
+
+    if (!kvs || !cursor_out || (!filter && filter_len > 0))
+        return EINVAL;
+    if (filter_len > HSE_KVS_KEY_LEN_MAX)
+        return EMSGSIZE;
+
+    cursor = calloc(1, sizeof(*cursor));
+    if (!cursor)
+        return ENOMEM;
+
+    cursor->kvs = kvs;
+    cursor->txn = txn;
+    cursor->rev = flags & HSE_CURSOR_CREATE_REV;
+    if (filter_len > 0) {
+        cursor->filter = malloc(filter_len);
+        if (!cursor->filter) {
+            free(cursor);
+            return ENOMEM;
+        }
+        memcpy(cursor->filter, filter, filter_len);
+        cursor->filter_len = filter_len;
+    }
+
+    kvdb = kvs->kvdb;
+    pthread_mutex_lock(&kvdb->lock);
+
+    if (txn && txn->state != HSE_KVDB_TXN_ACTIVE) {
+        err = EINVAL;
+    } else {
+        snapshot_register(kvdb, &cursor->snap, txn ? txn->snap.seq : kvdb->seq);
+        err = cursor_collect(cursor);
+        if (err)
+            snapshot_unregister(kvdb, &cursor->snap);
+    }
+
+    pthread_mutex_unlock(&kvdb->lock);
+
+    if (err) {
+        cursor_records_free(cursor);
+        free(cursor->filter);
+        free(cursor);
+        return err;
+    }
+
+    cursor_position(cursor, NULL, 0);
+    *cursor_out = cursor;
+
+    return 0;
+}
+
+hse_err_t
+hse_kvs_cursor_destroy(struct hse_kvs_cursor *const cursor)
+{
+    if (!cursor)
+        return EINVAL;
+
+    pthread_mutex_lock(&cursor->kvs->kvdb->lock);
+    snapshot_unregister(cursor->kvs->kvdb, &cursor->snap);
+    pthread_mutex_unlock(&cursor->kvs->kvdb->lock);
+
+    cursor_records_free(cursor);
+    free(cursor->filter);
+    free(cursor->min);
+    free(cursor->max);
+    free(cursor);
+
+    return 0;
+}
+
+hse_err_t
+hse_kvs_cursor_update_view(struct hse_kvs_cursor *const cursor, const unsigned int flags)
+{
+    struct hse_kvdb *kvdb;
+    const struct record *last = NULL;
+    char *key = NULL;
+    size_t key_len = 0;
+    hse_err_t err;
+
+    (void)flags;
+
+    if (!cursor)
+        return EINVAL;
+
+    /* Remember the last record read, to resume after it in the new view. */
+    if (cursor->rev ? cursor->pos < cursor->records_len : cursor->pos > 0)
+        last = &cursor->records[cursor->rev ? cursor->pos : cursor->pos - 1];
+    if (last) {
+        key = malloc(last->key_len);
+        if (!key)
+            return ENOMEM;
+        memcpy(key, last->key, last->key_len);
+        key_len = last->key_len;
+    }
+
+    kvdb = cursor->kvs->kvdb;
+    pthread_mutex_lock(&kvdb->lock);
+    snapshot_unregister(kvdb, &cursor->snap);
+    snapshot_register(kvdb, &cursor->snap, cursor->txn ? cursor->txn->snap.seq : kvdb->seq);
+    err = cursor_collect(cursor);
+    pthread_mutex_unlock(&kvdb->lock);
+
+    if (!err) {
+        if (!key)
+            cursor_position(cursor, NULL, 0);
+        else
+            cursor->pos = cursor_bound(cursor, key, key_len, !cursor->rev);
+    }
+
+    free(key);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_cursor_seek(
+    struct hse_kvs_cursor *const cursor,
+    const unsigned int flags,
+    const void *const key,
+    const size_t key_len,
+    const void **const found,
+    size_t *const found_len)
+{
+    const struct record *r;
+
+    (void)flags;
+
+    if (!cursor || (!key && key_len > 0))
+        return EINVAL;
+
+    cursor_position(cursor, key_len > 0 ? key : NULL, key_len);
+
+    r = cursor_peek(cursor);
+    if (found)
+        *found = r ? r->key : NULL;
+    if (found_len)
+        *found_len = r ? r->key_len : 0;
+
+    return 0;
+}
+
+hse_err_t
+hse_kvs_cursor_seek_range(
+    struct hse_kvs_cursor *const cursor,
+    const unsigned int flags,
+    const void *const filt_min,
+    const size_t filt_min_len,
+    const void *const filt_max,
+    const size_t filt_max_len,
+    const void **const found,
+    size_t *const found_len)
+{
+    char *min;
+    char *max;
+
+    if (!cursor || !filt_min || !filt_max)
+        return EINVAL;
+
+    min = malloc(filt_min_len + 1);
+    max = malloc(filt_max_len + 1);
+    if (!min || !max) {
+        free(min);
+        free(max);
+        return ENOMEM;
+    }
+    memcpy(min, filt_min, filt_min_len);
+    memcpy(max, filt_max, filt_max_len);
+
+    free(cursor->min);
+    free(cursor->max);
+    cursor->min = min;
+    cursor->min_len = filt_min_len;
+    cursor->max = max;
+    cursor->max_len = filt_max_len;
+    cursor->bounded = true;
+
+    return hse_kvs_cursor_seek(
+        cursor, flags, cursor->rev ? max : min, cursor->rev ? filt_max_len : filt_min_len, found,
+        found_len);
+}
+
+hse_err_t
+hse_kvs_cursor_read(
+    struct hse_kvs_cursor *const cursor,
+    const unsigned int flags,
+    const void **const key,
+    size_t *const key_len,
+    const void **const val,
+    size_t *const val_len,
+    bool *const eof)
+{
+    const struct record *r;
+
+    (void)flags;
+
+    if (!cursor || !key || !key_len || !val || !val_len || !eof)
+        return EINVAL;
+
+    r = cursor_peek(cursor);
+    *eof = !r;
+    if (!r)
+        return 0;
+
+    if (cursor->rev)
+        cursor->pos--;
+    else
+        cursor->pos++;
+
+    *key = r->key;
+    *key_len = r->key_len;
+    *val = r->value;
+    *val_len = r->value_len;
+
+    return 0;
+}
+
+hse_err_t
+hse_kvs_cursor_read_copy(
+    struct hse_kvs_cursor *const cursor,
+    const unsigned int flags,
+    void *const keybuf,
+    const size_t keybuf_sz,
+    size_t *const key_len,
+    void *const valbuf,
+    const size_t valbuf_sz,
+    size_t *const val_len,
+    bool *const eof)
+{
+    const void *key;
+    const void *val;
+    hse_err_t err;
+
+    if (!key_len || !val_len)
+        return EINVAL;
+
+    err = hse_kvs_cursor_read(cursor, flags, &key, key_len, &val, val_len, eof);
+    if (err || *eof)
+        return err;
+
+    if (keybuf && keybuf_sz > 0)
+        memcpy(keybuf, key, *key_len < keybuf_sz ? *key_len : keybuf_sz);
+    if (valbuf && valbuf_sz > 0)
+        memcpy(valbuf, val, *val_len < valbuf_sz ? *val_len : valbuf_sz);
+
+    return 0;
+}
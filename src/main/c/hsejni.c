@@ -5,18 +5,404 @@
 
 #include <assert.h>
 #include <jni.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <hse/hse.h>
+#include <hse/limits.h>
 
+#include "async.h"
 #include "hsejni.h"
 
-#define HSE_JNI_VERSION JNI_VERSION_1_8
-
 static_assert(sizeof(jbyte) == sizeof(char), "Assumption is made throughout the code");
 
 struct globals globals;
 
+/* Smallest scratch buffer handed out. Most values are far smaller than
+ * HSE_KVS_VALUE_LEN_MAX, so start small and grow on demand.
+ */
+#define SCRATCH_SZ_MIN (4 * 1024)
+
+/* A buffer grown for one large value would otherwise be kept for the life of
+ * the thread. Once this many requests in a row have needed at most a quarter
+ * of it, shrink it to fit the largest of them.
+ */
+#define SCRATCH_SHRINK_RUN (1024)
+
+struct scratch {
+    size_t buf_sz;
+    size_t run_peak_sz;
+    unsigned int small_run;
+    char buf[];
+};
+
+static pthread_key_t scratch_key;
+
+static void
+scratch_destroy(void *arg)
+{
+    free(arg);
+}
+
+static size_t
+scratch_size(size_t from_sz, size_t needed_sz)
+{
+    size_t new_sz = from_sz;
+
+    while (new_sz < needed_sz)
+        new_sz <<= 1;
+
+    return new_sz;
+}
+
+void *
+scratch_reserve(size_t needed_sz, size_t *buf_sz)
+{
+    size_t new_sz;
+    struct scratch *scratch;
+
+    assert(buf_sz);
+
+    scratch = pthread_getspecific(scratch_key);
+    if (scratch && scratch->buf_sz >= needed_sz) {
+        /* A request for 0 bytes only asks for whatever is there. */
+        if (needed_sz == 0 || scratch->buf_sz == SCRATCH_SZ_MIN) {
+            *buf_sz = scratch->buf_sz;
+            return scratch->buf;
+        }
+
+        if (needed_sz > scratch->buf_sz / 4) {
+            scratch->small_run = 0;
+            scratch->run_peak_sz = 0;
+            *buf_sz = scratch->buf_sz;
+            return scratch->buf;
+        }
+
+        if (needed_sz > scratch->run_peak_sz)
+            scratch->run_peak_sz = needed_sz;
+
+        if (++scratch->small_run < SCRATCH_SHRINK_RUN) {
+            *buf_sz = scratch->buf_sz;
+            return scratch->buf;
+        }
+
+        new_sz = scratch_size(SCRATCH_SZ_MIN, scratch->run_peak_sz);
+    } else {
+        new_sz = scratch_size(scratch ? scratch->buf_sz : SCRATCH_SZ_MIN, needed_sz);
+    }
+
+    /* The old contents are never needed, so avoid the copy realloc() would
+     * make.
+     */
+    free(scratch);
+    scratch = malloc(sizeof(*scratch) + new_sz);
+    if (!scratch || pthread_setspecific(scratch_key, scratch) != 0) {
+        free(scratch);
+        pthread_setspecific(scratch_key, NULL);
+        *buf_sz = 0;
+        return NULL;
+    }
+
+    scratch->buf_sz = new_sz;
+    scratch->run_peak_sz = 0;
+    scratch->small_run = 0;
+    *buf_sz = scratch->buf_sz;
+
+    return scratch->buf;
+}
+
+const void *
+key_array_acquire(JNIEnv *env, jbyteArray array, jsize len, void *buf)
+{
+    void *data;
+
+    if (!array)
+        return NULL;
+
+    /* HSE rejects anything longer than a key, but the bytes must still be
+     * readable, so let the JVM make the copy.
+     */
+    if (len > HSE_KVS_KEY_LEN_MAX) {
+        data = (*env)->GetByteArrayElements(env, array, NULL);
+        if (!data)
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for key");
+        return data;
+    }
+
+    (*env)->GetByteArrayRegion(env, array, 0, len, buf);
+    if ((*env)->ExceptionCheck(env))
+        return NULL;
+
+    return buf;
+}
+
+void
+key_array_release(JNIEnv *env, jbyteArray array, const void *data, const void *buf)
+{
+    if (!data || data == buf)
+        return;
+
+    (*env)->ReleaseByteArrayElements(env, array, (jbyte *)data, JNI_ABORT);
+}
+
+const void *
+value_array_acquire(JNIEnv *env, jbyteArray array, jsize len)
+{
+    void *data;
+    size_t buf_sz;
+
+    if (!array)
+        return NULL;
+
+    /* Copy rather than pin with GetPrimitiveArrayCritical(). HSE may block in
+     * a put, for instance when throttling, and a critical region held across
+     * that would stall the garbage collector for every other thread.
+     */
+    data = scratch_reserve(len, &buf_sz);
+    if (!data) {
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class, "Failed to allocate memory for value");
+        return NULL;
+    }
+
+    (*env)->GetByteArrayRegion(env, array, 0, len, data);
+    if ((*env)->ExceptionCheck(env))
+        return NULL;
+
+    return data;
+}
+
+void *
+out_array_acquire(JNIEnv *env, jbyteArray array, jsize sz)
+{
+    void *data;
+    size_t buf_sz;
+
+    if (!array)
+        return NULL;
+
+    data = scratch_reserve(sz, &buf_sz);
+    if (!data)
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for output buffer");
+
+    return data;
+}
+
+void
+out_array_release(JNIEnv *env, jbyteArray array, void *data, jsize sz, jsize written)
+{
+    if (!data)
+        return;
+
+    // Only copy back what was written rather than the whole array
+    if (written > 0)
+        (*env)->SetByteArrayRegion(env, array, 0, written < sz ? written : sz, data);
+}
+
+/* Longest string, in UTF-16 code units, copied onto the stack with
+ * GetStringRegion(). Longer strings are accessed with GetStringCritical().
+ */
+#define STRING_REGION_LEN_MAX (512)
+
+/* Returns the length of the run of ASCII code units at the start of src.
+ * Checks 4 code units at a time.
+ */
+static jsize
+ascii_run_len(const jchar *src, jsize src_len)
+{
+    jsize i = 0;
+
+    static_assert(sizeof(uint64_t) == 4 * sizeof(jchar), "ASCII fast path assumes 4 jchars");
+
+    for (; i + 4 <= src_len; i += 4) {
+        uint64_t word;
+
+        memcpy(&word, src + i, sizeof(word));
+        if (word & UINT64_C(0xff80ff80ff80ff80))
+            break;
+    }
+
+    while (i < src_len && src[i] < 0x80)
+        i++;
+
+    return i;
+}
+
+/* Encodes src as standard UTF-8, like String.getBytes(StandardCharsets.UTF_8),
+ * so unpaired surrogates become '?'. Returns the encoded length. Nothing is
+ * written past dst_sz, and the output is only complete if the returned length
+ * is at most dst_sz.
+ */
+static size_t
+utf8_encode(const jchar *src, jsize src_len, uint8_t *dst, size_t dst_sz)
+{
+    jsize i = 0;
+    size_t off = 0;
+
+    while (i < src_len) {
+        uint32_t cp;
+        uint8_t seq[4];
+        size_t seq_len;
+        const jsize run = ascii_run_len(src + i, src_len - i);
+
+        if (run > 0) {
+            if (off + run <= dst_sz) {
+                for (jsize j = 0; j < run; j++)
+                    dst[off + j] = (uint8_t)src[i + j];
+            }
+
+            off += run;
+            i += run;
+            continue;
+        }
+
+        cp = src[i++];
+        if (cp >= 0xd800 && cp <= 0xdbff && i < src_len && src[i] >= 0xdc00 &&
+            src[i] <= 0xdfff) {
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (src[i++] - 0xdc00);
+        } else if (cp >= 0xd800 && cp <= 0xdfff) {
+            cp = '?';
+        }
+
+        if (cp < 0x80) {
+            seq[0] = cp;
+            seq_len = 1;
+        } else if (cp < 0x800) {
+            seq[0] = 0xc0 | (cp >> 6);
+            seq[1] = 0x80 | (cp & 0x3f);
+            seq_len = 2;
+        } else if (cp < 0x10000) {
+            seq[0] = 0xe0 | (cp >> 12);
+            seq[1] = 0x80 | ((cp >> 6) & 0x3f);
+            seq[2] = 0x80 | (cp & 0x3f);
+            seq_len = 3;
+        } else {
+            seq[0] = 0xf0 | (cp >> 18);
+            seq[1] = 0x80 | ((cp >> 12) & 0x3f);
+            seq[2] = 0x80 | ((cp >> 6) & 0x3f);
+            seq[3] = 0x80 | (cp & 0x3f);
+            seq_len = 4;
+        }
+
+        if (off + seq_len <= dst_sz)
+            memcpy(dst + off, seq, seq_len);
+        off += seq_len;
+    }
+
+    return off;
+}
+
+/* Returns the code units of str, copied into region if it has at most
+ * STRING_REGION_LEN_MAX of them, and held with GetStringCritical() otherwise.
+ * Returns NULL with a pending exception on failure.
+ */
+static const jchar *
+string_chars_acquire(JNIEnv *env, jstring str, jsize str_len, jchar *region)
+{
+    const jchar *chars;
+
+    if (str_len <= STRING_REGION_LEN_MAX) {
+        (*env)->GetStringRegion(env, str, 0, str_len, region);
+        return region;
+    }
+
+    chars = (*env)->GetStringCritical(env, str, NULL);
+    if (!chars)
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class, "Failed to allocate memory for string");
+
+    return chars;
+}
+
+static void
+string_chars_release(JNIEnv *env, jstring str, const jchar *chars, const jchar *region)
+{
+    if (chars && chars != region)
+        (*env)->ReleaseStringCritical(env, str, chars);
+}
+
+const char *
+string_acquire(JNIEnv *env, jstring str, void *buf, size_t buf_sz, size_t *len)
+{
+    jsize str_len;
+    size_t needed;
+    void *data;
+    const jchar *chars;
+    const bool scratch = !buf;
+    jchar region[STRING_REGION_LEN_MAX];
+
+    assert(len);
+
+    *len = 0;
+
+    if (!str)
+        return NULL;
+
+    str_len = (*env)->GetStringLength(env, str);
+
+    /* Most strings are ASCII, so size the scratch buffer for that and encode
+     * in a single pass. Only strings that turn out to be longer once encoded
+     * need a second one. Nothing may be allocated while a critical string is
+     * held, so the buffer is reserved first.
+     */
+    if (scratch) {
+        buf = scratch_reserve(str_len, &buf_sz);
+        if (!buf) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for string");
+            return NULL;
+        }
+    }
+
+    chars = string_chars_acquire(env, str, str_len, region);
+    if (!chars)
+        return NULL;
+
+    data = buf;
+    needed = utf8_encode(chars, str_len, data, buf_sz);
+    if (needed > buf_sz) {
+        string_chars_release(env, str, chars, region);
+
+        data = scratch ? scratch_reserve(needed, &buf_sz) : malloc(needed);
+        if (!data) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for string");
+            return NULL;
+        }
+
+        chars = string_chars_acquire(env, str, str_len, region);
+        if (!chars) {
+            if (!scratch)
+                free(data);
+            return NULL;
+        }
+
+        utf8_encode(chars, str_len, data, needed);
+    }
+
+    string_chars_release(env, str, chars, region);
+
+    *len = needed;
+
+    return data;
+}
+
+void
+string_release(const char *data, const void *buf)
+{
+    if (buf && data != buf)
+        free((void *)data);
+}
+
 void
 to_paramv(JNIEnv *env, jobjectArray params, jsize *paramc, const char ***paramv)
 {
@@ -155,6 +541,9 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
     if (rc)
         return rc;
 
+    if (pthread_key_create(&scratch_key, scratch_destroy) != 0)
+        return JNI_ERR;
+
     local = (*env)->FindClass(env, "io/github/hse_project/hse/HseException");
     ASSERT_NO_EXCEPTION();
     globals.io.github.hse_project.hse.HseException.class = (*env)->NewGlobalRef(env, local);
@@ -264,6 +653,19 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
     ;
     ERROR_IF_REF_IS_NULL();
 
+    local = (*env)->FindClass(env, "io/github/hse_project/hse/KvsCursor$View");
+    ASSERT_NO_EXCEPTION();
+    globals.io.github.hse_project.hse.KvsCursor.View.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+    globals.io.github.hse_project.hse.KvsCursor.View.key = (*env)->GetFieldID(
+        env, globals.io.github.hse_project.hse.KvsCursor.View.class, "key",
+        "Ljava/nio/ByteBuffer;");
+    ASSERT_NO_EXCEPTION();
+    globals.io.github.hse_project.hse.KvsCursor.View.value = (*env)->GetFieldID(
+        env, globals.io.github.hse_project.hse.KvsCursor.View.class, "value",
+        "Ljava/nio/ByteBuffer;");
+    ASSERT_NO_EXCEPTION();
+
     local = (*env)->FindClass(env, "io/github/hse_project/hse/MclassInfo");
     ASSERT_NO_EXCEPTION();
     globals.io.github.hse_project.hse.MclassInfo.class = (*env)->NewGlobalRef(env, local);
@@ -278,11 +680,29 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
         env, globals.io.github.hse_project.hse.MclassInfo.class, "path", "Ljava/nio/file/Path;");
     ASSERT_NO_EXCEPTION();
 
+    local = (*env)->FindClass(env, "io/github/hse_project/hse/WriteBatch");
+    ASSERT_NO_EXCEPTION();
+    globals.io.github.hse_project.hse.WriteBatch.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+    globals.io.github.hse_project.hse.WriteBatch.failedIndex = (*env)->GetFieldID(
+        env, globals.io.github.hse_project.hse.WriteBatch.class, "failedIndex", "I");
+    ASSERT_NO_EXCEPTION();
+
     local = (*env)->FindClass(env, "java/io/EOFException");
     ASSERT_NO_EXCEPTION();
     globals.java.io.EOFException.class = (*env)->NewGlobalRef(env, local);
     ERROR_IF_REF_IS_NULL();
 
+    local = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+    ASSERT_NO_EXCEPTION();
+    globals.java.lang.IllegalArgumentException.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+
+    local = (*env)->FindClass(env, "java/lang/IllegalStateException");
+    ASSERT_NO_EXCEPTION();
+    globals.java.lang.IllegalStateException.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+
     local = (*env)->FindClass(env, "java/lang/Integer");
     ASSERT_NO_EXCEPTION();
     globals.java.lang.Integer.class = (*env)->NewGlobalRef(env, local);
@@ -291,6 +711,14 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
         (*env)->GetMethodID(env, globals.java.lang.Integer.class, "<init>", "(I)V");
     ASSERT_NO_EXCEPTION();
 
+    local = (*env)->FindClass(env, "java/lang/Long");
+    ASSERT_NO_EXCEPTION();
+    globals.java.lang.Long.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+    globals.java.lang.Long.valueOf = (*env)->GetStaticMethodID(
+        env, globals.java.lang.Long.class, "valueOf", "(J)Ljava/lang/Long;");
+    ASSERT_NO_EXCEPTION();
+
     local = (*env)->FindClass(env, "java/lang/OutOfMemoryError");
     ASSERT_NO_EXCEPTION();
     globals.java.lang.OutOfMemoryError.class = (*env)->NewGlobalRef(env, local);
@@ -306,6 +734,14 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
     globals.java.lang.UnsupportedOperationException.class = (*env)->NewGlobalRef(env, local);
     ERROR_IF_REF_IS_NULL();
 
+    local = (*env)->FindClass(env, "java/nio/ByteBuffer");
+    ASSERT_NO_EXCEPTION();
+    globals.java.nio.ByteBuffer.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+    globals.java.nio.ByteBuffer.asReadOnlyBuffer = (*env)->GetMethodID(
+        env, globals.java.nio.ByteBuffer.class, "asReadOnlyBuffer", "()Ljava/nio/ByteBuffer;");
+    ASSERT_NO_EXCEPTION();
+
     local = (*env)->FindClass(env, "java/nio/file/Paths");
     ASSERT_NO_EXCEPTION();
     globals.java.nio.file.Paths.class = (*env)->NewGlobalRef(env, local);
@@ -339,6 +775,38 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
         "(Ljava/lang/Object;)Ljava/util/Optional;");
     ASSERT_NO_EXCEPTION();
 
+    local = (*env)->FindClass(env, "java/util/concurrent/CompletableFuture");
+    ASSERT_NO_EXCEPTION();
+    globals.java.util.concurrent.CompletableFuture.class = (*env)->NewGlobalRef(env, local);
+    ERROR_IF_REF_IS_NULL();
+    globals.java.util.concurrent.CompletableFuture.init = (*env)->GetMethodID(
+        env, globals.java.util.concurrent.CompletableFuture.class, "<init>", "()V");
+    ASSERT_NO_EXCEPTION();
+    globals.java.util.concurrent.CompletableFuture.complete = (*env)->GetMethodID(
+        env, globals.java.util.concurrent.CompletableFuture.class, "complete",
+        "(Ljava/lang/Object;)Z");
+    ASSERT_NO_EXCEPTION();
+    globals.java.util.concurrent.CompletableFuture.completeExceptionally = (*env)->GetMethodID(
+        env, globals.java.util.concurrent.CompletableFuture.class, "completeExceptionally",
+        "(Ljava/lang/Throwable;)Z");
+    ASSERT_NO_EXCEPTION();
+
+    /* Bind every native method up front rather than having the JVM look up
+     * each one by its mangled name on first call. Only JNI_OnLoad() and
+     * JNI_OnUnload() are exported from the library, so this is required.
+     */
+    for (size_t i = 0; i < native_classes_len; i++) {
+        local = (*env)->FindClass(env, native_classes[i].name);
+        ASSERT_NO_EXCEPTION();
+        ERROR_IF_REF_IS_NULL();
+
+        rc = (*env)->RegisterNatives(
+            env, local, native_classes[i].methods, native_classes[i].methods_len);
+        (*env)->DeleteLocalRef(env, local);
+        if (rc)
+            return JNI_ERR;
+    }
+
     return HSE_JNI_VERSION;
 }
 
@@ -354,6 +822,9 @@ JNI_OnUnload(JavaVM *vm, void *reserved)
     if (rc)
         return;
 
+    /* Workers complete futures through the references below. */
+    async_fini(env);
+
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.HseException.class);
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.HseException.Context.class);
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.HseException.Context.NONE);
@@ -365,13 +836,25 @@ JNI_OnUnload(JavaVM *vm, void *reserved)
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.KvdbTransaction.State.ACTIVE);
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.KvdbTransaction.State.COMMITTED);
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.KvdbTransaction.State.INVALID);
+    (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.KvsCursor.View.class);
     (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.MclassInfo.class);
+    (*env)->DeleteGlobalRef(env, globals.io.github.hse_project.hse.WriteBatch.class);
     (*env)->DeleteGlobalRef(env, globals.java.io.EOFException.class);
+    (*env)->DeleteGlobalRef(env, globals.java.lang.IllegalArgumentException.class);
+    (*env)->DeleteGlobalRef(env, globals.java.lang.IllegalStateException.class);
     (*env)->DeleteGlobalRef(env, globals.java.lang.Integer.class);
+    (*env)->DeleteGlobalRef(env, globals.java.lang.Long.class);
     (*env)->DeleteGlobalRef(env, globals.java.lang.UnsupportedOperationException.class);
     (*env)->DeleteGlobalRef(env, globals.java.lang.String.class);
     (*env)->DeleteGlobalRef(env, globals.java.lang.OutOfMemoryError.class);
+    (*env)->DeleteGlobalRef(env, globals.java.nio.ByteBuffer.class);
     (*env)->DeleteGlobalRef(env, globals.java.nio.file.Paths.class);
     (*env)->DeleteGlobalRef(env, globals.java.util.AbstractMap.SimpleImmutableEntry.class);
     (*env)->DeleteGlobalRef(env, globals.java.util.Optional.class);
+    (*env)->DeleteGlobalRef(env, globals.java.util.concurrent.CompletableFuture.class);
+
+    /* Buffers owned by threads which are still alive are leaked here. Threads
+     * that exit afterward will no longer run the destructor.
+     */
+    pthread_key_delete(scratch_key);
 }
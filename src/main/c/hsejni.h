@@ -7,9 +7,12 @@
 #define HSE_JAVA_COMMON_H
 
 #include <jni.h>
+#include <stddef.h>
 
 #include <hse/types.h>
 
+#define HSE_JNI_VERSION JNI_VERSION_1_8
+
 /* This object is populated during the JNI_OnLoad() function. It saves various
  * class IDs, method IDs, and field IDs for caching purposes.
  */
@@ -46,12 +49,23 @@ struct globals {
                             jobject INVALID;
                         } State;
                     } KvdbTransaction;
+                    struct {
+                        struct {
+                            jclass class;
+                            jfieldID key;
+                            jfieldID value;
+                        } View;
+                    } KvsCursor;
                     struct {
                         jclass class;
                         jfieldID allocatedBytes;
                         jfieldID usedBytes;
                         jfieldID path;
                     } MclassInfo;
+                    struct {
+                        jclass class;
+                        jfieldID failedIndex;
+                    } WriteBatch;
                 } hse;
             } hse_project;
         } github;
@@ -63,10 +77,20 @@ struct globals {
             } EOFException;
         } io;
         struct {
+            struct {
+                jclass class;
+            } IllegalArgumentException;
+            struct {
+                jclass class;
+            } IllegalStateException;
             struct {
                 jclass class;
                 jmethodID init;
             } Integer;
+            struct {
+                jclass class;
+                jmethodID valueOf;
+            } Long;
             struct {
                 jclass class;
             } OutOfMemoryError;
@@ -78,6 +102,10 @@ struct globals {
             } UnsupportedOperationException;
         } lang;
         struct {
+            struct {
+                jclass class;
+                jmethodID asReadOnlyBuffer;
+            } ByteBuffer;
             struct {
                 struct {
                     jclass class;
@@ -98,12 +126,31 @@ struct globals {
                 jmethodID of;
                 jmethodID ofNullable;
             } Optional;
+            struct {
+                struct {
+                    jclass class;
+                    jmethodID init;
+                    jmethodID complete;
+                    jmethodID completeExceptionally;
+                } CompletableFuture;
+            } concurrent;
         } util;
     } java;
 };
 
 extern struct globals globals;
 
+/* Native methods of a single class, registered during JNI_OnLoad(). */
+struct native_class {
+    const char *name;
+    const JNINativeMethod *methods;
+    jint methods_len;
+};
+
+/* Generated from the native headers by scripts/build/natives.py. */
+extern const struct native_class native_classes[];
+extern const size_t native_classes_len;
+
 void
 to_paramv(JNIEnv *env, jobjectArray params, jsize *paramc, const char ***paramv);
 
@@ -113,4 +160,89 @@ free_paramv(JNIEnv *env, jobjectArray params, jsize paramc, const char **paramv)
 jint
 throw_new_hse_exception(JNIEnv *env, hse_err_t err);
 
+/* Keys, prefixes, and filters are short, so they are copied out of Java byte
+ * arrays into a caller-provided buffer of HSE_KVS_KEY_LEN_MAX bytes. Values and
+ * output buffers are copied through the calling thread's scratch buffer with
+ * Get/SetByteArrayRegion(). Arrays are never pinned with
+ * GetPrimitiveArrayCritical(), because the critical region would have to be
+ * held across a call into HSE, which may block, and would hold off the garbage
+ * collector for as long.
+ *
+ * A value or output array uses the scratch buffer, so it may not be acquired
+ * alongside another scratch buffer user, such as a string acquired without a
+ * buffer.
+ *
+ * The acquire functions return NULL if the array is NULL, or with a pending
+ * exception if access failed.
+ */
+const void *
+key_array_acquire(JNIEnv *env, jbyteArray array, jsize len, void *buf);
+
+void
+key_array_release(JNIEnv *env, jbyteArray array, const void *data, const void *buf);
+
+const void *
+value_array_acquire(JNIEnv *env, jbyteArray array, jsize len);
+
+/* written is the number of bytes to copy back into the array, or -1 if its
+ * contents should be discarded.
+ */
+void *
+out_array_acquire(JNIEnv *env, jbyteArray array, jsize sz);
+
+void
+out_array_release(JNIEnv *env, jbyteArray array, void *data, jsize sz, jsize written);
+
+/* Encodes a Java string as standard UTF-8, rather than the modified UTF-8 of
+ * GetStringUTFChars(). The result is not NUL-terminated and its length is
+ * returned through len. It is written to buf if it fits in buf_sz bytes and
+ * is heap allocated otherwise. If buf is NULL, the calling thread's scratch
+ * buffer is used instead, so at most one such string may be live at a time,
+ * and never alongside other scratch buffer users.
+ *
+ * No JNI resources are held once this returns.
+ *
+ * Returns NULL if the string is NULL, or with a pending exception if encoding
+ * failed.
+ */
+const char *
+string_acquire(JNIEnv *env, jstring str, void *buf, size_t buf_sz, size_t *len);
+
+void
+string_release(const char *data, const void *buf);
+
+/* Shared by the synchronous and asynchronous paths. Both report errors by
+ * throwing.
+ */
+jbyteArray
+get_value_array(
+    JNIEnv *env,
+    struct hse_kvs *kvs,
+    jint flags,
+    struct hse_kvdb_txn *txn,
+    const void *key_data,
+    size_t key_len);
+
+/* Native side of a KvsCursor handle. */
+struct cursor;
+
+jlong
+read_batch(
+    JNIEnv *env,
+    struct cursor *cursor,
+    void *buf,
+    size_t buf_sz,
+    jint max_records,
+    unsigned int flags);
+
+/* Returns the calling thread's scratch buffer, growing it if it is smaller
+ * than needed_sz. The buffer is owned by the thread and released when the
+ * thread exits, so callers must not free it or hold onto it across JNI calls.
+ * After a long run of requests for a fraction of its size, the buffer is
+ * shrunk again. A needed_sz of 0 returns the buffer as it is, and does not
+ * count towards that run. Returns NULL if the buffer could not be resized.
+ */
+void *
+scratch_reserve(size_t needed_sz, size_t *buf_sz);
+
 #endif
@@ -5,10 +5,12 @@
 
 #include <jni.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <hse/hse.h>
 
+#include "async.h"
 #include "hsejni.h"
 #include "io_github_hse_project_hse_Hse.h"
 
@@ -95,8 +97,48 @@ Java_io_github_hse_1project_hse_Hse_cinit(
 void
 Java_io_github_hse_1project_hse_Hse_cfini(JNIEnv *env, jclass hse_cls)
 {
-    (void)env;
     (void)hse_cls;
 
+    // Outstanding asynchronous operations still need HSE.
+    async_fini(env);
+
     hse_fini();
 }
+
+void
+Java_io_github_hse_1project_hse_Hse_csetAsyncThreads(JNIEnv *env, jclass hse_cls, jint threads)
+{
+    (void)env;
+    (void)hse_cls;
+
+    async_set_threads(threads);
+}
+
+jlongArray
+Java_io_github_hse_1project_hse_Hse_cforeignSymbols(JNIEnv *env, jclass hse_cls)
+{
+    jlongArray symbols;
+
+    /* Taken here rather than looked up by name, so that the downcalls of
+     * ForeignKvs reach the same HSE as hsejni, whether it is linked
+     * statically or dynamically. The order is that of ForeignKvs.Downcalls.
+     */
+    const jlong addrs[] = {
+        (jlong)(intptr_t)hse_err_to_ctx,
+        (jlong)(intptr_t)hse_err_to_errno,
+        (jlong)(intptr_t)hse_kvs_delete,
+        (jlong)(intptr_t)hse_kvs_get,
+        (jlong)(intptr_t)hse_kvs_put,
+        (jlong)(intptr_t)hse_strerror,
+    };
+
+    (void)hse_cls;
+
+    symbols = (*env)->NewLongArray(env, sizeof(addrs) / sizeof(addrs[0]));
+    if (!symbols)
+        return NULL;
+
+    (*env)->SetLongArrayRegion(env, symbols, 0, sizeof(addrs) / sizeof(addrs[0]), addrs);
+
+    return symbols;
+}
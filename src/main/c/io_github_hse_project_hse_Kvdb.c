@@ -12,6 +12,7 @@
 #include <hse/experimental.h>
 #endif
 
+#include "async.h"
 #include "hsejni.h"
 #include "io_github_hse_project_hse_Kvdb.h"
 
@@ -135,6 +136,9 @@ Java_io_github_hse_1project_hse_Kvdb_close(JNIEnv *env, jobject kvdb_obj, jlong
 
     (void)kvdb_obj;
 
+    // Operations on any of the KVDB's KVSs and transactions.
+    async_drain(env, NULL);
+
     err = hse_kvdb_close(kvdb);
     if (err)
         throw_new_hse_exception(env, err);
@@ -8,42 +8,10 @@
 
 #include <hse/hse.h>
 
+#include "async.h"
 #include "hsejni.h"
 #include "io_github_hse_project_hse_KvdbTransaction.h"
 
-jlong
-Java_io_github_hse_1project_hse_KvdbTransaction_alloc(
-    JNIEnv *env,
-    jclass txn_cls,
-    jlong kvdb_handle)
-{
-    struct hse_kvdb_txn *txn;
-    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
-
-    (void)env;
-    (void)txn_cls;
-
-    txn = hse_kvdb_txn_alloc(kvdb);
-
-    return (jlong)txn;
-}
-
-void
-Java_io_github_hse_1project_hse_KvdbTransaction_free(
-    JNIEnv *env,
-    jobject txn_obj,
-    jlong kvdb_handle,
-    jlong txn_handle)
-{
-    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
-    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
-
-    (void)env;
-    (void)txn_obj;
-
-    hse_kvdb_txn_free(kvdb, txn);
-}
-
 void
 Java_io_github_hse_1project_hse_KvdbTransaction_abort(
     JNIEnv *env,
@@ -57,6 +25,8 @@ Java_io_github_hse_1project_hse_KvdbTransaction_abort(
 
     (void)txn_obj;
 
+    async_drain(env, txn);
+
     err = hse_kvdb_txn_abort(kvdb, txn);
     if (err)
         throw_new_hse_exception(env, err);
@@ -93,6 +63,9 @@ Java_io_github_hse_1project_hse_KvdbTransaction_commit(
 
     (void)txn_obj;
 
+    // Operations submitted before the commit belong to the transaction.
+    async_drain(env, txn);
+
     err = hse_kvdb_txn_commit(kvdb, txn);
     if (err)
         throw_new_hse_exception(env, err);
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#include <jni.h>
+
+#include <hse/hse.h>
+
+#include "async.h"
+#include "hsejni.h"
+#include "io_github_hse_project_hse_KvdbTransactionPool.h"
+
+jlong
+Java_io_github_hse_1project_hse_KvdbTransactionPool_alloc(
+    JNIEnv *env,
+    jclass pool_cls,
+    jlong kvdb_handle)
+{
+    struct hse_kvdb_txn *txn;
+    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
+
+    (void)pool_cls;
+
+    txn = hse_kvdb_txn_alloc(kvdb);
+    if (!txn)
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for transaction");
+
+    return (jlong)txn;
+}
+
+void
+Java_io_github_hse_1project_hse_KvdbTransactionPool_free(
+    JNIEnv *env,
+    jclass pool_cls,
+    jlong kvdb_handle,
+    jlong txn_handle)
+{
+    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    (void)pool_cls;
+
+    async_drain(env, txn);
+
+    hse_kvdb_txn_free(kvdb, txn);
+}
+
+jboolean
+Java_io_github_hse_1project_hse_KvdbTransactionPool_recycle(
+    JNIEnv *env,
+    jclass pool_cls,
+    jlong kvdb_handle,
+    jlong txn_handle)
+{
+    enum hse_kvdb_txn_state state;
+    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    (void)pool_cls;
+
+    // A queued operation must not run under the next lessee.
+    async_drain(env, txn);
+
+    /* A transaction left ACTIVE, for instance by a failed commit, must not be
+     * handed to the next lessee.
+     */
+    state = hse_kvdb_txn_state_get(kvdb, txn);
+    if (state == HSE_KVDB_TXN_ACTIVE && !hse_kvdb_txn_abort(kvdb, txn))
+        state = hse_kvdb_txn_state_get(kvdb, txn);
+
+    if (state != HSE_KVDB_TXN_ACTIVE)
+        return JNI_TRUE;
+
+    hse_kvdb_txn_free(kvdb, txn);
+
+    return JNI_FALSE;
+}
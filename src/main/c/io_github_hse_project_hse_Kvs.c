@@ -7,12 +7,80 @@
 #include <jni.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <hse/hse.h>
 
+#include "async.h"
 #include "hsejni.h"
 #include "io_github_hse_project_hse_Kvs.h"
 
+/* Look up a value through the calling thread's scratch buffer and copy it into
+ * a new byte array. If the value does not fit, the scratch buffer is grown to
+ * the reported length and the lookup is retried. Returns NULL if the key was
+ * not found or an exception was thrown.
+ */
+jbyteArray
+get_value_array(
+    JNIEnv *env,
+    struct hse_kvs *kvs,
+    jint flags,
+    struct hse_kvdb_txn *txn,
+    const void *key_data,
+    size_t key_len)
+{
+    bool found;
+    hse_err_t err;
+    size_t value_len;
+    jbyteArray value;
+    void *value_buf;
+    size_t value_buf_sz;
+
+    value_buf = scratch_reserve(0, &value_buf_sz);
+
+    while (true) {
+        if (!value_buf) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for value buffer");
+            return NULL;
+        }
+
+        err = hse_kvs_get(
+            kvs, flags, txn, key_data, key_len, &found, value_buf, value_buf_sz, &value_len);
+        if (err) {
+            throw_new_hse_exception(env, err);
+            return NULL;
+        }
+
+        if (!found)
+            return NULL;
+
+        if (value_len <= value_buf_sz)
+            break;
+
+        value_buf = scratch_reserve(value_len, &value_buf_sz);
+    }
+
+    value = (*env)->NewByteArray(env, value_len);
+    if (!value) {
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class,
+            "Failed to allocate memory for value byte array");
+        return NULL;
+    }
+
+    (*env)->SetByteArrayRegion(env, value, 0, value_len, value_buf);
+
+    /* Assert that no ArrayIndexOutOfBoundsException occurred. The byte array is
+     * constructed with a size of value_len, so the previous operation is
+     * infallible in theory.
+     */
+    assert(!(*env)->ExceptionCheck(env));
+
+    return value;
+}
+
 void
 Java_io_github_hse_1project_hse_Kvs_create(
     JNIEnv *env,
@@ -117,6 +185,8 @@ Java_io_github_hse_1project_hse_Kvs_close(JNIEnv *env, jobject kvs_obj, jlong kv
 
     (void)kvs_obj;
 
+    async_drain(env, kvs);
+
     err = hse_kvdb_kvs_close(kvs);
     if (err)
         throw_new_hse_exception(env, err);
@@ -133,19 +203,20 @@ Java_io_github_hse_1project_hse_Kvs_delete__J_3BIIJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jbyte *key_data = NULL;
+    const void *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return;
 
     err = hse_kvs_delete(kvs, flags, txn, key_data, key_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -161,22 +232,21 @@ Java_io_github_hse_1project_hse_Kvs_delete__JLjava_lang_String_2IJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize key_len = 0;
-    const char *key_data = NULL;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return;
 
     err = hse_kvs_delete(kvs, flags, txn, key_data, key_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -213,8 +283,11 @@ Java_io_github_hse_1project_hse_Kvs_delete__JLjava_nio_ByteBuffer_2IIIJ(
         throw_new_hse_exception(env, err);
 }
 
-jbyteArray
-Java_io_github_hse_1project_hse_Kvs_get__J_3BIIJ(
+/* Keys and values are copied into the operation, since the arrays cannot be
+ * held once this function returns.
+ */
+jobject
+Java_io_github_hse_1project_hse_Kvs_deleteAsync(
     JNIEnv *env,
     jobject kvs_obj,
     jlong kvs_handle,
@@ -223,130 +296,134 @@ Java_io_github_hse_1project_hse_Kvs_get__J_3BIIJ(
     jint flags,
     jlong txn_handle)
 {
-    bool found;
-    hse_err_t err;
-    size_t value_len;
-    jbyte *value_data;
-    jbyte *key_data = NULL;
-    jbyteArray value = NULL;
-    struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
-    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+    struct async_op *op;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
-
-    value_data = malloc(HSE_KVS_VALUE_LEN_MAX * sizeof(*value_data));
-    if (!value_data) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value buffer");
+    op = async_op_alloc(env, ASYNC_OP_DELETE, key_len);
+    if (!op)
         return NULL;
+
+    op->flags = flags;
+    op->kvs = (struct hse_kvs *)kvs_handle;
+    op->txn = (struct hse_kvdb_txn *)txn_handle;
+    op->key = key ? op->data : NULL;
+    op->key_len = key_len;
+    op->value = NULL;
+    op->value_len = 0;
+
+    if (key) {
+        (*env)->GetByteArrayRegion(env, key, 0, key_len, (jbyte *)op->data);
+        if ((*env)->ExceptionCheck(env)) {
+            async_op_free(env, op);
+            return NULL;
+        }
     }
 
-    err = hse_kvs_get(
-        kvs, flags, txn, key_data, key_len, &found, value_data, HSE_KVS_VALUE_LEN_MAX, &value_len);
+    return async_submit(env, op, false);
+}
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+/* Value length written into a getBatch() record for keys which were not
+ * found. Distinguishes missing keys from 0-length values.
+ */
+#define GET_BATCH_NOT_FOUND (-1)
 
-    if (err) {
-        throw_new_hse_exception(env, err);
-        goto out;
-    }
+/* Look up a key and write a [int32 value length][value] record into buf. The
+ * length is written in native byte order. If the record does not fit, nothing
+ * is written and *record_len is set to 0.
+ */
+static hse_err_t
+get_batch_record(
+    struct hse_kvs *kvs,
+    jint flags,
+    struct hse_kvdb_txn *txn,
+    const void *key_data,
+    size_t key_len,
+    uint8_t *buf,
+    size_t buf_sz,
+    size_t *record_len)
+{
+    bool found;
+    hse_err_t err;
+    size_t value_len;
+    int32_t header;
 
-    if (!found)
-        goto out;
+    *record_len = 0;
 
-    value = (*env)->NewByteArray(env, value_len);
-    if (!value) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value byte array");
-        goto out;
-    }
+    if (buf_sz < sizeof(header))
+        return 0;
+
+    err = hse_kvs_get(
+        kvs, flags, txn, key_data, key_len, &found, buf + sizeof(header), buf_sz - sizeof(header),
+        &value_len);
+    if (err)
+        return err;
 
-    (*env)->SetByteArrayRegion(env, value, 0, value_len, value_data);
+    if (found && value_len > buf_sz - sizeof(header))
+        return 0;
 
-    /* Assert that no ArrayIndexOutOfBoundsException occurred. The byte array is
-     * constructed with a size of value_len, so the previous operation is
-     * infallible in theory.
-     */
-    assert(!(*env)->ExceptionCheck(env));
+    header = found ? (int32_t)value_len : GET_BATCH_NOT_FOUND;
+    memcpy(buf, &header, sizeof(header));
 
-out:
-    free(value_data);
+    *record_len = sizeof(header) + (found ? value_len : 0);
 
-    return value;
+    return 0;
 }
 
 jbyteArray
-Java_io_github_hse_1project_hse_Kvs_get__JLjava_lang_String_2IJ(
+Java_io_github_hse_1project_hse_Kvs_get__J_3BIIJ(
     JNIEnv *env,
     jobject kvs_obj,
     jlong kvs_handle,
-    jstring key,
+    jbyteArray key,
+    jint key_len,
     jint flags,
     jlong txn_handle)
 {
-    bool found;
-    hse_err_t err;
-    size_t value_len;
-    jsize key_len = 0;
-    jbyte *value_data;
-    jbyteArray value = NULL;
-    const char *key_data = NULL;
+    jbyteArray value;
+    const void *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
-
-    value_data = malloc(HSE_KVS_VALUE_LEN_MAX * sizeof(*value_data));
-    if (!value_data) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value buffer");
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
         return NULL;
-    }
 
-    err = hse_kvs_get(
-        kvs, flags, txn, key_data, key_len, &found, value_data, HSE_KVS_VALUE_LEN_MAX, &value_len);
+    value = get_value_array(env, kvs, flags, txn, key_data, key_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    key_array_release(env, key, key_data, key_buf);
 
-    if (err) {
-        throw_new_hse_exception(env, err);
-        goto out;
-    }
+    return value;
+}
 
-    if (!found)
-        goto out;
+jbyteArray
+Java_io_github_hse_1project_hse_Kvs_get__JLjava_lang_String_2IJ(
+    JNIEnv *env,
+    jobject kvs_obj,
+    jlong kvs_handle,
+    jstring key,
+    jint flags,
+    jlong txn_handle)
+{
+    jbyteArray value;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
-    value = (*env)->NewByteArray(env, value_len);
-    if (!value) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value byte array");
-        goto out;
-    }
+    (void)kvs_obj;
 
-    (*env)->SetByteArrayRegion(env, value, 0, value_len, value_data);
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return NULL;
 
-    /* Assert that no ArrayIndexOutOfBoundsException occurred. The byte array is
-     * constructed with a size of value_len, so the previous operation is
-     * infallible in theory.
-     */
-    assert(!(*env)->ExceptionCheck(env));
+    value = get_value_array(env, kvs, flags, txn, key_data, key_len);
 
-out:
-    free(value_data);
+    string_release(key_data, key_buf);
 
     return value;
 }
@@ -362,11 +439,6 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_nio_ByteBuffer_2IIIJ(
     jint flags,
     jlong txn_handle)
 {
-    hse_err_t err;
-    size_t value_len;
-    jbyte *value_data;
-    bool found = false;
-    jbyteArray value = NULL;
     const void *key_data = NULL;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
@@ -380,44 +452,7 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_nio_ByteBuffer_2IIIJ(
         key_data = (uint8_t *)key_data + key_pos;
     }
 
-    value_data = malloc(HSE_KVS_VALUE_LEN_MAX * sizeof(*value_data));
-    if (!value_data) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value buffer");
-        return NULL;
-    }
-
-    err = hse_kvs_get(
-        kvs, flags, txn, key_data, key_len, &found, value_data, HSE_KVS_VALUE_LEN_MAX, &value_len);
-    if (err) {
-        throw_new_hse_exception(env, err);
-        goto out;
-    }
-
-    if (!found)
-        goto out;
-
-    value = (*env)->NewByteArray(env, value_len);
-    if (!value) {
-        (*env)->ThrowNew(
-            env, globals.java.lang.OutOfMemoryError.class,
-            "Failed to allocate memory for value byte array");
-        goto out;
-    }
-
-    (*env)->SetByteArrayRegion(env, value, 0, value_len, value_data);
-
-    /* Assert that no ArrayIndexOutOfBoundsException occurred. The byte array is
-     * constructed with a size of value_len, so the previous operation is
-     * infallible in theory.
-     */
-    assert(!(*env)->ExceptionCheck(env));
-
-out:
-    free(value_data);
-
-    return value;
+    return get_value_array(env, kvs, flags, txn, key_data, key_len);
 }
 
 jint
@@ -435,30 +470,33 @@ Java_io_github_hse_1project_hse_Kvs_get__J_3BI_3BIIJ(
     hse_err_t err;
     size_t value_len;
     bool found = false;
-    jbyte *key_data = NULL;
-    jbyte *value_buf_data = NULL;
+    const void *key_data;
+    void *value_buf_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
-    if (value_buf)
-        value_buf_data = (*env)->GetByteArrayElements(env, value_buf, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return 0;
+
+    value_buf_data = out_array_acquire(env, value_buf, value_buf_sz);
+    if (value_buf && !value_buf_data) {
+        key_array_release(env, key, key_data, key_buf);
+        return 0;
+    }
 
     err = hse_kvs_get(
         kvs, flags, txn, key_data, key_len, &found, value_buf_data, value_buf_sz, &value_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
-    if (value_buf) {
-        /* In the case the key isn't found OR error, save a copy operation and
-         * ABORT.
-         */
-        (*env)->ReleaseByteArrayElements(
-            env, value_buf, value_buf_data, (!found || err) ? JNI_ABORT : 0);
-    }
+    /* In the case the key isn't found OR error, save a copy operation and
+     * ABORT.
+     */
+    out_array_release(
+        env, value_buf, value_buf_data, value_buf_sz, (!found || err) ? -1 : (jsize)value_len);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -496,15 +534,17 @@ Java_io_github_hse_1project_hse_Kvs_get__J_3BILjava_nio_ByteBuffer_2IIIJ(
     bool found;
     hse_err_t err;
     size_t value_len;
-    jbyte *key_data = NULL;
+    const void *key_data;
     void *value_buf_data = NULL;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return 0;
 
     if (value_buf) {
         value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
@@ -516,8 +556,7 @@ Java_io_github_hse_1project_hse_Kvs_get__J_3BILjava_nio_ByteBuffer_2IIIJ(
     err = hse_kvs_get(
         kvs, flags, txn, key_data, key_len, &found, value_buf_data, value_buf_sz, &value_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -553,35 +592,35 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_lang_String_2_3BIIJ(
     bool found;
     hse_err_t err;
     size_t value_len;
-    jsize key_len = 0;
-    const char *key_data = NULL;
-    jbyte *value_buf_data = NULL;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    void *value_buf_data;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return 0;
 
-    if (value_buf)
-        value_buf_data = (*env)->GetByteArrayElements(env, value_buf, NULL);
+    value_buf_data = out_array_acquire(env, value_buf, value_buf_sz);
+    if (value_buf && !value_buf_data) {
+        string_release(key_data, key_buf);
+        return 0;
+    }
 
     err = hse_kvs_get(
         kvs, flags, txn, key_data, key_len, &found, value_buf_data, value_buf_sz, &value_len);
 
-    if (value_buf) {
-        /* In the case the key isn't found OR error, save a copy operation and
-         * ABORT.
-         */
-        (*env)->ReleaseByteArrayElements(
-            env, value_buf, value_buf_data, (!found || err) ? JNI_ABORT : 0);
-    }
+    string_release(key_data, key_buf);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    /* In the case the key isn't found OR error, save a copy operation and
+     * ABORT.
+     */
+    out_array_release(
+        env, value_buf, value_buf_data, value_buf_sz, (!found || err) ? -1 : (jsize)value_len);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -618,18 +657,18 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_lang_String_2Ljava_nio_ByteBuffe
     bool found;
     hse_err_t err;
     size_t value_len;
-    jsize key_len = 0;
-    const char *key_data = NULL;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     void *value_buf_data = NULL;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return 0;
 
     if (value_buf) {
         value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
@@ -641,8 +680,7 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_lang_String_2Ljava_nio_ByteBuffe
     err = hse_kvs_get(
         kvs, flags, txn, key_data, key_len, &found, value_buf_data, value_buf_sz, &value_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -681,7 +719,7 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_nio_ByteBuffer_2II_3BIIJ(
     hse_err_t err;
     size_t value_len;
     const void *key_data = NULL;
-    jbyte *value_buf_data = NULL;
+    void *value_buf_data;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
@@ -694,19 +732,18 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_nio_ByteBuffer_2II_3BIIJ(
         key_data = (uint8_t *)key_data + key_pos;
     }
 
-    if (value_buf)
-        value_buf_data = (*env)->GetByteArrayElements(env, value_buf, NULL);
+    value_buf_data = out_array_acquire(env, value_buf, value_buf_sz);
+    if (value_buf && !value_buf_data)
+        return 0;
 
     err = hse_kvs_get(
         kvs, flags, txn, key_data, key_len, &found, value_buf_data, value_buf_sz, &value_len);
 
-    if (value_buf) {
-        /* In the case the key isn't found OR error, save a copy operation and
-         * ABORT.
-         */
-        (*env)->ReleaseByteArrayElements(
-            env, value_buf, value_buf_data, (!found || err) ? JNI_ABORT : 0);
-    }
+    /* In the case the key isn't found OR error, save a copy operation and
+     * ABORT.
+     */
+    out_array_release(
+        env, value_buf, value_buf_data, value_buf_sz, (!found || err) ? -1 : (jsize)value_len);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -788,6 +825,202 @@ Java_io_github_hse_1project_hse_Kvs_get__JLjava_nio_ByteBuffer_2IILjava_nio_Byte
     return (value_len << 1 | 0x1);
 }
 
+jobject
+Java_io_github_hse_1project_hse_Kvs_getAsync(
+    JNIEnv *env,
+    jobject kvs_obj,
+    jlong kvs_handle,
+    jbyteArray key,
+    jint key_len,
+    jint flags,
+    jlong txn_handle)
+{
+    struct async_op *op;
+
+    (void)kvs_obj;
+
+    op = async_op_alloc(env, ASYNC_OP_GET, key_len);
+    if (!op)
+        return NULL;
+
+    op->flags = flags;
+    op->kvs = (struct hse_kvs *)kvs_handle;
+    op->txn = (struct hse_kvdb_txn *)txn_handle;
+    op->key = key ? op->data : NULL;
+    op->key_len = key_len;
+    op->value = NULL;
+    op->value_len = 0;
+
+    if (key) {
+        (*env)->GetByteArrayRegion(env, key, 0, key_len, (jbyte *)op->data);
+        if ((*env)->ExceptionCheck(env)) {
+            async_op_free(env, op);
+            return NULL;
+        }
+    }
+
+    return async_submit(env, op, false);
+}
+
+jlong
+Java_io_github_hse_1project_hse_Kvs_getBatch__J_3_3BLjava_nio_ByteBuffer_2IIIJ(
+    JNIEnv *env,
+    jobject kvs_obj,
+    jlong kvs_handle,
+    jobjectArray keys,
+    jobject value_buf,
+    jint value_buf_sz,
+    jint value_buf_pos,
+    jint flags,
+    jlong txn_handle)
+{
+    jsize i;
+    size_t used = 0;
+    jsize keys_len = 0;
+    uint8_t *value_buf_data = NULL;
+    struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    (void)kvs_obj;
+
+    if (keys)
+        keys_len = (*env)->GetArrayLength(env, keys);
+
+    if (value_buf) {
+        value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
+
+        // Move the start address based on the position
+        value_buf_data += value_buf_pos;
+    }
+
+    for (i = 0; i < keys_len; i++) {
+        hse_err_t err;
+        void *key_data;
+        size_t record_len;
+        size_t key_buf_sz;
+        jsize key_len = 0;
+        jbyteArray key;
+
+        key = (*env)->GetObjectArrayElement(env, keys, i);
+        if (key)
+            key_len = (*env)->GetArrayLength(env, key);
+
+        /* Copy the key into the scratch buffer rather than pinning each
+         * array.
+         */
+        key_data = scratch_reserve(key_len, &key_buf_sz);
+        if (!key_data) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for key buffer");
+            return 0;
+        }
+
+        if (key) {
+            (*env)->GetByteArrayRegion(env, key, 0, key_len, key_data);
+            (*env)->DeleteLocalRef(env, key);
+        }
+
+        err = get_batch_record(
+            kvs, flags, txn, key ? key_data : NULL, key_len, value_buf_data + used,
+            value_buf_sz - used, &record_len);
+        if (err) {
+            throw_new_hse_exception(env, err);
+            return 0;
+        }
+
+        if (record_len == 0)
+            break;
+
+        used += record_len;
+    }
+
+    /* Pack the number of bytes written into the upper half and the number of
+     * keys resolved into the lower half.
+     */
+    return (jlong)used << 32 | (uint32_t)i;
+}
+
+jlong
+Java_io_github_hse_1project_hse_Kvs_getBatch__JLjava_nio_ByteBuffer_2IILjava_nio_ByteBuffer_2IIIJ(
+    JNIEnv *env,
+    jobject kvs_obj,
+    jlong kvs_handle,
+    jobject keys,
+    jint keys_len,
+    jint keys_pos,
+    jobject value_buf,
+    jint value_buf_sz,
+    jint value_buf_pos,
+    jint flags,
+    jlong txn_handle)
+{
+    size_t used = 0;
+    size_t offset = 0;
+    uint32_t count = 0;
+    const uint8_t *keys_data = NULL;
+    uint8_t *value_buf_data = NULL;
+    struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    (void)kvs_obj;
+
+    if (keys) {
+        keys_data = (*env)->GetDirectBufferAddress(env, keys);
+
+        // Move the start address based on the position
+        keys_data += keys_pos;
+    }
+
+    if (value_buf) {
+        value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
+
+        // Move the start address based on the position
+        value_buf_data += value_buf_pos;
+    }
+
+    while (offset < (size_t)keys_len) {
+        hse_err_t err;
+        int32_t key_len;
+        size_t record_len;
+
+        if (keys_len - offset < sizeof(key_len)) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.IllegalArgumentException.class,
+                "Truncated key length in key buffer");
+            return 0;
+        }
+
+        memcpy(&key_len, keys_data + offset, sizeof(key_len));
+        if (key_len < 0 || (size_t)key_len > keys_len - offset - sizeof(key_len)) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.IllegalArgumentException.class,
+                "Key length exceeds the bounds of the key buffer");
+            return 0;
+        }
+
+        err = get_batch_record(
+            kvs, flags, txn, keys_data + offset + sizeof(key_len), key_len,
+            value_buf_data + used, value_buf_sz - used, &record_len);
+        if (err) {
+            throw_new_hse_exception(env, err);
+            return 0;
+        }
+
+        if (record_len == 0)
+            break;
+
+        offset += sizeof(key_len) + key_len;
+        used += record_len;
+        count++;
+    }
+
+    /* Pack the number of bytes written into the upper half and the number of
+     * keys resolved into the lower half.
+     */
+    return (jlong)used << 32 | count;
+}
+
 jstring
 Java_io_github_hse_1project_hse_Kvs_getName(JNIEnv *env, jobject kvs_obj, jlong kvs_handle)
 {
@@ -865,19 +1098,20 @@ Java_io_github_hse_1project_hse_Kvs_prefixDelete__J_3BIIJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jbyte *pfx_data = NULL;
+    const void *pfx_data;
+    uint8_t pfx_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (pfx)
-        pfx_data = (*env)->GetByteArrayElements(env, pfx, NULL);
+    pfx_data = key_array_acquire(env, pfx, pfx_len, pfx_buf);
+    if (pfx && !pfx_data)
+        return;
 
     err = hse_kvs_prefix_delete(kvs, flags, txn, pfx_data, pfx_len);
 
-    if (pfx)
-        (*env)->ReleaseByteArrayElements(env, pfx, pfx_data, JNI_ABORT);
+    key_array_release(env, pfx, pfx_data, pfx_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -893,22 +1127,21 @@ Java_io_github_hse_1project_hse_Kvs_prefixDelete__JLjava_lang_String_2IJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize pfx_len = 0;
-    const char *pfx_data = NULL;
+    size_t pfx_len;
+    const char *pfx_data;
+    uint8_t pfx_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (pfx) {
-        pfx_data = (*env)->GetStringUTFChars(env, pfx, NULL);
-        pfx_len = (*env)->GetStringUTFLength(env, pfx);
-    }
+    pfx_data = string_acquire(env, pfx, pfx_buf, sizeof(pfx_buf), &pfx_len);
+    if (pfx && !pfx_data)
+        return;
 
     err = hse_kvs_prefix_delete(kvs, flags, txn, pfx_data, pfx_len);
 
-    if (pfx)
-        (*env)->ReleaseStringUTFChars(env, pfx, pfx_data);
+    string_release(pfx_data, pfx_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -960,22 +1193,25 @@ Java_io_github_hse_1project_hse_Kvs_put__J_3BI_3BIIJ(
     hse_err_t err;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
-    jbyte *key_data = NULL;
-    jbyte *value_data = NULL;
+    const void *key_data;
+    const void *value_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
-    if (value)
-        value_data = (*env)->GetByteArrayElements(env, value, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return;
+
+    value_data = value_array_acquire(env, value, value_len);
+    if (value && !value_data) {
+        key_array_release(env, key, key_data, key_buf);
+        return;
+    }
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
-    if (value)
-        (*env)->ReleaseByteArrayElements(env, value, value_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -993,28 +1229,29 @@ Java_io_github_hse_1project_hse_Kvs_put__J_3BILjava_lang_String_2IJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize value_len = 0;
-    jbyte *key_data = NULL;
-    const char *value_data = NULL;
+    size_t value_len;
+    const void *key_data;
+    const char *value_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return;
 
-    if (value) {
-        value_data = (*env)->GetStringUTFChars(env, value, NULL);
-        value_len = (*env)->GetStringUTFLength(env, value);
+    value_data = string_acquire(env, value, NULL, 0, &value_len);
+    if (value && !value_data) {
+        key_array_release(env, key, key_data, key_buf);
+        return;
     }
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
-    if (value)
-        (*env)->ReleaseStringUTFChars(env, value, value_data);
+    string_release(value_data, NULL);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -1034,15 +1271,17 @@ Java_io_github_hse_1project_hse_Kvs_put__J_3BILjava_nio_ByteBuffer_2IIIJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jbyte *key_data = NULL;
+    const void *key_data;
     const void *value_data = NULL;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return;
 
     if (value) {
         value_data = (*env)->GetDirectBufferAddress(env, value);
@@ -1053,8 +1292,7 @@ Java_io_github_hse_1project_hse_Kvs_put__J_3BILjava_nio_ByteBuffer_2IIIJ(
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -1072,28 +1310,28 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_lang_String_2_3BIIJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize key_len = 0;
-    const char *key_data = NULL;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
-    jbyte *value_data = NULL;
+    const void *value_data;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return;
 
-    if (value)
-        value_data = (*env)->GetByteArrayElements(env, value, NULL);
+    value_data = value_array_acquire(env, value, value_len);
+    if (value && !value_data) {
+        string_release(key_data, key_buf);
+        return;
+    }
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
-    if (value)
-        (*env)->ReleaseByteArrayElements(env, value, value_data, JNI_ABORT);
+    string_release(key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -1110,31 +1348,30 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_lang_String_2Ljava_lang_String_2
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize key_len = 0;
-    jsize value_len = 0;
-    const char *key_data = NULL;
-    const char *value_data = NULL;
+    size_t key_len;
+    size_t value_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *value_data;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return;
 
-    if (value) {
-        value_data = (*env)->GetStringUTFChars(env, value, NULL);
-        value_len = (*env)->GetStringUTFLength(env, value);
+    value_data = string_acquire(env, value, NULL, 0, &value_len);
+    if (value && !value_data) {
+        string_release(key_data, key_buf);
+        return;
     }
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
-    if (value)
-        (*env)->ReleaseStringUTFChars(env, value, value_data);
+    string_release(value_data, NULL);
+    string_release(key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -1153,18 +1390,18 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_lang_String_2Ljava_nio_ByteBuffe
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize key_len = 0;
-    const char *key_data = NULL;
+    size_t key_len;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     const void *value_data = NULL;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)kvs_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return;
 
     if (value) {
         value_data = (*env)->GetDirectBufferAddress(env, value);
@@ -1175,8 +1412,7 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_lang_String_2Ljava_nio_ByteBuffe
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err)
         throw_new_hse_exception(env, err);
@@ -1196,7 +1432,7 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_nio_ByteBuffer_2II_3BIIJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jbyte *value_data = NULL;
+    const void *value_data;
     const void *key_data = NULL;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
@@ -1210,14 +1446,12 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_nio_ByteBuffer_2II_3BIIJ(
         key_data = (uint8_t *)key_data + key_pos;
     }
 
-    if (value)
-        value_data = (*env)->GetByteArrayElements(env, value, NULL);
+    value_data = value_array_acquire(env, value, value_len);
+    if (value && !value_data)
+        return;
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
 
-    if (value)
-        (*env)->ReleaseByteArrayElements(env, value, value_data, JNI_ABORT);
-
     if (err)
         throw_new_hse_exception(env, err);
 }
@@ -1235,9 +1469,9 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_nio_ByteBuffer_2IILjava_lang_Str
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize value_len = 0;
+    size_t value_len;
     const void *key_data = NULL;
-    const char *value_data = NULL;
+    const char *value_data;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
@@ -1250,12 +1484,14 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_nio_ByteBuffer_2IILjava_lang_Str
         key_data = (uint8_t *)key_data + key_pos;
     }
 
-    if (value) {
-        value_data = (*env)->GetStringUTFChars(env, value, NULL);
-        value_len = (*env)->GetStringUTFLength(env, value);
-    }
+    value_data = string_acquire(env, value, NULL, 0, &value_len);
+    if (value && !value_data)
+        return;
 
     err = hse_kvs_put(kvs, flags, txn, key_data, key_len, value_data, value_len);
+
+    string_release(value_data, NULL);
+
     if (err)
         throw_new_hse_exception(env, err);
 }
@@ -1300,3 +1536,46 @@ Java_io_github_hse_1project_hse_Kvs_put__JLjava_nio_ByteBuffer_2IILjava_nio_Byte
     if (err)
         throw_new_hse_exception(env, err);
 }
+
+jobject
+Java_io_github_hse_1project_hse_Kvs_putAsync(
+    JNIEnv *env,
+    jobject kvs_obj,
+    jlong kvs_handle,
+    jbyteArray key,
+    jint key_len,
+    jbyteArray value,
+    jint value_len,
+    jint flags,
+    jlong txn_handle)
+{
+    struct async_op *op;
+
+    (void)kvs_obj;
+
+    op = async_op_alloc(env, ASYNC_OP_PUT, (size_t)key_len + value_len);
+    if (!op)
+        return NULL;
+
+    op->flags = flags;
+    op->kvs = (struct hse_kvs *)kvs_handle;
+    op->txn = (struct hse_kvdb_txn *)txn_handle;
+    op->key = key ? op->data : NULL;
+    op->key_len = key_len;
+    op->value = value ? op->data + key_len : NULL;
+    op->value_len = value_len;
+
+    if (key)
+        (*env)->GetByteArrayRegion(env, key, 0, key_len, (jbyte *)op->data);
+    if (value && !(*env)->ExceptionCheck(env))
+        (*env)->GetByteArrayRegion(env, value, 0, value_len, (jbyte *)op->data + key_len);
+    if ((*env)->ExceptionCheck(env)) {
+        async_op_free(env, op);
+        return NULL;
+    }
+
+    /* Priority puts bypass throttling within HSE, so let them skip ahead of
+     * queued operations too.
+     */
+    return async_submit(env, op, flags & HSE_KVS_PUT_PRIO);
+}
@@ -5,16 +5,170 @@
 
 #include <assert.h>
 #include <jni.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <sys/param.h>
 
 #include <hse/hse.h>
 
+#include "async.h"
 #include "hsejni.h"
 #include "io_github_hse_project_hse_KvsCursor.h"
 
+/* Native side of a KvsCursor, whose address is the handle held by Java.
+ *
+ * read_batch() only learns that a record does not fit in the caller's buffer
+ * after HSE has consumed it. Seeking back onto it would cost a seek per batch
+ * and drop the bound of a seekRange(), so the record is copied here instead,
+ * and returned by whichever read comes next. Repositioning the cursor discards
+ * it.
+ */
+struct cursor {
+    struct hse_kvs_cursor *cursor;
+    bool pending;
+    size_t pending_key_len;
+    size_t pending_value_len;
+    size_t pending_buf_sz;
+    /* Key, followed by value. */
+    void *pending_buf;
+};
+
+static jlong
+cursor_wrap(JNIEnv *env, struct hse_kvs_cursor *hse_cursor)
+{
+    struct cursor *cursor;
+
+    cursor = calloc(1, sizeof(*cursor));
+    if (!cursor) {
+        hse_kvs_cursor_destroy(hse_cursor);
+        (*env)->ThrowNew(
+            env, globals.java.lang.OutOfMemoryError.class, "Failed to allocate memory for cursor");
+        return 0;
+    }
+
+    cursor->cursor = hse_cursor;
+
+    return (jlong)cursor;
+}
+
+/* Returns the HSE cursor for an operation which moves it, after discarding any
+ * pending record.
+ */
+static struct hse_kvs_cursor *
+cursor_reposition(jlong cursor_handle)
+{
+    struct cursor *cursor = (struct cursor *)cursor_handle;
+
+    cursor->pending = false;
+
+    return cursor->cursor;
+}
+
+/* Like hse_kvs_cursor_read(), but returns the pending record first. */
+static hse_err_t
+cursor_read(
+    struct cursor *cursor,
+    unsigned int flags,
+    const void **key,
+    size_t *key_len,
+    const void **value,
+    size_t *value_len,
+    bool *eof)
+{
+    if (!cursor->pending)
+        return hse_kvs_cursor_read(cursor->cursor, flags, key, key_len, value, value_len, eof);
+
+    cursor->pending = false;
+    *key = cursor->pending_buf;
+    *key_len = cursor->pending_key_len;
+    *value = (char *)cursor->pending_buf + cursor->pending_key_len;
+    *value_len = cursor->pending_value_len;
+    *eof = false;
+
+    return 0;
+}
+
+/* Like hse_kvs_cursor_read_copy(), but returns the pending record first. */
+static hse_err_t
+cursor_read_copy(
+    struct cursor *cursor,
+    unsigned int flags,
+    void *key_buf,
+    size_t key_buf_sz,
+    size_t *key_len,
+    void *value_buf,
+    size_t value_buf_sz,
+    size_t *value_len,
+    bool *eof)
+{
+    hse_err_t err;
+    const void *key;
+    const void *value;
+
+    if (!cursor->pending)
+        return hse_kvs_cursor_read_copy(
+            cursor->cursor, flags, key_buf, key_buf_sz, key_len, value_buf, value_buf_sz,
+            value_len, eof);
+
+    err = cursor_read(cursor, flags, &key, key_len, &value, value_len, eof);
+    assert(!err);
+
+    if (key_buf)
+        memcpy(key_buf, key, MIN(key_buf_sz, *key_len));
+    if (value_buf)
+        memcpy(value_buf, value, MIN(value_buf_sz, *value_len));
+
+    return err;
+}
+
+/* Keeps a consumed record for the next read. Returns false with a pending
+ * exception if it could not be copied.
+ */
+static bool
+cursor_unread(
+    JNIEnv *env,
+    struct cursor *cursor,
+    const void *key,
+    size_t key_len,
+    const void *value,
+    size_t value_len)
+{
+    const size_t needed = key_len + value_len;
+
+    // The record may be the pending one, in which case it is already in place.
+    if (key == cursor->pending_buf) {
+        cursor->pending = true;
+        return true;
+    }
+
+    if (needed > cursor->pending_buf_sz) {
+        void *buf;
+
+        buf = malloc(needed);
+        if (!buf) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.OutOfMemoryError.class,
+                "Failed to allocate memory for pending record");
+            return false;
+        }
+
+        free(cursor->pending_buf);
+        cursor->pending_buf = buf;
+        cursor->pending_buf_sz = needed;
+    }
+
+    memcpy(cursor->pending_buf, key, key_len);
+    memcpy((char *)cursor->pending_buf + key_len, value, value_len);
+    cursor->pending_key_len = key_len;
+    cursor->pending_value_len = value_len;
+    cursor->pending = true;
+
+    return true;
+}
+
 jlong
 Java_io_github_hse_1project_hse_KvsCursor_create__J_3BIIJ(
     JNIEnv *env,
@@ -29,22 +183,25 @@ Java_io_github_hse_1project_hse_KvsCursor_create__J_3BIIJ(
     struct hse_kvs_cursor *cursor;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
-    jbyte *filter_data = NULL;
+    const void *filter_data;
+    uint8_t filter_buf[HSE_KVS_KEY_LEN_MAX];
 
     (void)cursor_cls;
 
-    if (filter)
-        filter_data = (*env)->GetByteArrayElements(env, filter, NULL);
+    filter_data = key_array_acquire(env, filter, filter_len, filter_buf);
+    if (filter && !filter_data)
+        return 0;
 
     err = hse_kvs_cursor_create(kvs, flags, txn, filter_data, filter_len, &cursor);
 
-    if (filter)
-        (*env)->ReleaseByteArrayElements(env, filter, filter_data, JNI_ABORT);
+    key_array_release(env, filter, filter_data, filter_buf);
 
-    if (err)
+    if (err) {
         throw_new_hse_exception(env, err);
+        return 0;
+    }
 
-    return (jlong)cursor;
+    return cursor_wrap(env, cursor);
 }
 
 jlong
@@ -57,28 +214,29 @@ Java_io_github_hse_1project_hse_KvsCursor_create__JLjava_lang_String_2IJ(
     jlong txn_handle)
 {
     hse_err_t err;
-    jsize filter_len = 0;
-    const char *filter_data = NULL;
+    size_t filter_len;
+    const char *filter_data;
+    uint8_t filter_buf[HSE_KVS_KEY_LEN_MAX];
     struct hse_kvs_cursor *cursor = NULL;
     struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
     struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
 
     (void)cursor_cls;
 
-    if (filter) {
-        filter_data = (*env)->GetStringUTFChars(env, filter, NULL);
-        filter_len = (*env)->GetStringUTFLength(env, filter);
-    }
+    filter_data = string_acquire(env, filter, filter_buf, sizeof(filter_buf), &filter_len);
+    if (filter && !filter_data)
+        return 0;
 
     err = hse_kvs_cursor_create(kvs, flags, txn, filter_data, filter_len, &cursor);
 
-    if (filter)
-        (*env)->ReleaseStringUTFChars(env, filter, filter_data);
+    string_release(filter_data, filter_buf);
 
-    if (err)
+    if (err) {
         throw_new_hse_exception(env, err);
+        return 0;
+    }
 
-    return (jlong)cursor;
+    return cursor_wrap(env, cursor);
 }
 
 jlong
@@ -108,10 +266,12 @@ Java_io_github_hse_1project_hse_KvsCursor_create__JLjava_nio_ByteBuffer_2IIIJ(
     }
 
     err = hse_kvs_cursor_create(kvs, flags, txn, filter_data, filter_len, &cursor);
-    if (err)
+    if (err) {
         throw_new_hse_exception(env, err);
+        return 0;
+    }
 
-    return (jlong)cursor;
+    return cursor_wrap(env, cursor);
 }
 
 void
@@ -121,11 +281,15 @@ Java_io_github_hse_1project_hse_KvsCursor_destroy(
     jlong cursor_handle)
 {
     hse_err_t err;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
-    err = hse_kvs_cursor_destroy(cursor);
+    async_drain(env, cursor);
+
+    err = hse_kvs_cursor_destroy(cursor->cursor);
+    free(cursor->pending_buf);
+    free(cursor);
     if (err)
         throw_new_hse_exception(env, err);
 }
@@ -145,11 +309,11 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JI(
     const void *value;
     jbyteArray key_array;
     jbyteArray value_array;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
-    err = hse_kvs_cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+    err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
     if (err) {
         throw_new_hse_exception(env, err);
         return NULL;
@@ -207,26 +371,23 @@ Java_io_github_hse_1project_hse_KvsCursor_read__J_3BI_3BII(
     bool eof;
     jobject key_len_obj;
     jobject value_len_obj;
-    jbyte *key_buf_data = NULL;
-    jbyte *value_buf_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const void *key;
+    const void *value;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
-    if (key_buf)
-        key_buf_data = (*env)->GetByteArrayElements(env, key_buf, NULL);
-    if (value_buf)
-        value_buf_data = (*env)->GetByteArrayElements(env, value_buf, NULL);
-
-    err = hse_kvs_cursor_read_copy(
-        cursor, flags, key_buf_data, key_buf_sz, &key_len, value_buf_data, value_buf_sz, &value_len,
-        &eof);
-
-    if (key_buf)
-        (*env)->ReleaseByteArrayElements(env, key_buf, key_buf_data, (eof || err) ? JNI_ABORT : 0);
-    if (value_buf)
-        (*env)->ReleaseByteArrayElements(
-            env, value_buf, value_buf_data, (eof || err) ? JNI_ABORT : 0);
+    /* Read in place and copy only what fits, rather than having the JVM copy
+     * both arrays in and back out around cursor_read_copy().
+     */
+    err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+    if (!err && !eof) {
+        if (key_buf)
+            (*env)->SetByteArrayRegion(env, key_buf, 0, MIN((size_t)key_buf_sz, key_len), key);
+        if (value_buf)
+            (*env)->SetByteArrayRegion(
+                env, value_buf, 0, MIN((size_t)value_buf_sz, value_len), value);
+    }
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -266,14 +427,13 @@ Java_io_github_hse_1project_hse_KvsCursor_read__J_3BILjava_nio_ByteBuffer_2III(
     bool eof;
     jobject key_len_obj;
     jobject value_len_obj;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
-    jbyte *key_buf_data = NULL;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
+    const void *key;
+    const void *value;
     void *value_buf_data = NULL;
 
     (void)cursor_obj;
 
-    if (key_buf)
-        key_buf_data = (*env)->GetByteArrayElements(env, key_buf, NULL);
     if (value_buf) {
         value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
 
@@ -281,12 +441,13 @@ Java_io_github_hse_1project_hse_KvsCursor_read__J_3BILjava_nio_ByteBuffer_2III(
         value_buf_data = (uint8_t *)value_buf_data + value_buf_pos;
     }
 
-    err = hse_kvs_cursor_read_copy(
-        cursor, flags, key_buf_data, key_buf_sz, &key_len, value_buf_data, value_buf_sz, &value_len,
-        &eof);
-
-    if (key_buf)
-        (*env)->ReleaseByteArrayElements(env, key_buf, key_buf_data, (eof || err) ? JNI_ABORT : 0);
+    err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+    if (!err && !eof) {
+        if (key_buf)
+            (*env)->SetByteArrayRegion(env, key_buf, 0, MIN((size_t)key_buf_sz, key_len), key);
+        if (value_buf_data)
+            memcpy(value_buf_data, value, MIN((size_t)value_buf_sz, value_len));
+    }
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -326,9 +487,10 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JLjava_nio_ByteBuffer_2II_3BII(
     bool eof;
     jobject key_len_obj;
     jobject value_len_obj;
+    const void *key;
+    const void *value;
     void *key_buf_data = NULL;
-    jbyte *value_buf_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
@@ -339,16 +501,14 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JLjava_nio_ByteBuffer_2II_3BII(
         key_buf_data = (uint8_t *)key_buf_data + key_buf_pos;
     }
 
-    if (value_buf)
-        value_buf_data = (*env)->GetByteArrayElements(env, value_buf, NULL);
-
-    err = hse_kvs_cursor_read_copy(
-        cursor, flags, key_buf_data, key_buf_sz, &key_len, value_buf_data, value_buf_sz, &value_len,
-        &eof);
-
-    if (value_buf)
-        (*env)->ReleaseByteArrayElements(
-            env, value_buf, value_buf_data, (eof || err) ? JNI_ABORT : 0);
+    err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+    if (!err && !eof) {
+        if (key_buf_data)
+            memcpy(key_buf_data, key, MIN((size_t)key_buf_sz, key_len));
+        if (value_buf)
+            (*env)->SetByteArrayRegion(
+                env, value_buf, 0, MIN((size_t)value_buf_sz, value_len), value);
+    }
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -391,7 +551,7 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JLjava_nio_ByteBuffer_2IILjava_n
     jobject value_len_obj;
     void *key_buf_data = NULL;
     void *value_buf_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
@@ -409,7 +569,7 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JLjava_nio_ByteBuffer_2IILjava_n
         value_buf_data = (uint8_t *)value_buf_data + value_buf_pos;
     }
 
-    err = hse_kvs_cursor_read_copy(
+    err = cursor_read_copy(
         cursor, flags, key_buf_data, key_buf_sz, &key_len, value_buf_data, value_buf_sz, &value_len,
         &eof);
     if (err) {
@@ -432,6 +592,221 @@ Java_io_github_hse_1project_hse_KvsCursor_read__JLjava_nio_ByteBuffer_2IILjava_n
         globals.java.util.AbstractMap.SimpleImmutableEntry.init, key_len_obj, value_len_obj);
 }
 
+#define READ_BATCH_EOF (-1)
+
+jlong
+read_batch(
+    JNIEnv *env,
+    struct cursor *cursor,
+    void *buf,
+    size_t buf_sz,
+    jint max_records,
+    unsigned int flags)
+{
+    bool eof = false;
+    hse_err_t err;
+    jint count = 0;
+    size_t used = 0;
+    uint8_t *buf_data = buf;
+
+    while (count < max_records) {
+        size_t key_len;
+        const void *key;
+        size_t value_len;
+        const void *value;
+        int32_t header[2];
+
+        err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+        if (err) {
+            throw_new_hse_exception(env, err);
+            return 0;
+        }
+
+        if (eof)
+            break;
+
+        if (sizeof(header) + key_len + value_len > buf_sz - used) {
+            // The record has already been consumed, so keep it for the next read.
+            if (!cursor_unread(env, cursor, key, key_len, value, value_len))
+                return 0;
+
+            break;
+        }
+
+        header[0] = (int32_t)key_len;
+        header[1] = (int32_t)value_len;
+        memcpy(buf_data + used, header, sizeof(header));
+        used += sizeof(header);
+        memcpy(buf_data + used, key, key_len);
+        used += key_len;
+        memcpy(buf_data + used, value, value_len);
+        used += value_len;
+
+        count++;
+    }
+
+    if (eof && count == 0)
+        count = READ_BATCH_EOF;
+
+    return (jlong)used << 32 | (uint32_t)count;
+}
+
+jlong
+Java_io_github_hse_1project_hse_KvsCursor_readBatch(
+    JNIEnv *env,
+    jobject cursor_obj,
+    jlong cursor_handle,
+    jobject buf,
+    jint buf_sz,
+    jint buf_pos,
+    jint max_records,
+    jint flags)
+{
+    uint8_t *buf_data;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
+
+    (void)cursor_obj;
+
+    buf_data = (*env)->GetDirectBufferAddress(env, buf);
+
+    // Move the start address based on the position
+    buf_data += buf_pos;
+
+    return read_batch(env, cursor, buf_data, buf_sz, max_records, flags);
+}
+
+jobject
+Java_io_github_hse_1project_hse_KvsCursor_readBatchAsync(
+    JNIEnv *env,
+    jobject cursor_obj,
+    jlong cursor_handle,
+    jobject buf,
+    jint buf_sz,
+    jint buf_pos,
+    jint max_records,
+    jint flags)
+{
+    struct async_op *op;
+
+    (void)cursor_obj;
+
+    op = async_op_alloc(env, ASYNC_OP_READ_BATCH, 0);
+    if (!op)
+        return NULL;
+
+    op->flags = flags;
+    op->cursor = (struct cursor *)cursor_handle;
+    op->txn = NULL;
+    op->buf = (uint8_t *)(*env)->GetDirectBufferAddress(env, buf) + buf_pos;
+    op->buf_sz = buf_sz;
+    op->max_records = max_records;
+
+    return async_submit(env, op, false);
+}
+
+#define READ_COPY_EOF (-1)
+
+jlong
+Java_io_github_hse_1project_hse_KvsCursor_readCopy(
+    JNIEnv *env,
+    jobject cursor_obj,
+    jlong cursor_handle,
+    jobject key_buf,
+    jint key_buf_sz,
+    jobject value_buf,
+    jint value_buf_sz,
+    jint flags)
+{
+    bool eof;
+    hse_err_t err;
+    size_t key_len;
+    size_t value_len;
+    void *key_buf_data;
+    void *value_buf_data;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
+
+    (void)cursor_obj;
+
+    key_buf_data = (*env)->GetDirectBufferAddress(env, key_buf);
+    value_buf_data = (*env)->GetDirectBufferAddress(env, value_buf);
+
+    err = cursor_read_copy(
+        cursor, flags, key_buf_data, key_buf_sz, &key_len, value_buf_data, value_buf_sz, &value_len,
+        &eof);
+    if (err) {
+        throw_new_hse_exception(env, err);
+        return 0;
+    }
+
+    if (eof)
+        return READ_COPY_EOF;
+
+    return (jlong)key_len << 32 | (uint32_t)value_len;
+}
+
+/* Wraps memory owned by HSE in a read-only direct buffer. */
+static jobject
+new_read_only_view(JNIEnv *env, const void *data, size_t len)
+{
+    jobject buf;
+
+    buf = (*env)->NewDirectByteBuffer(env, (void *)data, len);
+    if (!buf) {
+        if (!(*env)->ExceptionCheck(env))
+            (*env)->ThrowNew(
+                env, globals.java.lang.UnsupportedOperationException.class,
+                "JVM does not support direct buffers");
+        return NULL;
+    }
+
+    return (*env)->CallObjectMethod(env, buf, globals.java.nio.ByteBuffer.asReadOnlyBuffer);
+}
+
+jboolean
+Java_io_github_hse_1project_hse_KvsCursor_readView(
+    JNIEnv *env,
+    jobject cursor_obj,
+    jlong cursor_handle,
+    jobject view_obj,
+    jint flags)
+{
+    bool eof;
+    hse_err_t err;
+    size_t key_len;
+    const void *key;
+    size_t value_len;
+    const void *value;
+    jobject key_view;
+    jobject value_view;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
+
+    (void)cursor_obj;
+
+    err = cursor_read(cursor, flags, &key, &key_len, &value, &value_len, &eof);
+    if (err) {
+        throw_new_hse_exception(env, err);
+        return JNI_FALSE;
+    }
+
+    if (eof)
+        return JNI_FALSE;
+
+    key_view = new_read_only_view(env, key, key_len);
+    if (!key_view)
+        return JNI_FALSE;
+
+    value_view = new_read_only_view(env, value, value_len);
+    if (!value_view)
+        return JNI_FALSE;
+
+    (*env)->SetObjectField(
+        env, view_obj, globals.io.github.hse_project.hse.KvsCursor.View.key, key_view);
+    (*env)->SetObjectField(
+        env, view_obj, globals.io.github.hse_project.hse.KvsCursor.View.value, value_view);
+
+    return JNI_TRUE;
+}
+
 jbyteArray
 Java_io_github_hse_1project_hse_KvsCursor_seek__J_3BII(
     JNIEnv *env,
@@ -445,18 +820,19 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__J_3BII(
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jbyte *key_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const void *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return NULL;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -487,24 +863,23 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_lang_String_2I(
     jint flags)
 {
     hse_err_t err;
-    const char *key_data = NULL;
-    jsize key_len = 0;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    size_t key_len;
     const void *found = NULL;
     size_t found_len = 0;
     jbyteArray found_key;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return NULL;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -541,7 +916,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_nio_ByteBuffer_2III(
     const void *found = NULL;
     size_t found_len = 0;
     jbyteArray found_key;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -586,19 +961,20 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__J_3BI_3BII(
 {
     hse_err_t err;
     size_t found_len = 0;
-    jbyte *key_data = NULL;
+    const void *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     const void *found = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return 0;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -636,19 +1012,20 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__J_3BILjava_nio_ByteBuffer_2III(
 {
     hse_err_t err;
     size_t found_len = 0;
-    jbyte *key_data = NULL;
+    const void *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
     const void *found = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key)
-        key_data = (*env)->GetByteArrayElements(env, key, NULL);
+    key_data = key_array_acquire(env, key, key_len, key_buf);
+    if (key && !key_data)
+        return 0;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseByteArrayElements(env, key, key_data, JNI_ABORT);
+    key_array_release(env, key, key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -681,23 +1058,22 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_lang_String_2_3BII(
     jint flags)
 {
     hse_err_t err;
-    jsize key_len = 0;
+    size_t key_len;
     size_t found_len = 0;
     const void *found = NULL;
-    const char *key_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return 0;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -727,23 +1103,22 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_lang_String_2Ljava_nio_By
     jint flags)
 {
     hse_err_t err;
-    jsize key_len = 0;
+    size_t key_len;
     size_t found_len = 0;
     const void *found = NULL;
-    const char *key_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *key_data;
+    uint8_t key_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (key) {
-        key_data = (*env)->GetStringUTFChars(env, key, NULL);
-        key_len = (*env)->GetStringUTFLength(env, key);
-    }
+    key_data = string_acquire(env, key, key_buf, sizeof(key_buf), &key_len);
+    if (key && !key_data)
+        return 0;
 
     err = hse_kvs_cursor_seek(cursor, flags, key_data, key_len, &found, &found_len);
 
-    if (key)
-        (*env)->ReleaseStringUTFChars(env, key, key_data);
+    string_release(key_data, key_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -782,7 +1157,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_nio_ByteBuffer_2II_3BII(
     size_t found_len = 0;
     const void *found = NULL;
     const void *key_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -833,7 +1208,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seek__JLjava_nio_ByteBuffer_2IILjava_n
     size_t found_len = 0;
     const void *found = NULL;
     const void *key_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -880,25 +1255,30 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BI_3BII(
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jbyte *filter_min_data = NULL;
-    jbyte *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return NULL;
+
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return NULL;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -934,24 +1314,33 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_lang_String_2I(
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jsize filter_max_len = 0;
-    jbyte *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_max_len;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = 0;
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return NULL;
+
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return NULL;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
+    string_release(filter_max_data, filter_max_buf);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+
     if (err) {
         throw_new_hse_exception(env, err);
         return NULL;
@@ -988,14 +1377,17 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jbyte *filter_min_data = NULL;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return NULL;
+
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
 
@@ -1007,8 +1399,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1044,29 +1435,32 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2_3BII(
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jsize filter_min_len = 0;
-    jbyte *filter_max_data = NULL;
-    const char *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return NULL;
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return NULL;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, filter_min_data);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    string_release(filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1101,32 +1495,34 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_l
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jsize filter_min_len = 0;
-    jsize filter_max_len = 0;
-    const char *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    size_t filter_max_len;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return NULL;
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return NULL;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, filter_min_data);
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, filter_max_data);
+    string_release(filter_max_data, filter_max_buf);
+    string_release(filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1163,17 +1559,18 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jsize filter_min_len = 0;
+    size_t filter_min_len;
     const void *filter_max_data = NULL;
-    const char *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return NULL;
 
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
@@ -1184,6 +1581,8 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
+    string_release(filter_min_data, filter_min_buf);
+
     if (err) {
         throw_new_hse_exception(env, err);
         return NULL;
@@ -1220,9 +1619,10 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jbyte *filter_max_data = NULL;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -1233,15 +1633,15 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data)
+        return NULL;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1278,10 +1678,11 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     size_t found_len;
     const void *found;
     jbyteArray found_key;
-    jsize filter_max_len = 0;
+    size_t filter_max_len;
     const void *filter_min_data = NULL;
-    const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -1292,15 +1693,17 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
-    }
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data)
+        return NULL;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
+    string_release(filter_max_data, filter_max_buf);
+
     if (err) {
         throw_new_hse_exception(env, err);
         return NULL;
@@ -1340,7 +1743,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     jbyteArray found_key;
     const void *filter_min_data = NULL;
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -1398,25 +1801,30 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BI_3BI_3BII(
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_min_data = NULL;
-    jbyte *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return 0;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1454,25 +1862,30 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BI_3BILjava_nio_ByteBuff
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_min_data = NULL;
-    jbyte *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return 0;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1509,28 +1922,32 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_lang_String_2_3B
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_max_len = 0;
-    jbyte *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_max_len;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return 0;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, filter_max_data);
+    string_release(filter_max_data, filter_max_buf);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1567,28 +1984,32 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_lang_String_2Lja
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_max_len = 0;
-    jbyte *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_max_len;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        key_array_release(env, filter_min, filter_min_data, filter_min_buf);
+        return 0;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, filter_max_data);
+    string_release(filter_max_data, filter_max_buf);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1627,14 +2048,17 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_min_data = NULL;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
 
@@ -1646,8 +2070,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1686,14 +2109,17 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_min_data = NULL;
+    const void *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min)
-        filter_min_data = (*env)->GetByteArrayElements(env, filter_min, NULL);
+    filter_min_data = key_array_acquire(env, filter_min, filter_min_len, filter_min_buf);
+    if (filter_min && !filter_min_data)
+        return 0;
+
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
 
@@ -1705,8 +2131,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__J_3BILjava_nio_ByteBuffer_2
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseByteArrayElements(env, filter_min, filter_min_data, JNI_ABORT);
+    key_array_release(env, filter_min, filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1743,29 +2168,32 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2_3BI_3B
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    jbyte *filter_max_data = NULL;
-    const char *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return 0;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    string_release(filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1802,29 +2230,32 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2_3BILja
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    jbyte *filter_max_data = NULL;
-    const char *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return 0;
+    }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    string_release(filter_min_data, filter_min_buf);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1860,32 +2291,34 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_l
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    jsize filter_max_len = 0;
-    const char *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    size_t filter_max_len;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return 0;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, NULL);
+    string_release(filter_max_data, filter_max_buf);
+    string_release(filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1921,32 +2354,34 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_l
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    jsize filter_max_len = 0;
-    const char *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    size_t filter_min_len;
+    size_t filter_max_len;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data) {
+        string_release(filter_min_data, filter_min_buf);
+        return 0;
     }
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, NULL);
+    string_release(filter_max_data, filter_max_buf);
+    string_release(filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -1984,17 +2419,18 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    const char *filter_min_data = NULL;
+    size_t filter_min_len;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
@@ -2007,8 +2443,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
+    string_release(filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2046,17 +2481,18 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_min_len = 0;
-    const char *filter_min_data = NULL;
+    size_t filter_min_len;
+    const char *filter_min_data;
+    uint8_t filter_min_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
-    if (filter_min) {
-        filter_min_data = (*env)->GetStringUTFChars(env, filter_min, NULL);
-        filter_min_len = (*env)->GetStringUTFLength(env, filter_min);
-    }
+    filter_min_data = string_acquire(
+        env, filter_min, filter_min_buf, sizeof(filter_min_buf), &filter_min_len);
+    if (filter_min && !filter_min_data)
+        return 0;
 
     if (filter_max) {
         filter_max_data = (*env)->GetDirectBufferAddress(env, filter_max);
@@ -2069,8 +2505,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_lang_String_2Ljava_n
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_min)
-        (*env)->ReleaseStringUTFChars(env, filter_min, NULL);
+    string_release(filter_min_data, filter_min_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2109,9 +2544,10 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_max_data = NULL;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2122,15 +2558,15 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data)
+        return 0;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2169,9 +2605,10 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jbyte *filter_max_data = NULL;
+    const void *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
     const void *filter_min_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2182,15 +2619,15 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2II_3
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max)
-        filter_max_data = (*env)->GetByteArrayElements(env, filter_max, NULL);
+    filter_max_data = key_array_acquire(env, filter_max, filter_max_len, filter_max_buf);
+    if (filter_max && !filter_max_data)
+        return 0;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_max)
-        (*env)->ReleaseByteArrayElements(env, filter_max, filter_max_data, JNI_ABORT);
+    key_array_release(env, filter_max, filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2228,10 +2665,11 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_max_len = 0;
+    size_t filter_max_len;
     const void *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2242,17 +2680,16 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
-    }
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data)
+        return 0;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, filter_max_data);
+    string_release(filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2290,10 +2727,11 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     hse_err_t err;
     size_t found_len;
     const void *found;
-    jsize filter_max_len = 0;
+    size_t filter_max_len;
     const void *filter_min_data = NULL;
-    const char *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    const char *filter_max_data;
+    uint8_t filter_max_buf[HSE_KVS_KEY_LEN_MAX];
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2304,17 +2742,16 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
         filter_min_data = (uint8_t *)filter_min_data + filter_min_pos;
     }
 
-    if (filter_max) {
-        filter_max_data = (*env)->GetStringUTFChars(env, filter_max, NULL);
-        filter_max_len = (*env)->GetStringUTFLength(env, filter_max);
-    }
+    filter_max_data = string_acquire(
+        env, filter_max, filter_max_buf, sizeof(filter_max_buf), &filter_max_len);
+    if (filter_max && !filter_max_data)
+        return 0;
 
     err = hse_kvs_cursor_seek_range(
         cursor, flags, filter_min_data, filter_min_len, filter_max_data, filter_max_len, &found,
         &found_len);
 
-    if (filter_max)
-        (*env)->ReleaseStringUTFChars(env, filter_max, filter_max_data);
+    string_release(filter_max_data, filter_max_buf);
 
     if (err) {
         throw_new_hse_exception(env, err);
@@ -2356,7 +2793,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     size_t found_len;
     const void *filter_min_data = NULL;
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2418,7 +2855,7 @@ Java_io_github_hse_1project_hse_KvsCursor_seekRange__JLjava_nio_ByteBuffer_2IILj
     size_t found_len;
     const void *filter_min_data = NULL;
     const void *filter_max_data = NULL;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct hse_kvs_cursor *cursor = cursor_reposition(cursor_handle);
 
     (void)cursor_obj;
 
@@ -2466,11 +2903,14 @@ Java_io_github_hse_1project_hse_KvsCursor_updateView(
     jlong cursor_handle)
 {
     hse_err_t err;
-    struct hse_kvs_cursor *cursor = (struct hse_kvs_cursor *)cursor_handle;
+    struct cursor *cursor = (struct cursor *)cursor_handle;
 
     (void)cursor_obj;
 
-    err = hse_kvs_cursor_update_view(cursor, 0);
+    /* A pending record was read before the view moved, like every record
+     * returned before it, so it is kept.
+     */
+    err = hse_kvs_cursor_update_view(cursor->cursor, 0);
     if (err)
         throw_new_hse_exception(env, err);
 }
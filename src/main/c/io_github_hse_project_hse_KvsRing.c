@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#include <assert.h>
+#include <jni.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/hse.h>
+
+#include "hsejni.h"
+#include "io_github_hse_project_hse_KvsRing.h"
+
+/* The layout of the memory shared with Java. Offsets and sizes must match the
+ * constants in KvsRing.java. Every index sits on its own cache line, since
+ * each one is written by only one side.
+ */
+struct ring_hdr {
+    alignas(64) uint32_t sq_head;
+    alignas(64) uint32_t sq_tail;
+    alignas(64) uint32_t cq_head;
+    alignas(64) uint32_t cq_tail;
+    alignas(64) uint32_t flags;
+};
+
+struct ring_sqe {
+    uint32_t opcode;
+    uint32_t flags;
+    uint64_t user_data;
+    uint64_t txn;
+    uint32_t key_off;
+    uint32_t key_len;
+    uint32_t value_off;
+    uint32_t value_len;
+    uint64_t reserved;
+};
+
+struct ring_cqe {
+    uint64_t user_data;
+    int64_t err;
+    int64_t res;
+};
+
+static_assert(sizeof(struct ring_hdr) == 320, "KvsRing.java depends on this");
+static_assert(sizeof(struct ring_sqe) == 48, "KvsRing.java depends on this");
+static_assert(sizeof(struct ring_cqe) == 24, "KvsRing.java depends on this");
+
+#define RING_OP_DELETE 0
+#define RING_OP_GET    1
+#define RING_OP_PUT    2
+
+/* Set by the service thread before it sleeps. */
+#define RING_FLAG_NEED_WAKEUP (1u << 0)
+
+#define RING_RES_NOT_FOUND (-1)
+#define RING_RES_INVALID   (-2)
+
+/* Polls of an empty submission queue, or of a full completion queue, before
+ * the service thread sleeps.
+ */
+#define RING_SPIN_MAX 4096
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+struct ring {
+    struct ring_hdr *hdr;
+    struct ring_sqe *sqes;
+    struct ring_cqe *cqes;
+    size_t shared_sz;
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+    struct hse_kvs *kvs;
+    uint8_t *buf;
+    size_t buf_sz;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool stopping;
+};
+
+static bool
+ring_range_valid(const struct ring *ring, uint32_t off, uint32_t len)
+{
+    return off <= ring->buf_sz && len <= ring->buf_sz - off;
+}
+
+static void
+ring_run(const struct ring *ring, const struct ring_sqe *sqe, struct ring_cqe *cqe)
+{
+    bool found;
+    size_t value_len;
+    hse_err_t err = 0;
+    int64_t res = 0;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)(uintptr_t)sqe->txn;
+
+    cqe->user_data = sqe->user_data;
+    cqe->err = 0;
+
+    /* Java could have written anything, so never trust an offset. */
+    if (!ring_range_valid(ring, sqe->key_off, sqe->key_len) ||
+        (sqe->opcode != RING_OP_DELETE &&
+         !ring_range_valid(ring, sqe->value_off, sqe->value_len))) {
+        cqe->res = RING_RES_INVALID;
+        return;
+    }
+
+    switch (sqe->opcode) {
+    case RING_OP_DELETE:
+        err = hse_kvs_delete(ring->kvs, 0, txn, ring->buf + sqe->key_off, sqe->key_len);
+        break;
+    case RING_OP_GET:
+        err = hse_kvs_get(
+            ring->kvs, 0, txn, ring->buf + sqe->key_off, sqe->key_len, &found,
+            ring->buf + sqe->value_off, sqe->value_len, &value_len);
+        res = found ? (int64_t)value_len : RING_RES_NOT_FOUND;
+        break;
+    case RING_OP_PUT:
+        err = hse_kvs_put(
+            ring->kvs, sqe->flags, txn, ring->buf + sqe->key_off, sqe->key_len,
+            ring->buf + sqe->value_off, sqe->value_len);
+        break;
+    default:
+        res = RING_RES_INVALID;
+        break;
+    }
+
+    cqe->err = err;
+    cqe->res = err ? 0 : res;
+}
+
+static bool
+ring_sq_empty(const struct ring *ring, uint32_t sq_head)
+{
+    return __atomic_load_n(&ring->hdr->sq_tail, __ATOMIC_SEQ_CST) == sq_head;
+}
+
+static bool
+ring_cq_full(const struct ring *ring, uint32_t cq_tail)
+{
+    return cq_tail - __atomic_load_n(&ring->hdr->cq_head, __ATOMIC_SEQ_CST) == ring->cq_entries;
+}
+
+/* Sleeps while blocked(ring, pos) holds, until Java publishes a new submission
+ * queue tail or completion queue head, or the ring is stopped. Java reads the
+ * flag after a full fence that follows either store, and this side re-reads
+ * both after storing the flag, so one of the two always observes the other.
+ */
+static void
+ring_sleep(struct ring *ring, bool (*blocked)(const struct ring *, uint32_t), uint32_t pos)
+{
+    pthread_mutex_lock(&ring->lock);
+    __atomic_store_n(&ring->hdr->flags, RING_FLAG_NEED_WAKEUP, __ATOMIC_SEQ_CST);
+    while (blocked(ring, pos) && !ring->stopping)
+        pthread_cond_wait(&ring->cond, &ring->lock);
+    __atomic_store_n(&ring->hdr->flags, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+static void *
+ring_service(void *arg)
+{
+    struct ring *ring = arg;
+    uint32_t sq_head = 0;
+    uint32_t cq_tail = 0;
+    unsigned int idle = 0;
+
+    while (true) {
+        bool stopping;
+        uint32_t sq_tail;
+        struct ring_sqe sqe;
+        struct ring_cqe cqe;
+
+        stopping = __atomic_load_n(&ring->stopping, __ATOMIC_ACQUIRE);
+        sq_tail = __atomic_load_n(&ring->hdr->sq_tail, __ATOMIC_ACQUIRE);
+        if (sq_head == sq_tail) {
+            if (stopping)
+                break;
+
+            if (++idle < RING_SPIN_MAX) {
+                cpu_relax();
+            } else {
+                ring_sleep(ring, ring_sq_empty, sq_head);
+                idle = 0;
+            }
+            continue;
+        }
+
+        /* Completions are never dropped while the ring is open. Once it is
+         * closing, nobody is left to reap them. Java may not reap for a long
+         * time, so back off exactly as on an empty submission queue.
+         */
+        if (!stopping && ring_cq_full(ring, cq_tail)) {
+            if (++idle < RING_SPIN_MAX) {
+                cpu_relax();
+            } else {
+                ring_sleep(ring, ring_cq_full, cq_tail);
+                idle = 0;
+            }
+            continue;
+        }
+
+        idle = 0;
+
+        // Java may reuse the slot as soon as sq_head moves past it.
+        sqe = ring->sqes[sq_head & (ring->sq_entries - 1)];
+        __atomic_store_n(&ring->hdr->sq_head, ++sq_head, __ATOMIC_RELEASE);
+
+        ring_run(ring, &sqe, &cqe);
+
+        if (!stopping) {
+            ring->cqes[cq_tail & (ring->cq_entries - 1)] = cqe;
+            __atomic_store_n(&ring->hdr->cq_tail, ++cq_tail, __ATOMIC_RELEASE);
+        }
+    }
+
+    return NULL;
+}
+
+jlong
+Java_io_github_hse_1project_hse_KvsRing_create(
+    JNIEnv *env,
+    jobject ring_obj,
+    jlong kvs_handle,
+    jobject buf,
+    jint buf_sz,
+    jint entries)
+{
+    int rc;
+    void *buf_addr;
+    struct ring *ring;
+
+    (void)ring_obj;
+
+    assert(entries > 0 && (entries & (entries - 1)) == 0);
+
+    // NULL for a buffer which is not direct, or if the JVM has no direct access.
+    buf_addr = (*env)->GetDirectBufferAddress(env, buf);
+    if (!buf_addr) {
+        (*env)->ThrowNew(
+            env, globals.java.lang.IllegalArgumentException.class,
+            "Registered buffer must be direct");
+        return 0;
+    }
+
+    ring = calloc(1, sizeof(*ring));
+    if (!ring)
+        goto err;
+
+    ring->sq_entries = entries;
+    ring->cq_entries = 2 * (uint32_t)entries;
+    ring->kvs = (struct hse_kvs *)kvs_handle;
+    ring->buf = buf_addr;
+    ring->buf_sz = buf_sz;
+    ring->shared_sz = sizeof(*ring->hdr) + ring->sq_entries * sizeof(*ring->sqes) +
+        ring->cq_entries * sizeof(*ring->cqes);
+
+    // aligned_alloc() requires a multiple of the alignment.
+    ring->shared_sz = (ring->shared_sz + alignof(struct ring_hdr) - 1) &
+        ~(alignof(struct ring_hdr) - 1);
+
+    ring->hdr = aligned_alloc(alignof(struct ring_hdr), ring->shared_sz);
+    if (!ring->hdr)
+        goto err;
+
+    memset(ring->hdr, 0, ring->shared_sz);
+    ring->sqes = (struct ring_sqe *)(ring->hdr + 1);
+    ring->cqes = (struct ring_cqe *)(ring->sqes + ring->sq_entries);
+
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->cond, NULL);
+
+    rc = pthread_create(&ring->thread, NULL, ring_service, ring);
+    if (rc) {
+        pthread_cond_destroy(&ring->cond);
+        pthread_mutex_destroy(&ring->lock);
+        goto err;
+    }
+
+    return (jlong)ring;
+
+err:
+    if (ring)
+        free(ring->hdr);
+    free(ring);
+
+    (*env)->ThrowNew(
+        env, globals.java.lang.OutOfMemoryError.class, "Failed to allocate memory for ring");
+
+    return 0;
+}
+
+void
+Java_io_github_hse_1project_hse_KvsRing_destroy(JNIEnv *env, jobject ring_obj, jlong ring_handle)
+{
+    struct ring *ring = (struct ring *)ring_handle;
+
+    (void)env;
+    (void)ring_obj;
+
+    pthread_mutex_lock(&ring->lock);
+    __atomic_store_n(&ring->stopping, true, __ATOMIC_RELEASE);
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->lock);
+
+    // Anything already submitted still runs.
+    pthread_join(ring->thread, NULL);
+
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->hdr);
+    free(ring);
+}
+
+jobject
+Java_io_github_hse_1project_hse_KvsRing_shared(JNIEnv *env, jobject ring_obj, jlong ring_handle)
+{
+    struct ring *ring = (struct ring *)ring_handle;
+
+    (void)ring_obj;
+
+    return (*env)->NewDirectByteBuffer(env, ring->hdr, ring->shared_sz);
+}
+
+void
+Java_io_github_hse_1project_hse_KvsRing_wakeup(JNIEnv *env, jobject ring_obj, jlong ring_handle)
+{
+    struct ring *ring = (struct ring *)ring_handle;
+
+    (void)env;
+    (void)ring_obj;
+
+    pthread_mutex_lock(&ring->lock);
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+void
+Java_io_github_hse_1project_hse_KvsRing_check(JNIEnv *env, jclass ring_cls, jlong err)
+{
+    (void)ring_cls;
+
+    if (err)
+        throw_new_hse_exception(env, err);
+}
@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jni.h>
+
+#include <hse/hse.h>
+
+#include "hsejni.h"
+#include "io_github_hse_project_hse_WriteBatch.h"
+
+/* Must match WriteBatch.Op. */
+enum write_batch_op_code {
+    WRITE_BATCH_OP_PUT,
+    WRITE_BATCH_OP_DELETE,
+    WRITE_BATCH_OP_PREFIX_DELETE,
+};
+
+/* Header preceding the key and value of every operation in the buffer. Must
+ * match the layout written by WriteBatch.addOp().
+ */
+struct write_batch_op {
+    int64_t kvs_handle;
+    int32_t op;
+    int32_t flags;
+    int32_t key_len;
+    int32_t value_len;
+};
+
+static_assert(sizeof(struct write_batch_op) == 24, "Must match WriteBatch.OP_HEADER_SZ");
+
+/* Applies every operation in the buffer in order, stopping at the first
+ * failure. Operations without a KVS handle are applied to default_kvs. Returns
+ * false with a pending exception if an operation failed.
+ */
+static bool
+apply(
+    JNIEnv *env,
+    jobject batch_obj,
+    struct hse_kvs *default_kvs,
+    struct hse_kvdb_txn *txn,
+    jobject ops_buf,
+    jint ops_len)
+{
+    hse_err_t err = 0;
+    jint index = 0;
+    size_t off = 0;
+    const uint8_t *ops_data;
+
+    ops_data = (*env)->GetDirectBufferAddress(env, ops_buf);
+
+    while (off < (size_t)ops_len) {
+        struct write_batch_op op;
+        struct hse_kvs *kvs;
+        const uint8_t *key_data, *value_data;
+
+        assert((size_t)ops_len - off >= sizeof(op));
+        memcpy(&op, ops_data + off, sizeof(op));
+        off += sizeof(op);
+
+        assert(op.key_len >= 0 && op.value_len >= 0);
+        assert((size_t)ops_len - off >= (size_t)op.key_len + (size_t)op.value_len);
+        key_data = ops_data + off;
+        value_data = key_data + op.key_len;
+        off += (size_t)op.key_len + (size_t)op.value_len;
+
+        kvs = op.kvs_handle ? (struct hse_kvs *)op.kvs_handle : default_kvs;
+        if (!kvs) {
+            (*env)->ThrowNew(
+                env, globals.java.lang.IllegalArgumentException.class,
+                "Write batch operation has no KVS");
+            return false;
+        }
+
+        switch (op.op) {
+        case WRITE_BATCH_OP_PUT:
+            err = hse_kvs_put(
+                kvs, op.flags, txn, key_data, op.key_len, value_data, op.value_len);
+            break;
+        case WRITE_BATCH_OP_DELETE:
+            err = hse_kvs_delete(kvs, op.flags, txn, key_data, op.key_len);
+            break;
+        case WRITE_BATCH_OP_PREFIX_DELETE:
+            err = hse_kvs_prefix_delete(kvs, op.flags, txn, key_data, op.key_len);
+            break;
+        default:
+            assert(0);
+            (*env)->ThrowNew(
+                env, globals.java.lang.IllegalArgumentException.class,
+                "Invalid write batch operation");
+            return false;
+        }
+
+        if (err)
+            break;
+
+        index++;
+    }
+
+    if (!err)
+        return true;
+
+    (*env)->SetIntField(
+        env, batch_obj, globals.io.github.hse_project.hse.WriteBatch.failedIndex, index);
+    if ((*env)->ExceptionCheck(env))
+        return false;
+
+    throw_new_hse_exception(env, err);
+
+    return false;
+}
+
+void
+Java_io_github_hse_1project_hse_WriteBatch_commit(
+    JNIEnv *env,
+    jobject batch_obj,
+    jlong kvdb_handle,
+    jlong txn_handle,
+    jobject ops_buf,
+    jint ops_len)
+{
+    hse_err_t err;
+    struct hse_kvdb *kvdb = (struct hse_kvdb *)kvdb_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    err = hse_kvdb_txn_begin(kvdb, txn);
+    if (err) {
+        throw_new_hse_exception(env, err);
+        return;
+    }
+
+    if (apply(env, batch_obj, NULL, txn, ops_buf, ops_len)) {
+        err = hse_kvdb_txn_commit(kvdb, txn);
+        if (!err)
+            return;
+
+        throw_new_hse_exception(env, err);
+    }
+
+    /* Report the original failure rather than any from the abort. */
+    if (hse_kvdb_txn_state_get(kvdb, txn) == HSE_KVDB_TXN_ACTIVE)
+        hse_kvdb_txn_abort(kvdb, txn);
+}
+
+void
+Java_io_github_hse_1project_hse_WriteBatch_write(
+    JNIEnv *env,
+    jobject batch_obj,
+    jlong kvs_handle,
+    jobject ops_buf,
+    jint ops_len,
+    jlong txn_handle)
+{
+    struct hse_kvs *kvs = (struct hse_kvs *)kvs_handle;
+    struct hse_kvdb_txn *txn = (struct hse_kvdb_txn *)txn_handle;
+
+    apply(env, batch_obj, kvs, txn, ops_buf, ops_len);
+}
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.lang.reflect.Field;
+
+/**
+ * Memory fences for memory which is shared with native threads.
+ *
+ * <p>
+ * On Java 9 and later, the fences are those of {@code VarHandle}. Java 8 has
+ * no public fence primitives, so the same fences of {@code sun.misc.Unsafe}
+ * are used instead. Both are looked up reflectively, so that this class
+ * compiles for Java 8, and are held in constant method handles, which the JIT
+ * inlines down to the fence itself.
+ * </p>
+ */
+final class Fences {
+    /** Acquire fence. */
+    private static final MethodHandle ACQUIRE = find("acquireFence", "loadFence");
+    /** Release fence. */
+    private static final MethodHandle RELEASE = find("releaseFence", "storeFence");
+    /** Full fence. */
+    private static final MethodHandle FULL = find("fullFence", "fullFence");
+
+    private Fences() {}
+
+    private static Class<?> varHandleClass() {
+        try {
+            return Class.forName("java.lang.invoke.VarHandle");
+        } catch (final ClassNotFoundException e) {
+            return null;
+        }
+    }
+
+    private static MethodHandle find(final String varHandleName, final String unsafeName) {
+        final MethodHandles.Lookup lookup = MethodHandles.lookup();
+        final MethodType type = MethodType.methodType(void.class);
+        final Class<?> varHandle = varHandleClass();
+
+        try {
+            if (varHandle != null) {
+                return lookup.findStatic(varHandle, varHandleName, type);
+            }
+
+            final Class<?> unsafeClass = Class.forName("sun.misc.Unsafe");
+            final Field theUnsafe = unsafeClass.getDeclaredField("theUnsafe");
+            theUnsafe.setAccessible(true);
+
+            return lookup.findVirtual(unsafeClass, unsafeName, type).bindTo(theUnsafe.get(null));
+        } catch (final ClassNotFoundException | IllegalAccessException | NoSuchFieldException
+                | NoSuchMethodException e) {
+            throw new ExceptionInInitializerError(e);
+        }
+    }
+
+    /* invokeExact() is only inlined down to the fence when it is called on
+     * the constant field itself, and neither fence throws.
+     */
+
+    /** Keep loads before the fence from being reordered with accesses after it. */
+    static void acquire() {
+        try {
+            ACQUIRE.invokeExact();
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+    }
+
+    /** Keep accesses before the fence from being reordered with stores after it. */
+    static void release() {
+        try {
+            RELEASE.invokeExact();
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+    }
+
+    /** Keep accesses before the fence from being reordered with accesses after it. */
+    static void full() {
+        try {
+            FULL.invokeExact();
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+    }
+}
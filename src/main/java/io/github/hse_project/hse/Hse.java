@@ -21,6 +21,15 @@ public final class Hse {
     private static native void cinit(String config, String[] params)
             throws HseException;
     private static native void cfini();
+    private static native void csetAsyncThreads(int threads);
+
+    /**
+     * Get the addresses of the HSE functions which {@code ForeignKvs} calls
+     * on Java 22 and later, as linked into the native library.
+     *
+     * @return Function addresses, in the order of {@code ForeignKvs}.
+     */
+    static native long[] cforeignSymbols();
 
     /**
      * Get an HSE global parameter.
@@ -81,6 +90,12 @@ public final class Hse {
      * </p>
      *
      * <p>
+     * Any queued asynchronous operations are run to completion before HSE is
+     * shut down. Operations submitted while this function runs are completed
+     * exceptionally with an {@link IllegalStateException}.
+     * </p>
+     *
+     * <p>
      * After invoking this function, calling any other HSE functions will
      * result in undefined behavior unless HSE is re-initialized.
      * </p>
@@ -91,6 +106,32 @@ public final class Hse {
         cfini();
     }
 
+    /**
+     * Set the number of native worker threads which run asynchronous
+     * operations, such as {@link Kvs#getAsync(byte[])}.
+     *
+     * <p>
+     * The worker pool is started by the first asynchronous operation, and is
+     * stopped by {@link #fini()} once all queued operations have run. The
+     * number of threads takes effect the next time the pool is started. By
+     * default, one thread per online CPU is started.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param threads Number of worker threads.
+     * @throws IllegalArgumentException {@code threads} was less than 1.
+     */
+    public static void setAsyncThreads(final int threads) {
+        if (threads < 1) {
+            throw new IllegalArgumentException("threads must be at least 1");
+        }
+
+        loadLibrary();
+
+        csetAsyncThreads(threads);
+    }
+
     /**
      * Load the system library which implements the HSE JNI interface.
      *
@@ -11,11 +11,18 @@ import java.util.Arrays;
 import java.util.Collections;
 import java.util.EnumSet;
 import java.util.List;
+import java.util.concurrent.CompletableFuture;
 
 /** Key-value Database (KVDB). */
 public final class Kvdb extends NativeObject implements AutoCloseable {
     /** KVDB home. */
     private final Path home;
+    /** Coalesces {@link #syncAsync(EnumSet)} requests, created on first use. */
+    private volatile SyncCoordinator syncCoordinator;
+    /** Whether the KVDB has been closed. */
+    private volatile boolean closed;
+    /** Native transaction handles available for reuse. */
+    private final KvdbTransactionPool transactionPool = new KvdbTransactionPool(this);
 
     private Kvdb(final Path kvdbHome, final String... params) throws HseException {
         this.handle = open(kvdbHome.toString(), params);
@@ -34,6 +41,32 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
     private native boolean isMclassConfigured(long kvdbHandle, int mclass);
     private native void sync(long kvdbHandle, int flags) throws HseException;
 
+    private void checkOpen() {
+        if (this.closed) {
+            throw new IllegalStateException("KVDB is closed");
+        }
+    }
+
+    /**
+     * Get the sync coordinator, starting it if this is its first use. Only
+     * {@link #syncAsync(EnumSet)} uses it; the marks do not need it.
+     */
+    private SyncCoordinator syncCoordinator() {
+        SyncCoordinator coordinator = this.syncCoordinator;
+        if (coordinator == null) {
+            synchronized (this) {
+                checkOpen();
+                coordinator = this.syncCoordinator;
+                if (coordinator == null) {
+                    coordinator = new SyncCoordinator(this);
+                    this.syncCoordinator = coordinator;
+                }
+            }
+        }
+
+        return coordinator;
+    }
+
     /**
      * Add new media class storage to an existing offline KVDB.
      *
@@ -92,13 +125,32 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
      * result in undefined behavior unless the KVDB is re-opened.
      * </p>
      *
+     * <p>
+     * Syncs requested by {@link #syncAsync(EnumSet)} are completed before the
+     * KVDB is closed, and so are queued or running asynchronous operations.
+     * Afterwards, {@link #syncAsync(EnumSet)} and the durability marks throw
+     * {@link IllegalStateException}.
+     * </p>
+     *
      * <p>This function is not thread safe.</p>
      *
      * @throws HseException Underlying C function returned a non-zero value.
      */
     @Override
     public void close() throws HseException {
+        final SyncCoordinator coordinator;
+
+        synchronized (this) {
+            this.closed = true;
+            coordinator = this.syncCoordinator;
+            this.syncCoordinator = null;
+        }
+        if (coordinator != null) {
+            coordinator.close();
+        }
+
         if (this.handle != 0) {
+            this.transactionPool.close();
             close(this.handle);
             this.handle = 0;
         }
@@ -158,6 +210,23 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
         return new CompactStatus(this);
     }
 
+    /**
+     * Get the durability mark reached by {@link #syncAsync(EnumSet)}.
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @return Highest mark whose writes are known to be on stable media.
+     * @throws IllegalStateException KVDB has been closed.
+     * @see #getSyncMark()
+     */
+    public long getDurableMark() {
+        checkOpen();
+
+        final SyncCoordinator coordinator = this.syncCoordinator;
+
+        return coordinator == null ? 0 : coordinator.getDurableMark();
+    }
+
     /**
      * Get the KVDB home.
      *
@@ -207,6 +276,58 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
         return getParam(this.handle, param);
     }
 
+    /**
+     * Get the durability mark which covers every write completed so far.
+     *
+     * <p>
+     * Writes which completed before this call are on stable media once
+     * {@link #isDurable(long)} returns {@code true} for the returned mark. Only
+     * syncs issued by {@link #syncAsync(EnumSet)} advance the marks.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @return Durability mark.
+     * @throws IllegalStateException KVDB has been closed.
+     */
+    public long getSyncMark() {
+        checkOpen();
+
+        final SyncCoordinator coordinator = this.syncCoordinator;
+
+        // Before the first request, the first sync covers every write.
+        return coordinator == null ? 1 : coordinator.getSyncMark();
+    }
+
+    KvdbTransactionPool getTransactionPool() {
+        return this.transactionPool;
+    }
+
+    /**
+     * Get statistics of the pool of transactions.
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @return Snapshot of the pool's counters.
+     * @see #transaction()
+     */
+    public TransactionPoolStats getTransactionPoolStats() {
+        return new TransactionPoolStats(this.transactionPool);
+    }
+
+    /**
+     * Check whether the writes covered by a mark are on stable media.
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param mark Mark returned by {@link #getSyncMark()}.
+     * @return Whether a sync which covers {@code mark} has completed.
+     * @throws IllegalStateException KVDB has been closed.
+     */
+    public boolean isDurable(final long mark) {
+        return getDurableMark() >= mark;
+    }
+
     /**
      * Check if a media class is configured for a KVDB.
      *
@@ -260,6 +381,69 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
         return new Kvs(this, kvsName, params);
     }
 
+    /**
+     * Run a function in a transaction, retrying it on conflicts.
+     *
+     * <p>
+     * The transaction is initiated before every attempt and committed after
+     * the function returns. If the function or the commit fails with an error
+     * which {@code policy} deems retryable, the transaction is aborted, and the
+     * function is run again after a backoff. Every attempt reuses the same
+     * native transaction. Any other failure aborts the transaction and is
+     * rethrown, as is the last failure once {@code policy} runs out of
+     * attempts or the calling thread is interrupted.
+     * </p>
+     *
+     * <p>
+     * The function must not initiate, commit, or abort the transaction, and
+     * must be safe to run more than once.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param <T> Result type of {@code fn}.
+     * @param fn Function to run.
+     * @param policy Policy deciding whether and when to retry.
+     * @return Result of the attempt which committed.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @see TransactionRetryPolicy
+     */
+    public <T> T runInTransaction(final TransactionFunction<T> fn,
+            final TransactionRetryPolicy policy) throws HseException {
+        try (KvdbTransaction txn = transaction()) {
+            int attempt = 0;
+            while (true) {
+                boolean done = false;
+
+                attempt++;
+                txn.begin();
+                try {
+                    final T result = fn.apply(txn);
+                    txn.commit();
+                    done = true;
+                    policy.recordCommit();
+
+                    return result;
+                } catch (final HseException e) {
+                    // A failed commit may already have aborted the transaction.
+                    if (txn.getState() == KvdbTransaction.State.ACTIVE) {
+                        txn.abort();
+                    }
+                    done = true;
+
+                    if (!policy.retry(e, attempt)) {
+                        throw e;
+                    }
+                } finally {
+                    // Keep close() from committing after an unchecked exception.
+                    if (!done && txn.getState() == KvdbTransaction.State.ACTIVE) {
+                        txn.abort();
+                    }
+                }
+            }
+        }
+    }
+
     /**
      * Refer to {@code #sync(EnumSet)}.
      *
@@ -287,9 +471,64 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
         sync(this.handle, flagsValue);
     }
 
+    /**
+     * Refer to {@link #syncAsync(EnumSet)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @return Future which completes with the durable mark once the sync has
+     *      completed.
+     */
+    public CompletableFuture<Long> syncAsync() {
+        return syncAsync(null);
+    }
+
+    /**
+     * Asynchronously sync data in all of the referenced KVDB's KVSs to stable
+     * media.
+     *
+     * <p>
+     * Concurrent requests are coalesced by a background thread, which issues
+     * one sync for every request queued while the previous sync was in
+     * progress. The sync is issued with {@link SyncFlags#ASYNC} only if every
+     * request it serves was made with that flag. In that case the future
+     * completes once the sync has been started, and the durable mark does not
+     * advance.
+     * </p>
+     *
+     * <p>
+     * The future is completed on the background thread, which therefore also
+     * runs every dependent stage that is not given an executor, one after
+     * another, before it issues the next sync. Attach stages which block or
+     * take long with the {@code *Async} methods of {@link CompletableFuture}
+     * instead; a stage which waits on another sync never returns. If the sync
+     * fails, the future is completed exceptionally with an
+     * {@link HseException}.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param flags Flags for operation specialization.
+     * @return Future which completes with the durable mark once the sync has
+     *      completed.
+     * @throws IllegalStateException KVDB is being closed or has been closed.
+     * @see #getSyncMark()
+     */
+    public CompletableFuture<Long> syncAsync(final EnumSet<SyncFlags> flags) {
+        final boolean needDurable = flags == null || !flags.contains(SyncFlags.ASYNC);
+
+        return syncCoordinator().request(needDurable);
+    }
+
     /**
      * Allocate transaction.
      *
+     * <p>
+     * Native transactions are pooled per KVDB, so allocating a transaction
+     * usually reuses one released by a previous {@link KvdbTransaction#close()}
+     * on the same thread, rather than calling into HSE.
+     * </p>
+     *
      * <p>This function is thread safe.</p>
      *
      * @return Transaction.
@@ -315,6 +554,24 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
         ASYNC,
     }
 
+    /**
+     * Function run by {@link Kvdb#runInTransaction(TransactionFunction,
+     * TransactionRetryPolicy)}.
+     *
+     * @param <T> Result type.
+     */
+    @FunctionalInterface
+    public interface TransactionFunction<T> {
+        /**
+         * Run the function.
+         *
+         * @param txn Transaction context to pass to KVS operations.
+         * @return Result.
+         * @throws HseException Underlying C function returned a non-zero value.
+         */
+        T apply(KvdbTransaction txn) throws HseException;
+    }
+
     /** Status of a compaction request. */
     public static final class CompactStatus {
         /** Space amp low water mark (%). */
@@ -379,4 +636,59 @@ public final class Kvdb extends NativeObject implements AutoCloseable {
             return canceled;
         }
     }
+
+    /** Counters of the pool of transactions. */
+    public static final class TransactionPoolStats {
+        /** Number of transactions which reused a pooled handle. */
+        private final long hits;
+        /** Number of transactions which allocated a handle. */
+        private final long misses;
+        /** Number of handles freed because the pool was full. */
+        private final long discards;
+
+        private TransactionPoolStats(final KvdbTransactionPool pool) {
+            this.hits = pool.getHits();
+            this.misses = pool.getMisses();
+            this.discards = pool.getDiscards();
+        }
+
+        /**
+         * Get the number of transactions which reused a pooled handle.
+         *
+         * @return Number of pool hits.
+         */
+        public long getHits() {
+            return this.hits;
+        }
+
+        /**
+         * Get the number of transactions which allocated a handle.
+         *
+         * @return Number of pool misses.
+         */
+        public long getMisses() {
+            return this.misses;
+        }
+
+        /**
+         * Get the number of handles freed because the pool was full.
+         *
+         * @return Number of discarded handles.
+         */
+        public long getDiscards() {
+            return this.discards;
+        }
+
+        /**
+         * Get the fraction of transactions which reused a pooled handle.
+         *
+         * @return Hit rate between 0 and 1, or 0 if no transaction has been
+         *      allocated.
+         */
+        public double getHitRate() {
+            final long total = this.hits + this.misses;
+
+            return total == 0 ? 0 : (double) this.hits / total;
+        }
+    }
 }
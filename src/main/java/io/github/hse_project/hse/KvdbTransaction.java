@@ -74,22 +74,23 @@ package io.github.hse_project.hse;
 public final class KvdbTransaction extends NativeObject implements AutoCloseable {
     /** KVDB the transaction is associated with. */
     private final Kvdb kvdb;
+    /**
+     * Whether the transaction has been initiated. A pooled handle retains the
+     * state its previous user left it in, which this object must not report.
+     */
+    private volatile boolean begun;
 
     KvdbTransaction(final Kvdb kvdb) {
         this.kvdb = kvdb;
-        this.handle = alloc(kvdb.handle);
+        this.handle = kvdb.getTransactionPool().lease();
     }
 
-    private static native long alloc(long kvdbHandle);
-
     private native void abort(long kvdbHandle, long txnHandle) throws HseException;
 
     private native void begin(long kvdbHandle, long txnHandle) throws HseException;
 
     private native void commit(long kvdbHandle, long txnHandle) throws HseException;
 
-    private native void free(long kvdbHandle, long txnHandle);
-
     private native State getState(long kvdbHandle, long txnHandle);
 
     /**
@@ -120,6 +121,7 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
      */
     public void begin() throws HseException {
         begin(kvdb.handle, this.handle);
+        this.begun = true;
     }
 
     /**
@@ -130,6 +132,13 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
      * transaction is aborted.
      * </p>
      *
+     * <p>
+     * The native transaction is returned to the KVDB's pool for reuse by a
+     * later {@link Kvdb#transaction()}, even if the commit fails. Asynchronous
+     * operations in the transaction are run or waited for first, so none of
+     * them can run under the next lessee.
+     * </p>
+     *
      * <p>This function is thread safe.</p>
      *
      * @throws HseException Underlying C function returned a non-zero value.
@@ -140,15 +149,17 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
             return;
         }
 
-        final State state = getState();
-        if (state == State.ACTIVE) {
-            commit();
-        } else {
-            abort();
+        try {
+            final State state = getState();
+            if (state == State.ACTIVE) {
+                commit();
+            } else {
+                abort();
+            }
+        } finally {
+            kvdb.getTransactionPool().release(this.handle);
+            this.handle = 0;
         }
-
-        free(kvdb.handle, this.handle);
-        this.handle = 0;
     }
 
     /**
@@ -158,6 +169,12 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
      * The call fails if the referenced transaction is not in the ACTIVE state.
      * </p>
      *
+     * <p>
+     * Asynchronous operations submitted in the transaction which have not
+     * completed yet are run on the calling thread, or waited for, before the
+     * commit. The same goes for {@link #abort()}.
+     * </p>
+     *
      * <p>This function is thread safe.</p>
      *
      * @throws HseException Underlying C function returned a non-zero value.
@@ -166,6 +183,37 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
         commit(kvdb.handle, this.handle);
     }
 
+    /**
+     * Atomically apply all operations of a batch in this transaction.
+     *
+     * <p>
+     * The transaction is initiated, the operations are applied in the order
+     * they were added to the batch, and the transaction is committed, all
+     * within a single call into the native library. If any step fails, the
+     * transaction is aborted and none of the operations are visible.
+     * {@link WriteBatch#getFailedIndex} reports the index of the failed
+     * operation, or -1 if initiating or committing the transaction failed.
+     * </p>
+     *
+     * <p>
+     * Every operation must have been added with a {@link Kvs}. The call fails
+     * if the transaction is in the ACTIVE state. The transaction may be reused
+     * for subsequent batches.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param batch Operations to apply.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws IllegalArgumentException An operation was added without a
+     *      {@link Kvs}.
+     * @see WriteBatch
+     */
+    public void commit(final WriteBatch batch) throws HseException {
+        this.begun = true;
+        batch.commit(kvdb.handle, this.handle);
+    }
+
     /**
      * Get the state of the transaction.
      *
@@ -174,6 +222,10 @@ public final class KvdbTransaction extends NativeObject implements AutoCloseable
      * @return Transaction's state.
      */
     public State getState() {
+        if (!this.begun) {
+            return State.INVALID;
+        }
+
         return getState(kvdb.handle, this.handle);
     }
 
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.util.concurrent.atomic.LongAdder;
+
+/**
+ * Pool of native transaction handles of a KVDB.
+ *
+ * <p>
+ * Handles are cached in one small stack per available processor, chosen by
+ * the calling thread, so a thread which repeatedly opens and closes
+ * transactions keeps reusing the same few handles without contending with
+ * other threads. A handle is only pooled if it is not left ACTIVE. When a
+ * thread's stack is empty, a handle is allocated, and when it is full, the
+ * returned handle is freed, which bounds the pool to
+ * {@link #STRIPE_CAPACITY} handles per processor.
+ * </p>
+ */
+final class KvdbTransactionPool {
+    /** Number of handles cached per stripe. */
+    static final int STRIPE_CAPACITY = 8;
+
+    /** KVDB the handles belong to. */
+    private final Kvdb kvdb;
+    /** One stripe per available processor. */
+    private final Stripe[] stripes;
+    /** Number of leases served from the pool. */
+    private final LongAdder hits = new LongAdder();
+    /** Number of leases which allocated a handle. */
+    private final LongAdder misses = new LongAdder();
+    /** Number of returned handles freed because their stripe was full. */
+    private final LongAdder discards = new LongAdder();
+    /** Whether the pool has been drained for the KVDB to close. */
+    private volatile boolean closed;
+
+    KvdbTransactionPool(final Kvdb kvdb) {
+        this.kvdb = kvdb;
+        this.stripes = new Stripe[Runtime.getRuntime().availableProcessors()];
+        for (int i = 0; i < this.stripes.length; i++) {
+            this.stripes[i] = new Stripe();
+        }
+    }
+
+    private static native long alloc(long kvdbHandle);
+    private static native void free(long kvdbHandle, long txnHandle);
+    private static native boolean recycle(long kvdbHandle, long txnHandle);
+
+    private Stripe stripe() {
+        return this.stripes[(int) (Thread.currentThread().getId() % this.stripes.length)];
+    }
+
+    long lease() {
+        final Stripe stripe = stripe();
+
+        synchronized (stripe) {
+            if (stripe.count > 0) {
+                this.hits.increment();
+                return stripe.handles[--stripe.count];
+            }
+        }
+
+        this.misses.increment();
+
+        return alloc(this.kvdb.handle);
+    }
+
+    void release(final long txnHandle) {
+        final Stripe stripe = stripe();
+
+        // Frees the handle itself if it cannot be reset.
+        if (!recycle(this.kvdb.handle, txnHandle)) {
+            return;
+        }
+
+        /* Checking closed under the stripe's monitor guarantees that close()
+         * either sees the handle or the handle sees closed.
+         */
+        synchronized (stripe) {
+            if (!this.closed && stripe.count < STRIPE_CAPACITY) {
+                stripe.handles[stripe.count++] = txnHandle;
+                return;
+            }
+        }
+
+        this.discards.increment();
+        free(this.kvdb.handle, txnHandle);
+    }
+
+    long getHits() {
+        return this.hits.sum();
+    }
+
+    long getMisses() {
+        return this.misses.sum();
+    }
+
+    long getDiscards() {
+        return this.discards.sum();
+    }
+
+    /**
+     * Free every pooled handle. Handles still leased are freed as they are
+     * returned.
+     */
+    void close() {
+        this.closed = true;
+
+        for (final Stripe stripe : this.stripes) {
+            synchronized (stripe) {
+                while (stripe.count > 0) {
+                    free(this.kvdb.handle, stripe.handles[--stripe.count]);
+                }
+            }
+        }
+    }
+
+    /** Handles cached for the threads which map to one processor. */
+    private static final class Stripe {
+        /** Cached handles. */
+        private final long[] handles = new long[STRIPE_CAPACITY];
+        /** Number of cached handles. */
+        private int count;
+    }
+}
@@ -6,8 +6,16 @@
 package io.github.hse_project.hse;
 
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.Collections;
 import java.util.EnumSet;
+import java.util.IdentityHashMap;
+import java.util.Map;
 import java.util.Optional;
+import java.util.Set;
+import java.util.concurrent.CompletableFuture;
+import java.util.stream.Stream;
+import java.util.stream.StreamSupport;
 
 import io.github.hse_project.hse.KvsCursor.CreateFlags;
 
@@ -15,6 +23,8 @@ import io.github.hse_project.hse.KvsCursor.CreateFlags;
 public final class Kvs extends NativeObject implements AutoCloseable {
     /** Name of the KVS. */
     private final String name;
+    /** Rings open on the KVS, whose service threads hold its handle. */
+    private final Set<KvsRing> rings = Collections.newSetFromMap(new IdentityHashMap<>());
 
     Kvs(final Kvdb kvdb, final String kvsName, final String... params) throws HseException {
         this.handle = open(kvdb.handle, kvsName, params);
@@ -34,6 +44,8 @@ public final class Kvs extends NativeObject implements AutoCloseable {
             throws HseException;
     private native void delete(long kvsHandle, ByteBuffer key, int keyLen, int keyPos,
         int flags, long txnHandle) throws HseException;
+    private native CompletableFuture<Void> deleteAsync(long kvsHandle, byte[] key, int keyLen,
+        int flags, long txnHandle);
     private native byte[] get(long kvsHandle, byte[] key, int keyLen, int flags, long txnHandle)
             throws HseException;
     private native byte[] get(long kvsHandle, String key, int flags, long txnHandle)
@@ -53,6 +65,13 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     private native int get(long kvsHandle, ByteBuffer key, int keyLen,
         int keyPos, ByteBuffer valueBuf, int valueBufSz, int valueBufPos, int flags,
         long txnHandle) throws HseException;
+    private native CompletableFuture<Optional<byte[]>> getAsync(long kvsHandle, byte[] key,
+        int keyLen, int flags, long txnHandle);
+    private native long getBatch(long kvsHandle, byte[][] keys, ByteBuffer valueBuf,
+        int valueBufSz, int valueBufPos, int flags, long txnHandle) throws HseException;
+    private native long getBatch(long kvsHandle, ByteBuffer keys, int keysLen, int keysPos,
+        ByteBuffer valueBuf, int valueBufSz, int valueBufPos, int flags, long txnHandle)
+            throws HseException;
     private native String getName(long kvsHandle);
     private native String getParam(long kvdbHandle, String param) throws HseException;
     private native void prefixDelete(long kvsHandle, byte[] pfx, int pfxLen, int flags,
@@ -80,6 +99,8 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     private native void put(long kvsHandle, ByteBuffer key, int keyLen, int keyPos,
         ByteBuffer value, int valueLen, int valuePos, int flags, long txnHandle)
             throws HseException;
+    private native CompletableFuture<Void> putAsync(long kvsHandle, byte[] key, int keyLen,
+        byte[] value, int valueLen, int flags, long txnHandle);
 
     /**
      * Create a KVS within the referenced KVDB.
@@ -115,6 +136,17 @@ public final class Kvs extends NativeObject implements AutoCloseable {
      * Close an open KVS.
      *
      * <p>
+     * Rings created by {@link #ring(ByteBuffer, int)} which are still open
+     * are closed first, which runs their submitted operations.
+     * </p>
+     *
+     * <p>
+     * Asynchronous operations on the KVS which are still queued are run on
+     * the calling thread, and those being run by a worker are waited for,
+     * before the KVS is closed.
+     * </p>
+     *
+     * <p>
      * After invoking this function, calling any other KVS functions will result
      * in undefined behavior unless the KVS is re-opened.
      * </p>
@@ -126,6 +158,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     @Override
     public void close() throws HseException {
         if (this.handle != 0) {
+            final KvsRing[] open;
+            synchronized (this.rings) {
+                open = this.rings.toArray(new KvsRing[0]);
+            }
+            for (final KvsRing ring : open) {
+                ring.close();
+            }
+
             close(this.handle);
             this.handle = 0;
         }
@@ -396,14 +436,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #cursor(byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filter Iteration limited to keys matching this prefix filter.
      * @param flags Flags for operation specialization.
      * @param txn Transaction context.
      * @return Cursor.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public KvsCursor cursor(final String filter, final EnumSet<CreateFlags> flags,
             final KvdbTransaction txn) throws HseException {
@@ -492,12 +532,12 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #delete(byte[], KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Transaction context.
      * @param txn Key to delete.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void delete(final String key, final KvdbTransaction txn) throws HseException {
         final long txnHandle = txn == null ? 0 : txn.handle;
@@ -537,6 +577,59 @@ public final class Kvs extends NativeObject implements AutoCloseable {
         delete(this.handle, key, keyLen, keyPos, 0, txnHandle);
     }
 
+    /**
+     * Refer to {@link #deleteAsync(byte[], KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param key Key to delete.
+     * @return Future which completes once the key has been deleted.
+     */
+    public CompletableFuture<Void> deleteAsync(final byte[] key) {
+        return deleteAsync(key, null);
+    }
+
+    /**
+     * Asynchronously delete the key and its associated value from the KVS.
+     *
+     * <p>
+     * The arguments are copied, and the operation is queued to the pool of
+     * native worker threads, so the calling thread never blocks on HSE. The
+     * returned future is completed by a worker thread, which also runs any
+     * dependent stages that are not given an executor. If the operation
+     * fails, the future is completed exceptionally with an
+     * {@link HseException}.
+     * </p>
+     *
+     * <p>
+     * Operations submitted with the same transaction are run one at a time, as
+     * HSE allows only one thread to operate on a transaction at once, but in
+     * no guaranteed order.
+     * </p>
+     *
+     * <p>
+     * Closing the KVS, or committing, aborting, or closing {@code txn}, first
+     * runs the operation on the closing thread if no worker has picked it up
+     * yet, or waits for it otherwise. If {@link Hse#fini()} is in progress,
+     * the future is completed exceptionally with an
+     * {@link IllegalStateException}.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param key Key to delete.
+     * @param txn Transaction context.
+     * @return Future which completes once the key has been deleted.
+     * @see #delete(byte[], KvdbTransaction)
+     * @see Hse#setAsyncThreads(int)
+     */
+    public CompletableFuture<Void> deleteAsync(final byte[] key, final KvdbTransaction txn) {
+        final int keyLen = key == null ? 0 : key.length;
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        return deleteAsync(this.handle, key, keyLen, 0, txnHandle);
+    }
+
     /**
      * Refer to {@link #get(byte[], byte[], KvdbTransaction)}.
      *
@@ -600,14 +693,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #get(byte[], byte[], KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to get.
      * @param txn Transaction context.
      * @return Buffer into which the value associated with {@code key} will be
      *      copied.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> get(final String key, final KvdbTransaction txn) throws HseException {
         final long txnHandle = txn == null ? 0 : txn.handle;
@@ -779,7 +872,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #get(byte[], byte[], KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to get.
      * @param valueBuf Buffer into which the value associated with {@code key}
@@ -787,7 +880,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
      * @param txn Transaction context.
      * @return Actual length of the value if {@code key} was found.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> get(final String key, final byte[] valueBuf, final KvdbTransaction txn)
             throws HseException {
@@ -903,7 +996,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #get(byte[], byte[], KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to get.
      * @param valueBuf Buffer into which the value associated with {@code key}
@@ -913,7 +1006,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
      * @return Actual length of the value if {@code key} was found.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> get(final String key, final ByteBuffer valueBuf,
             final KvdbTransaction txn) throws HseException {
@@ -1005,6 +1098,208 @@ public final class Kvs extends NativeObject implements AutoCloseable {
         return Optional.of(valueLen);
     }
 
+    /**
+     * Refer to {@link #getAsync(byte[], KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param key Key to get from the KVS.
+     * @return Future which completes with the value associated with
+     *      {@code key}, or {@link Optional#empty()} if it was not found.
+     */
+    public CompletableFuture<Optional<byte[]>> getAsync(final byte[] key) {
+        return getAsync(key, null);
+    }
+
+    /**
+     * Asynchronously retrieve the value for a given key from the KVS.
+     *
+     * <p>
+     * The arguments are copied, and the operation is queued to the pool of
+     * native worker threads, so the calling thread never blocks on HSE. The
+     * returned future is completed by a worker thread, which also runs any
+     * dependent stages that are not given an executor. If the operation
+     * fails, the future is completed exceptionally with an
+     * {@link HseException}.
+     * </p>
+     *
+     * <p>
+     * Operations submitted with the same transaction are run one at a time, as
+     * HSE allows only one thread to operate on a transaction at once, but in
+     * no guaranteed order.
+     * </p>
+     *
+     * <p>
+     * Closing the KVS, or committing, aborting, or closing {@code txn}, first
+     * runs the operation on the closing thread if no worker has picked it up
+     * yet, or waits for it otherwise. If {@link Hse#fini()} is in progress,
+     * the future is completed exceptionally with an
+     * {@link IllegalStateException}.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param key Key to get from the KVS.
+     * @param txn Transaction context.
+     * @return Future which completes with the value associated with
+     *      {@code key}, or {@link Optional#empty()} if it was not found.
+     * @see #get(byte[], KvdbTransaction)
+     * @see Hse#setAsyncThreads(int)
+     */
+    public CompletableFuture<Optional<byte[]>> getAsync(final byte[] key,
+            final KvdbTransaction txn) {
+        final int keyLen = key == null ? 0 : key.length;
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        return getAsync(this.handle, key, keyLen, 0, txnHandle);
+    }
+
+    /**
+     * Refer to {@link #getBatch(byte[][], ByteBuffer, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param keys Keys to get.
+     * @param valueBuf Buffer into which the value records will be written.
+     * @return Number of keys resolved.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public int getBatch(final byte[][] keys, final ByteBuffer valueBuf) throws HseException {
+        return getBatch(keys, valueBuf, null);
+    }
+
+    /**
+     * Refer to {@link #getBatch(byte[][], ByteBuffer, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param keys Packed key records.
+     * @param valueBuf Buffer into which the value records will be written.
+     * @return Number of keys resolved.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public int getBatch(final ByteBuffer keys, final ByteBuffer valueBuf) throws HseException {
+        return getBatch(keys, valueBuf, null);
+    }
+
+    /**
+     * Retrieve the values for many keys from the referenced KVS in one call.
+     *
+     * <p>
+     * For every key, a record is written to {@code valueBuf} starting at its
+     * position: a 4-byte value length in native byte order followed by the
+     * value. Keys which were not found have a length of -1 and no value bytes.
+     * Records are written in the same order as {@code keys}.
+     * </p>
+     *
+     * <p>
+     * Keys are resolved until one does not fit in the remainder of
+     * {@code valueBuf}. The caller can resume from the returned index with an
+     * emptied buffer. A buffer of at least {@link Integer#BYTES} +
+     * {@link Limits#KVS_VALUE_LEN_MAX} bytes always makes progress.
+     * {@link ByteBuffer#limit(int)} is set to the end of the last record.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param keys Keys to get.
+     * @param valueBuf Buffer into which the value records will be written.
+     * @param txn Transaction context.
+     * @return Number of keys resolved.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @see ByteOrder#nativeOrder()
+     */
+    public int getBatch(final byte[][] keys, final ByteBuffer valueBuf,
+            final KvdbTransaction txn) throws HseException {
+        int valueBufSz = 0;
+        int valueBufPos = 0;
+        if (valueBuf != null) {
+            assert valueBuf.isDirect();
+
+            valueBufSz = valueBuf.remaining();
+            valueBufPos = valueBuf.position();
+        }
+
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        final long packed = getBatch(this.handle, keys, valueBuf, valueBufSz, valueBufPos, 0,
+            txnHandle);
+
+        if (valueBuf != null) {
+            valueBuf.limit(valueBufPos + (int) (packed >>> Integer.SIZE));
+        }
+
+        return (int) packed;
+    }
+
+    /**
+     * Refer to {@link #getBatch(byte[][], ByteBuffer, KvdbTransaction)}.
+     *
+     * <p>Any {@link ByteBuffer} arguments must be direct.</p>
+     *
+     * <p>
+     * {@code keys} holds key records from its position to its limit: a 4-byte
+     * key length in native byte order followed by the key. On return, the
+     * position of {@code keys} is moved past the resolved keys.
+     * </p>
+     *
+     * @param keys Packed key records.
+     * @param valueBuf Buffer into which the value records will be written.
+     * @param txn Transaction context.
+     * @return Number of keys resolved.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws IllegalArgumentException {@code keys} contains a malformed
+     *      record.
+     * @see ByteOrder#nativeOrder()
+     */
+    public int getBatch(final ByteBuffer keys, final ByteBuffer valueBuf,
+            final KvdbTransaction txn) throws HseException {
+        int keysLen = 0;
+        int keysPos = 0;
+        if (keys != null) {
+            assert keys.isDirect();
+
+            keysLen = keys.remaining();
+            keysPos = keys.position();
+        }
+
+        int valueBufSz = 0;
+        int valueBufPos = 0;
+        if (valueBuf != null) {
+            assert valueBuf.isDirect();
+
+            valueBufSz = valueBuf.remaining();
+            valueBufPos = valueBuf.position();
+        }
+
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        final long packed = getBatch(this.handle, keys, keysLen, keysPos, valueBuf, valueBufSz,
+            valueBufPos, 0, txnHandle);
+        final int count = (int) packed;
+
+        if (keys != null) {
+            final ByteBuffer records = keys.duplicate().order(ByteOrder.nativeOrder());
+
+            int pos = keysPos;
+            for (int i = 0; i < count; i++) {
+                pos += Integer.BYTES + records.getInt(pos);
+            }
+
+            keys.position(pos);
+        }
+
+        if (valueBuf != null) {
+            valueBuf.limit(valueBufPos + (int) (packed >>> Integer.SIZE));
+        }
+
+        return count;
+    }
+
     /**
      * Get the KVS name.
      *
@@ -1030,6 +1325,42 @@ public final class Kvs extends NativeObject implements AutoCloseable {
         return getParam(this.handle, param);
     }
 
+    /**
+     * Refer to {@link #parallelScan(byte[], int)}.
+     *
+     * <p>{@code filter} defaults to {@code null}.</p>
+     *
+     * @param parallelism Number of ranges to split the scan into.
+     * @return Parallel scan.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public ParallelScan parallelScan(final int parallelism) throws HseException {
+        return parallelScan(null, parallelism);
+    }
+
+    /**
+     * Split a scan of the KVS into ranges which are read in parallel.
+     *
+     * <p>
+     * The boundaries of the ranges are sampled with cursor seeks by this call.
+     * Fewer than {@code parallelism} ranges are created if the keys are too
+     * few or too unevenly spread to fill them.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param filter Iteration limited to keys matching this prefix filter.
+     * @param parallelism Number of ranges to split the scan into.
+     * @return Parallel scan.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws IllegalArgumentException {@code parallelism} is less than 1.
+     * @see ParallelScan
+     */
+    public ParallelScan parallelScan(final byte[] filter, final int parallelism)
+            throws HseException {
+        return new ParallelScan(this, filter, parallelism);
+    }
+
     /**
      * Refer to {@link #prefixDelete(byte[], KvdbTransaction)}.
      *
@@ -1106,12 +1437,12 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #prefixDelete(byte[], KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param pfx Prefix of keys to delete.
      * @param txn Transaction context.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void prefixDelete(final String pfx, final KvdbTransaction txn) throws HseException {
         final long txnHandle = txn == null ? 0 : txn.handle;
@@ -1615,14 +1946,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #put(byte[], byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to put into the KVS.
      * @param value Value associated with {@code key}.
      * @param flags Flags for operation specialization.
      * @param txn Transaction context.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void put(final byte[] key, final String value, final EnumSet<PutFlags> flags,
             final KvdbTransaction txn) throws HseException {
@@ -1680,14 +2011,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #put(byte[], byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to put into the KVS.
      * @param value Value associated with {@code key}.
      * @param flags Flags for operation specialization.
      * @param txn Transaction context.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void put(final String key, final byte[] value, final EnumSet<PutFlags> flags,
             final KvdbTransaction txn) throws HseException {
@@ -1704,14 +2035,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #put(byte[], byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to put into the KVS.
      * @param value Value associated with {@code key}.
      * @param flags Flags for operation specialization.
      * @param txn Transaction context.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void put(final String key, final String value, final EnumSet<PutFlags> flags,
             final KvdbTransaction txn) throws HseException {
@@ -1726,14 +2057,14 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #put(byte[], byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to put into the KVS.
      * @param value Value associated with {@code key}.
      * @param flags Flags for operation specialization.
      * @param txn Transaction context.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void put(final String key, final ByteBuffer value, final EnumSet<PutFlags> flags,
             final KvdbTransaction txn) throws HseException {
@@ -1798,7 +2129,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #put(byte[], byte[], EnumSet, KvdbTransaction)}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1813,7 +2144,7 @@ public final class Kvs extends NativeObject implements AutoCloseable {
      * @param txn Transaction context.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public void put(final ByteBuffer key, final String value,
             final EnumSet<PutFlags> flags, final KvdbTransaction txn) throws HseException {
@@ -1886,6 +2217,258 @@ public final class Kvs extends NativeObject implements AutoCloseable {
             flagsValue, txnHandle);
     }
 
+    /**
+     * Refer to {@link #write(WriteBatch, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param batch Operations to apply.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public void write(final WriteBatch batch) throws HseException {
+        write(batch, null);
+    }
+
+    /**
+     * Apply all operations of a batch to the KVS.
+     *
+     * <p>
+     * Operations are applied in the order they were added to the batch using a
+     * single call into the native library. Applying a batch is not atomic. If
+     * an operation fails, operations before it remain applied, the remaining
+     * operations are not attempted, and {@link WriteBatch#getFailedIndex}
+     * reports the index of the failed operation. Operations added to the batch
+     * without a {@link Kvs} are applied to this KVS. Use
+     * {@link KvdbTransaction#commit(WriteBatch)} to apply a batch atomically.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param batch Operations to apply.
+     * @param txn Transaction context.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public void write(final WriteBatch batch, final KvdbTransaction txn) throws HseException {
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        batch.write(this.handle, txnHandle);
+    }
+
+    /**
+     * Refer to {@link #putAsync(byte[], byte[], EnumSet, KvdbTransaction)}.
+     *
+     * <p>{@code flags} and {@code txn} default to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return Future which completes once the key-value pair has been put.
+     */
+    public CompletableFuture<Void> putAsync(final byte[] key, final byte[] value) {
+        return putAsync(key, value, null, null);
+    }
+
+    /**
+     * Refer to {@link #putAsync(byte[], byte[], EnumSet, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return Future which completes once the key-value pair has been put.
+     */
+    public CompletableFuture<Void> putAsync(final byte[] key, final byte[] value,
+            final EnumSet<PutFlags> flags) {
+        return putAsync(key, value, flags, null);
+    }
+
+    /**
+     * Refer to {@link #putAsync(byte[], byte[], EnumSet, KvdbTransaction)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param txn Transaction context.
+     * @return Future which completes once the key-value pair has been put.
+     */
+    public CompletableFuture<Void> putAsync(final byte[] key, final byte[] value,
+            final KvdbTransaction txn) {
+        return putAsync(key, value, null, txn);
+    }
+
+    /**
+     * Asynchronously put a key-value pair into the KVS.
+     *
+     * <p>
+     * The arguments are copied, and the operation is queued to the pool of
+     * native worker threads, so the calling thread never blocks on HSE. The
+     * returned future is completed by a worker thread, which also runs any
+     * dependent stages that are not given an executor. If the operation
+     * fails, the future is completed exceptionally with an
+     * {@link HseException}.
+     * </p>
+     *
+     * <p>
+     * Puts with {@link PutFlags#PRIO} are queued to a priority lane, and are
+     * run ahead of all other queued operations.
+     * </p>
+     *
+     * <p>
+     * Operations submitted with the same transaction are run one at a time, as
+     * HSE allows only one thread to operate on a transaction at once, but in
+     * no guaranteed order.
+     * </p>
+     *
+     * <p>
+     * Closing the KVS, or committing, aborting, or closing {@code txn}, first
+     * runs the operation on the closing thread if no worker has picked it up
+     * yet, or waits for it otherwise. If {@link Hse#fini()} is in progress,
+     * the future is completed exceptionally with an
+     * {@link IllegalStateException}.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @param txn Transaction context.
+     * @return Future which completes once the key-value pair has been put.
+     * @see #put(byte[], byte[], EnumSet, KvdbTransaction)
+     * @see Hse#setAsyncThreads(int)
+     */
+    public CompletableFuture<Void> putAsync(final byte[] key, final byte[] value,
+            final EnumSet<PutFlags> flags, final KvdbTransaction txn) {
+        final int keyLen = key == null ? 0 : key.length;
+        final int valueLen = value == null ? 0 : value.length;
+        final int flagsValue = flags == null ? 0 : flags.stream()
+            .mapToInt(flag -> 1 << flag.ordinal())
+            .sum();
+        final long txnHandle = txn == null ? 0 : txn.handle;
+
+        return putAsync(this.handle, key, keyLen, value, valueLen, flagsValue, txnHandle);
+    }
+
+    /**
+     * Create a submission and completion ring for the KVS.
+     *
+     * <p>
+     * Each ring owns a native service thread, which runs operations submitted
+     * to the ring until it is closed. The completion queue holds twice as many
+     * entries as the submission queue.
+     * </p>
+     *
+     * <p>
+     * The ring is closed along with the KVS if it has not been closed before.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param buf Buffer which operations refer to by offset. Must be direct.
+     * @param entries Number of submission queue entries. Must be a power of 2.
+     * @return Ring.
+     * @throws IllegalArgumentException {@code buf} is not direct, or
+     *      {@code entries} is not a power of 2.
+     * @see KvsRing
+     */
+    public KvsRing ring(final ByteBuffer buf, final int entries) {
+        final KvsRing ring = new KvsRing(this, buf, entries);
+
+        synchronized (this.rings) {
+            this.rings.add(ring);
+        }
+
+        return ring;
+    }
+
+    /**
+     * Forget a ring which has been closed.
+     *
+     * @param ring Closed ring.
+     */
+    void ringClosed(final KvsRing ring) {
+        synchronized (this.rings) {
+            this.rings.remove(ring);
+        }
+    }
+
+    /**
+     * Refer to {@link #stream(byte[], byte[], KvdbTransaction)}.
+     *
+     * <p>{@code min}, {@code max}, and {@code txn} default to {@code null}.</p>
+     *
+     * @return Stream of records.
+     */
+    public Stream<Map.Entry<byte[], byte[]>> stream() {
+        return stream(null, null, null);
+    }
+
+    /**
+     * Refer to {@link #stream(byte[], byte[], KvdbTransaction)}.
+     *
+     * <p>{@code min} and {@code max} default to {@code null}.</p>
+     *
+     * @param txn Transaction context.
+     * @return Stream of records.
+     */
+    public Stream<Map.Entry<byte[], byte[]>> stream(final KvdbTransaction txn) {
+        return stream(null, null, txn);
+    }
+
+    /**
+     * Refer to {@link #stream(byte[], byte[], KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param min Smallest key of the range, or {@code null} for no lower bound.
+     * @param max Largest key of the range, or {@code null} for no upper bound.
+     * @return Stream of records.
+     */
+    public Stream<Map.Entry<byte[], byte[]>> stream(final byte[] min, final byte[] max) {
+        return stream(min, max, null);
+    }
+
+    /**
+     * Stream the records of the closed key range [{@code min}, {@code max}].
+     *
+     * <p>
+     * Records are read from cursors in batches, and are delivered in key
+     * order. The stream's spliterator is {@link java.util.Spliterator#ORDERED},
+     * {@link java.util.Spliterator#SORTED}, and
+     * {@link java.util.Spliterator#NONNULL}. A parallel stream splits the key
+     * range at interpolated keys, and reads each part through its own cursor,
+     * so each part sees the KVS as of its own first read. A stream in a
+     * transaction is never split, since a transaction may only be used by one
+     * thread at a time.
+     * </p>
+     *
+     * <p>
+     * Cursors are created lazily by the terminal operation, and closed once
+     * their part of the range is read. Close the stream, ideally with
+     * try-with-resources, to close the cursors of a stream which was not read
+     * to the end.
+     * </p>
+     *
+     * <p>
+     * Errors from HSE are thrown as {@link UncheckedHseException} by the
+     * terminal operation and by {@link Stream#close()}.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param min Smallest key of the range, or {@code null} for no lower bound.
+     * @param max Largest key of the range, or {@code null} for no upper bound.
+     * @param txn Transaction context.
+     * @return Stream of records.
+     */
+    public Stream<Map.Entry<byte[], byte[]>> stream(final byte[] min, final byte[] max,
+            final KvdbTransaction txn) {
+        final KvsSpliterator spliterator = new KvsSpliterator(this, min, max, txn);
+
+        return StreamSupport.stream(spliterator, false).onClose(spliterator::close);
+    }
+
     /**
      * {@link Kvs#put(byte[], byte[], EnumSet, KvdbTransaction)} (et al.) flags.
      */
@@ -9,6 +9,7 @@ import java.io.EOFException;
 import java.nio.ByteBuffer;
 import java.util.EnumSet;
 import java.util.Optional;
+import java.util.concurrent.CompletableFuture;
 import java.util.AbstractMap.SimpleImmutableEntry;
 
 /**
@@ -78,6 +79,14 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     private native SimpleImmutableEntry<Integer, Integer> read(long cursorHandle, ByteBuffer keyBuf,
         int keyBufSz, int keyBufPos, ByteBuffer valueBuf, int valueBufSz, int valueBufPos,
         int flags) throws HseException;
+    private native long readCopy(long cursorHandle, ByteBuffer keyBuf, int keyBufSz,
+        ByteBuffer valueBuf, int valueBufSz, int flags) throws HseException;
+    private native boolean readView(long cursorHandle, View view, int flags)
+            throws HseException;
+    private native long readBatch(long cursorHandle, ByteBuffer buf, int bufSz, int bufPos,
+        int maxRecords, int flags) throws HseException;
+    private native CompletableFuture<Long> readBatchAsync(long cursorHandle, ByteBuffer buf,
+        int bufSz, int bufPos, int maxRecords, int flags);
     private native byte[] seek(long cursorHandle, byte[] key, int keyLen, int flags)
             throws HseException;
     private native byte[] seek(long cursorHandle, String key, int flags) throws HseException;
@@ -340,6 +349,190 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
         return entry;
     }
 
+    /**
+     * Read a key-value pair into a reusable entry.
+     *
+     * <p>
+     * Unlike {@link #read()}, this function allocates nothing and does not
+     * throw once the end of the cursor is reached, which makes it suitable for
+     * scanning large numbers of records. The key and value are copied into the
+     * buffers owned by {@code entry}, replacing the previous record.
+     * </p>
+     *
+     * <pre>
+     * final KvsCursor.Entry entry = new KvsCursor.Entry();
+     * while (cursor.read(entry)) {
+     *     process(entry.getKey(), entry.getValue());
+     * }
+     * </pre>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param entry Entry into which the next record will be copied.
+     * @return Whether a record was read. {@code false} means the end of the
+     *      cursor was reached, and {@code entry} is left unchanged.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public boolean read(final Entry entry) throws HseException {
+        final long packed = readCopy(this.handle, entry.key, entry.key.capacity(), entry.value,
+            entry.value.capacity(), 0);
+        if (packed == -1) {
+            return false;
+        }
+
+        entry.update((int) (packed >>> Integer.SIZE), (int) packed);
+
+        return true;
+    }
+
+    /**
+     * Read a key-value pair as views onto memory owned by HSE.
+     *
+     * <p>
+     * The key and value are not copied. Instead, {@code view} is updated with
+     * read-only direct buffers which point into HSE. The buffers are only valid
+     * until the next operation on this cursor, including reads, seeks, view
+     * updates, and {@link #close()}. Accessing them afterwards results in
+     * undefined behavior, so copy any data which must outlive the current
+     * record.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param view View to update with the next record.
+     * @return Whether a record was read. {@code false} means the end of the
+     *      cursor was reached, and {@code view} is left unchanged.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public boolean read(final View view) throws HseException {
+        return readView(this.handle, view, 0);
+    }
+
+    /**
+     * Read many key-value pairs from the cursor with a single call into HSE.
+     *
+     * <p>
+     * Records are read until {@code maxRecords} have been read, the next
+     * record does not fit in {@code buf}, or the end of the cursor is reached.
+     * Each record is written as {@code [int32 key length][int32 value length]}
+     * followed by the key and the value. Lengths are in
+     * {@link java.nio.ByteOrder#nativeOrder}. A record which does not fit is
+     * not consumed, and is returned by the next read.
+     * </p>
+     *
+     * <p>
+     * If the next record does not fit in an empty {@code buf}, zero is
+     * returned. A buffer of
+     * {@code 2 * Integer.BYTES + Limits.KVS_KEY_LEN_MAX + Limits.KVS_VALUE_LEN_MAX}
+     * bytes always fits at least one record.
+     * </p>
+     *
+     * <p>Any {@link ByteBuffer} arguments must be direct.</p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param buf Buffer into which records will be written.
+     *      {@link ByteBuffer#limit(int)} will be called with the end of the
+     *      last record written.
+     * @param maxRecords Maximum number of records to read.
+     * @return Number of records written, or -1 if the end of the cursor was
+     *      reached before any record was written.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public int readBatch(final ByteBuffer buf, final int maxRecords) throws HseException {
+        assert buf.isDirect();
+
+        final int bufSz = buf.remaining();
+        final int bufPos = buf.position();
+
+        final long packed = readBatch(this.handle, buf, bufSz, bufPos, maxRecords, 0);
+
+        buf.limit(bufPos + (int) (packed >>> Integer.SIZE));
+
+        return (int) packed;
+    }
+
+    /**
+     * Asynchronously read a batch of records.
+     *
+     * <p>
+     * Behaves like {@link #readBatch(ByteBuffer, int)}, except that the read
+     * is queued to the pool of native worker threads. {@code buf} is written
+     * to, and {@link ByteBuffer#limit(int)} is called on it, by a worker
+     * thread, so it must not be used until the returned future completes.
+     * If the read fails, the future is completed exceptionally with an
+     * {@link HseException}. If the cursor is closed first, the read is run on
+     * the closing thread, or waited for if a worker is already running it.
+     * </p>
+     *
+     * <p>
+     * No other operation may be performed on the cursor until the returned
+     * future completes.
+     * </p>
+     *
+     * <p>Any {@link ByteBuffer} arguments must be direct.</p>
+     *
+     * @param buf Buffer into which records will be written.
+     * @param maxRecords Maximum number of records to read.
+     * @return Future which completes with the number of records written, or
+     *      -1 if the end of the cursor was reached before any record was
+     *      written.
+     * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
+     * @see Hse#setAsyncThreads(int)
+     */
+    public CompletableFuture<Integer> readBatchAsync(final ByteBuffer buf, final int maxRecords) {
+        assert buf.isDirect();
+
+        final int bufSz = buf.remaining();
+        final int bufPos = buf.position();
+
+        // The stage keeps buf reachable until the worker is done with it.
+        return readBatchAsync(this.handle, buf, bufSz, bufPos, maxRecords, 0)
+            .thenApply(packed -> {
+                buf.limit(bufPos + (int) (packed >>> Integer.SIZE));
+
+                return (int) packed.longValue();
+            });
+    }
+
+    /**
+     * Refer to {@link #prefetch(int, int)}.
+     *
+     * <p>
+     * {@code bufSz} defaults to
+     * {@code 2 * Integer.BYTES + Limits.KVS_KEY_LEN_MAX + Limits.KVS_VALUE_LEN_MAX},
+     * which always fits at least one record.
+     * </p>
+     *
+     * @param buffers Number of batch buffers.
+     * @return Prefetching cursor.
+     */
+    public PrefetchingCursor prefetch(final int buffers) {
+        return prefetch(buffers, 2 * Integer.BYTES + Limits.KVS_KEY_LEN_MAX
+            + Limits.KVS_VALUE_LEN_MAX);
+    }
+
+    /**
+     * Read ahead of the consumer in the background.
+     *
+     * <p>
+     * Batches are read into {@code buffers} direct buffers of {@code bufSz}
+     * bytes each, so up to {@code buffers - 1} batches are read ahead while
+     * one is consumed. The first read is queued by this call.
+     * </p>
+     *
+     * @param buffers Number of batch buffers.
+     * @param bufSz Size of each batch buffer in bytes.
+     * @return Prefetching cursor.
+     * @throws IllegalArgumentException {@code buffers} is less than 1.
+     * @see PrefetchingCursor
+     * @see Hse#setAsyncThreads(int)
+     */
+    public PrefetchingCursor prefetch(final int buffers, final int bufSz) {
+        return new PrefetchingCursor(this, buffers, bufSz);
+    }
+
     /**
      * Refer to {@link #seek(byte[], byte[])}.
      *
@@ -356,12 +549,12 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seek(byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to find.
      * @return Next key in sequence.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seek(final String key) throws HseException {
         return Optional.ofNullable(seek(this.handle, key, 0));
@@ -471,13 +664,13 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seek(byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param key Key to find.
      * @param foundBuf Next key in sequence.
      * @return Length of the found key.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seek(final String key, final byte[] foundBuf) throws HseException {
         final int foundBufSz = foundBuf == null ? 0 : foundBuf.length;
@@ -494,7 +687,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seek(byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -510,7 +703,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seek(final String key, final ByteBuffer foundBuf)
             throws HseException {
@@ -579,7 +772,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seek(byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -595,7 +788,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seek(final ByteBuffer key, final ByteBuffer foundBuf)
             throws HseException {
@@ -653,13 +846,13 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @return Next key in sequence.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seekRange(final byte[] filterMin, final String filterMax)
             throws HseException {
@@ -706,13 +899,13 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @return Next key in sequence.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seekRange(final String filterMin, final byte[] filterMax)
             throws HseException {
@@ -724,13 +917,13 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @return Next key in sequence.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seekRange(final String filterMin, final String filterMax)
             throws HseException {
@@ -740,7 +933,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -754,7 +947,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Next key in sequence.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seekRange(final String filterMin, final ByteBuffer filterMax)
             throws HseException {
@@ -811,7 +1004,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -825,7 +1018,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Next key in sequence.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<byte[]> seekRange(final ByteBuffer filterMin, final String filterMax)
             throws HseException {
@@ -975,14 +1168,14 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @param foundBuf Next key in sequence.
      * @return Length of the found key.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final byte[] filterMin, final String filterMax,
             final byte[] foundBuf) throws HseException {
@@ -1002,7 +1195,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1019,7 +1212,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final byte[] filterMin, final String filterMax,
             final ByteBuffer foundBuf) throws HseException {
@@ -1152,14 +1345,14 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @param foundBuf Next key in sequence.
      * @return Length of the found key.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final byte[] filterMax,
             final byte[] foundBuf) throws HseException {
@@ -1179,7 +1372,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1196,7 +1389,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final byte[] filterMax,
             final ByteBuffer foundBuf) throws HseException {
@@ -1228,14 +1421,14 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * @param filterMin Filter minimum.
      * @param filterMax Filter maximum.
      * @param foundBuf Next key in sequence.
      * @return Length of the found key.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final String filterMax,
             final byte[] foundBuf) throws HseException {
@@ -1253,7 +1446,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1270,7 +1463,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final String filterMax,
             final ByteBuffer foundBuf) throws HseException {
@@ -1300,7 +1493,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1315,7 +1508,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final ByteBuffer filterMax,
             final byte[] foundBuf) throws HseException {
@@ -1345,7 +1538,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1362,7 +1555,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final String filterMin, final ByteBuffer filterMax,
             final ByteBuffer foundBuf) throws HseException {
@@ -1503,7 +1696,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1518,7 +1711,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final ByteBuffer filterMin, final String filterMax,
             final byte[] foundBuf) throws HseException {
@@ -1548,7 +1741,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
     /**
      * Refer to {@link #seekRange(byte[], byte[], byte[])}.
      *
-     * <p>Any {@link String} arguments are converted to modified UTF-8.</p>
+     * <p>Any {@link String} arguments are encoded as UTF-8.</p>
      *
      * <p>Any {@link ByteBuffer} arguments must be direct.</p>
      *
@@ -1565,7 +1758,7 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * @return Length of the found key.
      * @throws AssertionError All {@link ByteBuffer} parameters must be direct.
      * @throws HseException Underlying C function returned a non-zero value.
-     * @see <a href="https://docs.oracle.com/javase/8/docs/api/java/io/DataInput.html#modified-utf-8">Modified UTF-8</a>
+     * @see java.nio.charset.StandardCharsets#UTF_8
      */
     public Optional<Integer> seekRange(final ByteBuffer filterMin, final String filterMax,
             final ByteBuffer foundBuf) throws HseException {
@@ -1742,6 +1935,12 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
      * Destroy cursor.
      *
      * <p>
+     * An asynchronous read which is still queued is run on the calling
+     * thread, and one being run by a worker is waited for, before the cursor
+     * is destroyed.
+     * </p>
+     *
+     * <p>
      * After invoking this function, calling any other cursor functions with
      * this handle will result in undefined behavior.
      * </p>
@@ -1756,6 +1955,143 @@ public final class KvsCursor extends NativeObject implements AutoCloseable {
         }
     }
 
+    /**
+     * Reusable key-value pair filled in by {@link KvsCursor#read(Entry)}.
+     *
+     * <p>
+     * The key and value buffers are allocated once, and overwritten by every
+     * read. If a key or value is larger than its buffer, it is truncated, and
+     * the full length is still reported.
+     * </p>
+     *
+     * <p>This class is not thread safe.</p>
+     */
+    public static final class Entry {
+        /** Buffer holding the key. */
+        private final ByteBuffer key;
+        /** Buffer holding the value. */
+        private final ByteBuffer value;
+        /** Length of the key. */
+        private int keyLength;
+        /** Length of the value. */
+        private int valueLength;
+
+        /**
+         * Create an entry which can hold any key and value without truncation.
+         */
+        public Entry() {
+            this(Limits.KVS_KEY_LEN_MAX, Limits.KVS_VALUE_LEN_MAX);
+        }
+
+        /**
+         * Create an entry.
+         *
+         * @param keyCapacity Size of the key buffer in bytes.
+         * @param valueCapacity Size of the value buffer in bytes.
+         */
+        public Entry(final int keyCapacity, final int valueCapacity) {
+            this.key = ByteBuffer.allocateDirect(keyCapacity);
+            this.value = ByteBuffer.allocateDirect(valueCapacity);
+            this.key.limit(0);
+            this.value.limit(0);
+        }
+
+        void update(final int newKeyLength, final int newValueLength) {
+            this.keyLength = newKeyLength;
+            this.valueLength = newValueLength;
+
+            this.key.clear();
+            this.key.limit(Math.min(this.key.capacity(), newKeyLength));
+            this.value.clear();
+            this.value.limit(Math.min(this.value.capacity(), newValueLength));
+        }
+
+        /**
+         * Get the key.
+         *
+         * <p>
+         * The returned buffer is owned by the entry. Its position and limit are
+         * reset by every read.
+         * </p>
+         *
+         * @return Key, possibly truncated to the key buffer's capacity.
+         */
+        public ByteBuffer getKey() {
+            return this.key;
+        }
+
+        /**
+         * Get the length of the key.
+         *
+         * @return Length of the key, which may exceed the key buffer's capacity.
+         */
+        public int getKeyLength() {
+            return this.keyLength;
+        }
+
+        /**
+         * Get the value.
+         *
+         * <p>
+         * The returned buffer is owned by the entry. Its position and limit are
+         * reset by every read.
+         * </p>
+         *
+         * @return Value, possibly truncated to the value buffer's capacity.
+         */
+        public ByteBuffer getValue() {
+            return this.value;
+        }
+
+        /**
+         * Get the length of the value.
+         *
+         * @return Length of the value, which may exceed the value buffer's
+         *      capacity.
+         */
+        public int getValueLength() {
+            return this.valueLength;
+        }
+    }
+
+    /**
+     * Key-value pair whose buffers point into memory owned by HSE. Filled in by
+     * {@link KvsCursor#read(View)}.
+     *
+     * <p>This class is not thread safe.</p>
+     */
+    public static final class View {
+        /** Read-only view of the key. */
+        private ByteBuffer key;
+        /** Read-only view of the value. */
+        private ByteBuffer value;
+
+        void update(final ByteBuffer newKey, final ByteBuffer newValue) {
+            this.key = newKey;
+            this.value = newValue;
+        }
+
+        /**
+         * Get the key.
+         *
+         * @return Read-only view of the key, or {@code null} if nothing has been
+         *      read yet.
+         */
+        public ByteBuffer getKey() {
+            return this.key;
+        }
+
+        /**
+         * Get the value.
+         *
+         * @return Read-only view of the value, or {@code null} if nothing has
+         *      been read yet.
+         */
+        public ByteBuffer getValue() {
+            return this.value;
+        }
+    }
+
     /**
      * {@link Kvs#cursor(byte[], EnumSet, KvdbTransaction)} (et al.) flags.
      */
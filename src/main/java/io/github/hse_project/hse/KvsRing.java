@@ -0,0 +1,391 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.EnumSet;
+
+import io.github.hse_project.hse.Kvs.PutFlags;
+
+/**
+ * Submission and completion ring for KVS operations.
+ *
+ * <p>
+ * Operations are described by entries written into a submission queue in
+ * memory shared with a native service thread, which runs them and posts the
+ * results to a completion queue in the same memory. Keys and values are not
+ * passed by reference, but as offsets into a direct buffer registered when
+ * the ring is created. Once the service thread is running, neither submitting
+ * nor reaping an operation crosses JNI, except to wake the service thread
+ * after it has gone idle.
+ * </p>
+ *
+ * <pre>{@code
+ * try (KvsRing ring = kvs.ring(buf, 64)) {
+ *     ring.prepareGet(1, keyOff, keyLen, valueOff, valueBufSz, null);
+ *     ring.submit();
+ *
+ *     final KvsRing.Completion completion = new KvsRing.Completion();
+ *     while (!ring.poll(completion)) {
+ *         // Do something useful.
+ *     }
+ * }
+ * }</pre>
+ *
+ * <p>
+ * Registered memory must not be modified while an operation which refers to
+ * it is in flight. Likewise, every operation prepared with a transaction must
+ * have been reaped before that transaction is committed, aborted, or closed,
+ * as the service thread holds the native transaction.
+ * </p>
+ *
+ * <p>This class is not thread safe.</p>
+ */
+public final class KvsRing extends NativeObject implements AutoCloseable {
+    /** Offset of the submission queue head, written by the service thread. */
+    private static final int SQ_HEAD_OFFSET = 0;
+    /** Offset of the submission queue tail, written by Java. */
+    private static final int SQ_TAIL_OFFSET = 64;
+    /** Offset of the completion queue head, written by Java. */
+    private static final int CQ_HEAD_OFFSET = 128;
+    /** Offset of the completion queue tail, written by the service thread. */
+    private static final int CQ_TAIL_OFFSET = 192;
+    /** Offset of the service thread's flags. */
+    private static final int FLAGS_OFFSET = 256;
+    /** Offset of the submission queue entries. */
+    private static final int SQES_OFFSET = 320;
+    /** Size of a submission queue entry. */
+    private static final int SQE_SZ = 48;
+    /** Size of a completion queue entry. */
+    private static final int CQE_SZ = 24;
+
+    /** Offset of the opcode within a submission queue entry. */
+    private static final int SQE_OPCODE_OFFSET = 0;
+    /** Offset of the flags within a submission queue entry. */
+    private static final int SQE_FLAGS_OFFSET = 4;
+    /** Offset of the user data within a submission queue entry. */
+    private static final int SQE_USER_DATA_OFFSET = 8;
+    /** Offset of the transaction within a submission queue entry. */
+    private static final int SQE_TXN_OFFSET = 16;
+    /** Offset of the key offset within a submission queue entry. */
+    private static final int SQE_KEY_OFF_OFFSET = 24;
+    /** Offset of the key length within a submission queue entry. */
+    private static final int SQE_KEY_LEN_OFFSET = 28;
+    /** Offset of the value offset within a submission queue entry. */
+    private static final int SQE_VALUE_OFF_OFFSET = 32;
+    /** Offset of the value length within a submission queue entry. */
+    private static final int SQE_VALUE_LEN_OFFSET = 36;
+
+    /** Offset of the user data within a completion queue entry. */
+    private static final int CQE_USER_DATA_OFFSET = 0;
+    /** Offset of the error within a completion queue entry. */
+    private static final int CQE_ERR_OFFSET = 8;
+    /** Offset of the result within a completion queue entry. */
+    private static final int CQE_RES_OFFSET = 16;
+
+    /** Delete opcode. */
+    private static final int OP_DELETE = 0;
+    /** Get opcode. */
+    private static final int OP_GET = 1;
+    /** Put opcode. */
+    private static final int OP_PUT = 2;
+
+    /**
+     * Set by the service thread when it must be woken up to see new entries,
+     * or room in the completion queue.
+     */
+    private static final int FLAG_NEED_WAKEUP = 1;
+
+    /** Result of a get for a key which was not found. */
+    private static final long RES_NOT_FOUND = -1;
+    /** Result of an entry whose offsets did not fit the registered buffer. */
+    private static final long RES_INVALID = -2;
+
+    /** Largest number of submission queue entries. */
+    private static final int ENTRIES_MAX = 1 << 15;
+
+    /** KVS the operations run on, which closes the ring before itself. */
+    private final Kvs kvs;
+    /** Registered buffer, kept reachable for the service thread. */
+    private final ByteBuffer buf;
+    /** Memory shared with the service thread. */
+    private ByteBuffer shared;
+    /** Number of submission queue entries. */
+    private final int sqEntries;
+    /** Number of completion queue entries. */
+    private final int cqEntries;
+    /** Offset of the completion queue entries. */
+    private final int cqesOffset;
+    /** Next submission queue entry to prepare. */
+    private int sqTail;
+    /** Submission queue tail last made visible to the service thread. */
+    private int sqTailPublished;
+    /** Submission queue head last read from the service thread. */
+    private int sqHeadCached;
+    /** Next completion queue entry to reap. */
+    private int cqHead;
+    /** Completion queue head last made visible to the service thread. */
+    private int cqHeadPublished;
+    /** Completion queue tail last read from the service thread. */
+    private int cqTailCached;
+
+    KvsRing(final Kvs kvs, final ByteBuffer buf, final int entries) {
+        if (!buf.isDirect()) {
+            throw new IllegalArgumentException("Registered buffer must be direct");
+        }
+        if (entries < 1 || entries > ENTRIES_MAX || Integer.bitCount(entries) != 1) {
+            throw new IllegalArgumentException(
+                "entries must be a power of 2 no larger than " + ENTRIES_MAX);
+        }
+
+        this.kvs = kvs;
+        this.buf = buf;
+        this.sqEntries = entries;
+        this.cqEntries = 2 * entries;
+        this.cqesOffset = SQES_OFFSET + entries * SQE_SZ;
+        this.handle = create(kvs.handle, buf, buf.capacity(), entries);
+        this.shared = shared(this.handle).order(ByteOrder.nativeOrder());
+    }
+
+    private native long create(long kvsHandle, ByteBuffer registered, int registeredSz,
+        int entries);
+    private native void destroy(long ringHandle);
+    private native ByteBuffer shared(long ringHandle);
+    private native void wakeup(long ringHandle);
+    private static native void check(long err) throws HseException;
+
+    private boolean prepare(final int opcode, final int flags, final long userData,
+            final KvdbTransaction txn, final int keyOff, final int keyLen, final int valueOff,
+            final int valueLen) {
+        if (this.sqTail - this.sqHeadCached == this.sqEntries) {
+            this.sqHeadCached = this.shared.getInt(SQ_HEAD_OFFSET);
+            Fences.acquire();
+            if (this.sqTail - this.sqHeadCached == this.sqEntries) {
+                return false;
+            }
+        }
+
+        final int sqe = SQES_OFFSET + (this.sqTail & (this.sqEntries - 1)) * SQE_SZ;
+
+        this.shared.putInt(sqe + SQE_OPCODE_OFFSET, opcode);
+        this.shared.putInt(sqe + SQE_FLAGS_OFFSET, flags);
+        this.shared.putLong(sqe + SQE_USER_DATA_OFFSET, userData);
+        this.shared.putLong(sqe + SQE_TXN_OFFSET, txn == null ? 0 : txn.handle);
+        this.shared.putInt(sqe + SQE_KEY_OFF_OFFSET, keyOff);
+        this.shared.putInt(sqe + SQE_KEY_LEN_OFFSET, keyLen);
+        this.shared.putInt(sqe + SQE_VALUE_OFF_OFFSET, valueOff);
+        this.shared.putInt(sqe + SQE_VALUE_LEN_OFFSET, valueLen);
+
+        this.sqTail++;
+
+        return true;
+    }
+
+    /**
+     * Prepare a delete of a key in the registered buffer.
+     *
+     * @param userData Value returned in the operation's completion.
+     * @param keyOff Offset of the key in the registered buffer.
+     * @param keyLen Length of the key.
+     * @param txn Transaction context.
+     * @return Whether there was room in the submission queue.
+     * @see Kvs#delete(byte[], KvdbTransaction)
+     */
+    public boolean prepareDelete(final long userData, final int keyOff, final int keyLen,
+            final KvdbTransaction txn) {
+        return prepare(OP_DELETE, 0, userData, txn, keyOff, keyLen, 0, 0);
+    }
+
+    /**
+     * Prepare a get of a key in the registered buffer.
+     *
+     * <p>
+     * The value is copied into the registered buffer at {@code valueOff}, and
+     * truncated to {@code valueBufSz} bytes.
+     * </p>
+     *
+     * @param userData Value returned in the operation's completion.
+     * @param keyOff Offset of the key in the registered buffer.
+     * @param keyLen Length of the key.
+     * @param valueOff Offset in the registered buffer to copy the value to.
+     * @param valueBufSz Number of bytes available at {@code valueOff}.
+     * @param txn Transaction context.
+     * @return Whether there was room in the submission queue.
+     * @see Kvs#get(byte[], byte[], KvdbTransaction)
+     */
+    public boolean prepareGet(final long userData, final int keyOff, final int keyLen,
+            final int valueOff, final int valueBufSz, final KvdbTransaction txn) {
+        return prepare(OP_GET, 0, userData, txn, keyOff, keyLen, valueOff, valueBufSz);
+    }
+
+    /**
+     * Prepare a put of a key-value pair in the registered buffer.
+     *
+     * @param userData Value returned in the operation's completion.
+     * @param keyOff Offset of the key in the registered buffer.
+     * @param keyLen Length of the key.
+     * @param valueOff Offset of the value in the registered buffer.
+     * @param valueLen Length of the value.
+     * @param flags Flags for operation specialization.
+     * @param txn Transaction context.
+     * @return Whether there was room in the submission queue.
+     * @see Kvs#put(byte[], byte[], EnumSet, KvdbTransaction)
+     */
+    public boolean preparePut(final long userData, final int keyOff, final int keyLen,
+            final int valueOff, final int valueLen, final EnumSet<PutFlags> flags,
+            final KvdbTransaction txn) {
+        final int flagsValue = flags == null ? 0 : flags.stream()
+            .mapToInt(flag -> 1 << flag.ordinal())
+            .sum();
+
+        return prepare(OP_PUT, flagsValue, userData, txn, keyOff, keyLen, valueOff, valueLen);
+    }
+
+    /**
+     * Make all prepared operations visible to the service thread.
+     *
+     * @return Number of operations submitted.
+     */
+    public int submit() {
+        final int submitted = this.sqTail - this.sqTailPublished;
+        if (submitted == 0) {
+            return 0;
+        }
+
+        Fences.release();
+        this.shared.putInt(SQ_TAIL_OFFSET, this.sqTail);
+        this.sqTailPublished = this.sqTail;
+
+        /* The service thread sets the flag and then re-reads the tail, so one
+         * side or the other is guaranteed to notice.
+         */
+        Fences.full();
+        if ((this.shared.getInt(FLAGS_OFFSET) & FLAG_NEED_WAKEUP) != 0) {
+            wakeup(this.handle);
+        }
+
+        return submitted;
+    }
+
+    /**
+     * Reap a completed operation, if there is one.
+     *
+     * <p>
+     * Operations complete in the order they were submitted, but completions
+     * must be reaped, otherwise the service thread stalls once the completion
+     * queue is full.
+     * </p>
+     *
+     * @param completion Completion to fill in.
+     * @return Whether an operation had completed.
+     */
+    public boolean poll(final Completion completion) {
+        if (this.cqHead == this.cqTailCached) {
+            // Hand the reaped entries back before looking for more.
+            if (this.cqHeadPublished != this.cqHead) {
+                Fences.release();
+                this.shared.putInt(CQ_HEAD_OFFSET, this.cqHead);
+                this.cqHeadPublished = this.cqHead;
+
+                // The service thread may be asleep on a full completion queue.
+                Fences.full();
+                if ((this.shared.getInt(FLAGS_OFFSET) & FLAG_NEED_WAKEUP) != 0) {
+                    wakeup(this.handle);
+                }
+            }
+
+            this.cqTailCached = this.shared.getInt(CQ_TAIL_OFFSET);
+            Fences.acquire();
+            if (this.cqHead == this.cqTailCached) {
+                return false;
+            }
+        }
+
+        final int cqe = this.cqesOffset + (this.cqHead & (this.cqEntries - 1)) * CQE_SZ;
+
+        completion.userData = this.shared.getLong(cqe + CQE_USER_DATA_OFFSET);
+        completion.err = this.shared.getLong(cqe + CQE_ERR_OFFSET);
+        completion.res = this.shared.getLong(cqe + CQE_RES_OFFSET);
+
+        this.cqHead++;
+
+        return true;
+    }
+
+    /**
+     * Get the registered buffer.
+     *
+     * @return Registered buffer.
+     */
+    public ByteBuffer getBuffer() {
+        return this.buf;
+    }
+
+    /**
+     * Destroy the ring.
+     *
+     * <p>
+     * Operations which have been submitted still run, but their completions
+     * are discarded. Prepared operations which have not been submitted are
+     * not run. Closing the {@link Kvs} closes its rings the same way.
+     * </p>
+     */
+    @Override
+    public void close() {
+        if (this.handle != 0) {
+            destroy(this.handle);
+            this.handle = 0;
+            this.shared = null;
+            this.kvs.ringClosed(this);
+        }
+    }
+
+    /**
+     * Result of an operation reaped by {@link KvsRing#poll(Completion)}.
+     *
+     * <p>This class is not thread safe.</p>
+     */
+    public static final class Completion {
+        /** User data of the operation. */
+        private long userData;
+        /** HSE error of the operation. */
+        private long err;
+        /** Result of the operation. */
+        private long res;
+
+        /**
+         * Get the user data the operation was prepared with.
+         *
+         * @return User data.
+         */
+        public long getUserData() {
+            return this.userData;
+        }
+
+        /**
+         * Get the result of the operation.
+         *
+         * @return For gets, the length of the value, or -1 if the key was not
+         *      found. For other operations, 0.
+         * @throws HseException Underlying C function returned a non-zero value.
+         * @throws IllegalArgumentException Offsets and lengths of the operation
+         *      were not within the registered buffer.
+         */
+        public long getResult() throws HseException {
+            if (this.err != 0) {
+                check(this.err);
+            }
+            if (this.res == RES_INVALID) {
+                throw new IllegalArgumentException("Operation is out of registered buffer bounds");
+            }
+
+            assert this.res >= RES_NOT_FOUND;
+
+            return this.res;
+        }
+    }
+}
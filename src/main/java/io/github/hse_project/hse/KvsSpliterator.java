@@ -0,0 +1,335 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.AbstractMap.SimpleImmutableEntry;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.EnumSet;
+import java.util.Map;
+import java.util.Queue;
+import java.util.Set;
+import java.util.Spliterator;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.function.Consumer;
+
+/**
+ * Spliterator over the records of a key range of a KVS.
+ *
+ * <p>
+ * Records are read from a cursor in batches, so crossing into native code is
+ * paid once per batch rather than once per record. A spliterator which has
+ * not started reading splits its range in two at a key interpolated between
+ * its first and last keys, the same way {@link ParallelScan} places its
+ * boundaries. Each part reads through its own cursor, bounded by
+ * {@link KvsCursor#seekRange(byte[], byte[])} so that no batch reads past
+ * the part.
+ * </p>
+ *
+ * <p>
+ * Every cursor opened by a spliterator or any of its splits is closed once
+ * its part of the range is exhausted, or at the latest by {@link #close()}.
+ * </p>
+ */
+final class KvsSpliterator implements Spliterator<Map.Entry<byte[], byte[]>> {
+    /** Orders records by key, as HSE does. */
+    static final Comparator<Map.Entry<byte[], byte[]>> COMPARATOR =
+        (a, b) -> ParallelScan.compare(a.getKey(), b.getKey());
+
+    /** Initial size of a batch buffer. */
+    private static final int BATCH_BUF_SZ = 64 * 1024;
+    /** Size a batch buffer grows to when a record does not fit, which always fits one. */
+    private static final int BATCH_BUF_SZ_MAX = 2 * Integer.BYTES + Limits.KVS_KEY_LEN_MAX
+        + Limits.KVS_VALUE_LEN_MAX;
+    /** Filter minimum of a range which starts at the beginning of the KVS. */
+    private static final byte[] KEY_MIN = new byte[0];
+
+    /** KVS to read. */
+    private final Kvs kvs;
+    /** Transaction context, which disables splitting. */
+    private final KvdbTransaction txn;
+    /** Inclusive upper bound of the stream, or null. */
+    private final byte[] max;
+    /** Cursors opened by this spliterator and its splits. */
+    private final Cursors cursors;
+    /** Inclusive lower bound, or null for the start of the KVS. */
+    private byte[] lo;
+    /** Exclusive upper bound set by a split, or null. */
+    private byte[] hi;
+    /** Last key at most {@link #max}, found when first splitting without {@link #hi}. */
+    private byte[] last;
+    /** Number of times the range has been halved. */
+    private int depth;
+    /** Cursor, opened by the first read. */
+    private KvsCursor cursor;
+    /** Batch buffer, taken by the first read. */
+    private ByteBuffer buf;
+    /** Number of records left in {@link #buf}. */
+    private int pending;
+    /** Whether the range has been exhausted. */
+    private boolean done;
+
+    KvsSpliterator(final Kvs kvs, final byte[] min, final byte[] max,
+            final KvdbTransaction txn) {
+        this(kvs, txn, new Cursors(), min == null ? null : min.clone(), null,
+            max == null ? null : max.clone(), 0);
+    }
+
+    private KvsSpliterator(final Kvs kvs, final KvdbTransaction txn, final Cursors cursors,
+            final byte[] lo, final byte[] hi, final byte[] max, final int depth) {
+        this.kvs = kvs;
+        this.txn = txn;
+        this.cursors = cursors;
+        this.lo = lo;
+        this.hi = hi;
+        this.max = max;
+        this.depth = depth;
+    }
+
+    private boolean inRange(final byte[] key) {
+        return (this.hi == null || ParallelScan.compare(key, this.hi) < 0)
+            && (this.max == null || ParallelScan.compare(key, this.max) <= 0);
+    }
+
+    /**
+     * Find the first key of a cursor.
+     *
+     * @param flags Flags of the cursor.
+     * @param target Key to seek to first, or null.
+     * @return Key, or null if the cursor is empty.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    private byte[] bound(final EnumSet<KvsCursor.CreateFlags> flags, final byte[] target)
+            throws HseException {
+        try (KvsCursor c = this.kvs.cursor((byte[]) null, flags, this.txn)) {
+            if (target != null) {
+                c.seek(target);
+            }
+
+            final KvsCursor.View view = new KvsCursor.View();
+            if (!c.read(view)) {
+                return null;
+            }
+
+            final byte[] key = new byte[view.getKey().remaining()];
+            view.getKey().get(key);
+
+            return key;
+        }
+    }
+
+    private void finish() throws HseException {
+        this.done = true;
+        this.pending = 0;
+
+        if (this.buf != null) {
+            this.cursors.recycle(this.buf);
+            this.buf = null;
+        }
+
+        if (this.cursor != null) {
+            final KvsCursor c = this.cursor;
+            this.cursor = null;
+            this.cursors.release(c);
+        }
+    }
+
+    private boolean fill() throws HseException {
+        while (!this.done && this.pending == 0) {
+            if (this.cursor == null) {
+                this.cursor = this.cursors.open(this.kvs, this.txn);
+                this.buf = this.cursors.buffer();
+
+                // The maximum of seekRange() is inclusive, so hi is skipped by inRange().
+                final byte[] upper = this.hi == null ? this.max : this.hi;
+                if (upper != null) {
+                    this.cursor.seekRange(this.lo == null ? KEY_MIN : this.lo, upper);
+                } else if (this.lo != null) {
+                    this.cursor.seek(this.lo);
+                }
+            }
+
+            this.buf.clear();
+            final int records = this.cursor.readBatch(this.buf, Integer.MAX_VALUE);
+            if (records < 0) {
+                finish();
+            } else if (records == 0) {
+                // The next record does not fit in an empty buffer.
+                this.buf = ByteBuffer.allocateDirect(BATCH_BUF_SZ_MAX)
+                    .order(ByteOrder.nativeOrder());
+            } else {
+                this.pending = records;
+            }
+        }
+
+        return !this.done;
+    }
+
+    @Override
+    public boolean tryAdvance(final Consumer<? super Map.Entry<byte[], byte[]>> action) {
+        try {
+            if (!fill()) {
+                return false;
+            }
+
+            final byte[] key = new byte[this.buf.getInt()];
+            final byte[] value = new byte[this.buf.getInt()];
+
+            this.buf.get(key).get(value);
+            this.pending--;
+
+            if (!inRange(key)) {
+                finish();
+                return false;
+            }
+
+            action.accept(new SimpleImmutableEntry<>(key, value));
+
+            return true;
+        } catch (final HseException e) {
+            throw new UncheckedHseException(e);
+        }
+    }
+
+    @Override
+    public Spliterator<Map.Entry<byte[], byte[]>> trySplit() {
+        // Only one thread at a time may use a transaction.
+        if (this.txn != null || this.cursor != null || this.done) {
+            return null;
+        }
+
+        final byte[] upper;
+        try {
+            if (this.lo == null) {
+                this.lo = bound(null, null);
+                if (this.lo == null) {
+                    return null;
+                }
+            }
+
+            if (this.hi == null && this.last == null) {
+                this.last = bound(EnumSet.of(KvsCursor.CreateFlags.REV), this.max);
+            }
+            upper = this.hi == null ? this.last : this.hi;
+        } catch (final HseException e) {
+            throw new UncheckedHseException(e);
+        }
+
+        if (upper == null || ParallelScan.compare(this.lo, upper) >= 0) {
+            return null;
+        }
+
+        // Short or nearly equal keys may leave no room between the bounds.
+        final byte[] mid = ParallelScan.interpolate(this.lo, upper, 1, 2);
+        if (ParallelScan.compare(mid, this.lo) <= 0 || ParallelScan.compare(mid, upper) >= 0) {
+            return null;
+        }
+
+        final KvsSpliterator prefix = new KvsSpliterator(this.kvs, this.txn, this.cursors,
+            this.lo, mid, this.max, ++this.depth);
+        this.lo = mid;
+
+        return prefix;
+    }
+
+    /**
+     * Unknown, but halved by every split so that parallel streams stop
+     * splitting after a few levels.
+     *
+     * @return Estimated number of records.
+     */
+    @Override
+    public long estimateSize() {
+        return this.done ? 0 : Long.MAX_VALUE >>> this.depth;
+    }
+
+    @Override
+    public int characteristics() {
+        return ORDERED | SORTED | NONNULL;
+    }
+
+    @Override
+    public Comparator<? super Map.Entry<byte[], byte[]>> getComparator() {
+        return COMPARATOR;
+    }
+
+    /**
+     * Close every cursor still open by this spliterator or its splits.
+     *
+     * @throws UncheckedHseException Closing a cursor failed.
+     */
+    void close() {
+        try {
+            this.cursors.close();
+        } catch (final HseException e) {
+            throw new UncheckedHseException(e);
+        }
+    }
+
+    /** Cursors and batch buffers shared by a spliterator and its splits. */
+    private static final class Cursors {
+        /** Open cursors. */
+        private final Set<KvsCursor> open =
+            Collections.newSetFromMap(new ConcurrentHashMap<>());
+        /** Batch buffers left by exhausted splits. */
+        private final Queue<ByteBuffer> buffers = new ConcurrentLinkedQueue<>();
+        /** Whether the stream has been closed. */
+        private volatile boolean closed;
+
+        KvsCursor open(final Kvs kvs, final KvdbTransaction txn) throws HseException {
+            if (this.closed) {
+                throw new IllegalStateException("Stream is closed");
+            }
+
+            final KvsCursor cursor = kvs.cursor(txn);
+            this.open.add(cursor);
+
+            return cursor;
+        }
+
+        ByteBuffer buffer() {
+            final ByteBuffer buf = this.buffers.poll();
+
+            return buf == null
+                ? ByteBuffer.allocateDirect(BATCH_BUF_SZ).order(ByteOrder.nativeOrder()) : buf;
+        }
+
+        void recycle(final ByteBuffer buf) {
+            if (!this.closed) {
+                this.buffers.add(buf);
+            }
+        }
+
+        void release(final KvsCursor cursor) throws HseException {
+            if (this.open.remove(cursor)) {
+                cursor.close();
+            }
+        }
+
+        void close() throws HseException {
+            this.closed = true;
+            this.buffers.clear();
+
+            HseException err = null;
+            for (final KvsCursor cursor : this.open) {
+                try {
+                    release(cursor);
+                } catch (final HseException e) {
+                    if (err == null) {
+                        err = e;
+                    }
+                }
+            }
+
+            if (err != null) {
+                throw err;
+            }
+        }
+    }
+}
@@ -0,0 +1,384 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.math.BigInteger;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.AbstractMap.SimpleImmutableEntry;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.EnumSet;
+import java.util.List;
+import java.util.Optional;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.CompletionService;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorCompletionService;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.function.BiConsumer;
+
+/**
+ * Scan of a KVS split across threads.
+ *
+ * <p>
+ * The keys matching the filter are cut into sub-ranges when the scan is
+ * created. The first and last keys are found with a forward and a reverse
+ * cursor, and boundaries are placed by seeking to keys evenly interpolated
+ * between them, so ranges are balanced as far as keys are evenly spread over
+ * the keyspace. Each range is read by its own cursor on its own thread.
+ * </p>
+ *
+ * <p>
+ * Every worker's cursor sees the KVS as of its own creation, so a scan which
+ * runs concurrently with writes is not a consistent snapshot of the whole
+ * KVS. The scan may be run any number of times.
+ * </p>
+ *
+ * <p>This class is thread safe.</p>
+ */
+public final class ParallelScan {
+    /** Number of bytes past the common prefix used to interpolate keys. */
+    private static final int INTERPOLATION_BYTES = Long.BYTES;
+    /** Records buffered per range by {@link #forEachOrdered(BiConsumer)}. */
+    private static final int ORDERED_QUEUE_CAPACITY = 1024;
+    /** Size of each worker's batch buffer, which always fits one record. */
+    private static final int BATCH_BUF_SZ = 2 * Integer.BYTES + Limits.KVS_KEY_LEN_MAX
+        + Limits.KVS_VALUE_LEN_MAX;
+    /** Mask of the bits of an unsigned byte. */
+    private static final int BYTE_MASK = 0xff;
+    /** Marks the end of a range in an ordered queue. */
+    private static final SimpleImmutableEntry<byte[], byte[]> END =
+        new SimpleImmutableEntry<>(null, null);
+
+    /** KVS to scan. */
+    private final Kvs kvs;
+    /** Cursor filter. */
+    private final byte[] filter;
+    /** First key of every range, in order. */
+    private final List<byte[]> boundaries;
+
+    ParallelScan(final Kvs kvs, final byte[] filter, final int parallelism)
+            throws HseException {
+        if (parallelism < 1) {
+            throw new IllegalArgumentException("parallelism must be at least 1");
+        }
+
+        this.kvs = kvs;
+        this.filter = filter == null ? null : filter.clone();
+        this.boundaries = sample(parallelism);
+    }
+
+    private static Optional<byte[]> first(final KvsCursor cursor) throws HseException {
+        final KvsCursor.View view = new KvsCursor.View();
+        if (!cursor.read(view)) {
+            return Optional.empty();
+        }
+
+        final byte[] key = new byte[view.getKey().remaining()];
+        view.getKey().get(key);
+
+        return Optional.of(key);
+    }
+
+    private static BigInteger chunk(final byte[] key, final int off) {
+        final byte[] chunk = new byte[INTERPOLATION_BYTES];
+        if (off < key.length) {
+            System.arraycopy(key, off, chunk, 0,
+                Math.min(INTERPOLATION_BYTES, key.length - off));
+        }
+
+        return new BigInteger(1, chunk);
+    }
+
+    static byte[] interpolate(final byte[] min, final byte[] max, final int i,
+            final int n) {
+        int prefixLen = 0;
+        while (prefixLen < min.length && prefixLen < max.length
+                && min[prefixLen] == max[prefixLen]) {
+            prefixLen++;
+        }
+
+        final BigInteger lo = chunk(min, prefixLen);
+        final BigInteger hi = chunk(max, prefixLen);
+        final BigInteger point = lo.add(hi.subtract(lo)
+            .multiply(BigInteger.valueOf(i))
+            .divide(BigInteger.valueOf(n)));
+
+        // toByteArray() is big-endian, with a sign byte when the top bit is set.
+        final byte[] pointBytes = point.toByteArray();
+        final int copyLen = Math.min(pointBytes.length, INTERPOLATION_BYTES);
+        final byte[] key = Arrays.copyOf(min, prefixLen + INTERPOLATION_BYTES);
+        Arrays.fill(key, prefixLen, key.length, (byte) 0);
+        System.arraycopy(pointBytes, pointBytes.length - copyLen, key,
+            key.length - copyLen, copyLen);
+
+        return key;
+    }
+
+    static int compare(final byte[] a, final byte[] b) {
+        final int len = Math.min(a.length, b.length);
+        for (int i = 0; i < len; i++) {
+            final int cmp = (a[i] & BYTE_MASK) - (b[i] & BYTE_MASK);
+            if (cmp != 0) {
+                return cmp;
+            }
+        }
+
+        return a.length - b.length;
+    }
+
+    private List<byte[]> sample(final int parallelism) throws HseException {
+        final List<byte[]> sampled = new ArrayList<>(parallelism);
+        final Optional<byte[]> min;
+        final Optional<byte[]> max;
+
+        try (KvsCursor cursor = this.kvs.cursor(this.filter)) {
+            min = first(cursor);
+        }
+        if (!min.isPresent()) {
+            return Collections.emptyList();
+        }
+
+        try (KvsCursor cursor = this.kvs.cursor(this.filter,
+                EnumSet.of(KvsCursor.CreateFlags.REV))) {
+            max = first(cursor);
+        }
+
+        sampled.add(min.get());
+
+        try (KvsCursor cursor = this.kvs.cursor(this.filter)) {
+            for (int i = 1; i < parallelism; i++) {
+                final byte[] target = interpolate(min.get(), max.get(), i, parallelism);
+                final Optional<byte[]> found = cursor.seek(target);
+
+                // Sparse or skewed keys map several targets to the same key.
+                if (found.isPresent()
+                        && compare(found.get(), sampled.get(sampled.size() - 1)) > 0) {
+                    sampled.add(found.get());
+                }
+            }
+        }
+
+        return Collections.unmodifiableList(sampled);
+    }
+
+    /**
+     * Read every record of a range.
+     *
+     * @param range Index of the range.
+     * @param consumer Called with every record.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    private void scan(final int range, final BiConsumer<byte[], byte[]> consumer)
+            throws HseException {
+        final byte[] lo = this.boundaries.get(range);
+        final byte[] hi = range + 1 < this.boundaries.size() ? this.boundaries.get(range + 1)
+            : null;
+        final ByteBuffer buf = ByteBuffer.allocateDirect(BATCH_BUF_SZ)
+            .order(ByteOrder.nativeOrder());
+
+        try (KvsCursor cursor = this.kvs.cursor(this.filter)) {
+            // The maximum of seekRange() is inclusive, so hi is skipped below.
+            if (hi == null) {
+                cursor.seek(lo);
+            } else {
+                cursor.seekRange(lo, hi);
+            }
+
+            while (!Thread.currentThread().isInterrupted()) {
+                buf.clear();
+                final int records = cursor.readBatch(buf, Integer.MAX_VALUE);
+                if (records < 0) {
+                    return;
+                }
+
+                for (int i = 0; i < records; i++) {
+                    final byte[] key = new byte[buf.getInt()];
+                    final byte[] value = new byte[buf.getInt()];
+
+                    buf.get(key).get(value);
+                    if (hi != null && compare(key, hi) >= 0) {
+                        return;
+                    }
+
+                    consumer.accept(key, value);
+                }
+            }
+        }
+    }
+
+    private static ExecutorService newExecutor(final int threads) {
+        return Executors.newFixedThreadPool(threads, r -> {
+            final Thread thread = new Thread(r, "hse-parallel-scan");
+            thread.setDaemon(true);
+            return thread;
+        });
+    }
+
+    /**
+     * Wait for a worker, and rethrow whatever it threw.
+     *
+     * @param future Future of the worker.
+     * @throws HseException Worker failed in HSE.
+     * @throws InterruptedException Calling thread was interrupted.
+     */
+    private static void join(final Future<Void> future)
+            throws HseException, InterruptedException {
+        try {
+            future.get();
+        } catch (final ExecutionException e) {
+            final Throwable cause = e.getCause();
+            if (cause instanceof HseException) {
+                throw (HseException) cause;
+            } else if (cause instanceof RuntimeException) {
+                throw (RuntimeException) cause;
+            } else if (cause instanceof Error) {
+                throw (Error) cause;
+            }
+
+            throw new IllegalStateException(cause);
+        }
+    }
+
+    /**
+     * Get the first key of every range.
+     *
+     * @return Boundaries of the ranges, in order. Empty if no key matched the
+     *      filter.
+     */
+    public List<byte[]> getBoundaries() {
+        return this.boundaries;
+    }
+
+    /**
+     * Scan every range in parallel, in no particular order.
+     *
+     * <p>
+     * {@code consumer} is called concurrently from the worker threads, one per
+     * range, so it must be thread safe. Within a range, records are delivered
+     * in key order.
+     * </p>
+     *
+     * <p>
+     * Workers are joined as they finish, so as soon as one fails, the others
+     * are interrupted, and the failure is rethrown once all of them have
+     * stopped.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param consumer Called with the key and value of every record.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws InterruptedException Calling thread was interrupted.
+     */
+    public void forEachUnordered(final BiConsumer<byte[], byte[]> consumer)
+            throws HseException, InterruptedException {
+        if (this.boundaries.isEmpty()) {
+            return;
+        }
+
+        final ExecutorService executor = newExecutor(this.boundaries.size());
+        final CompletionService<Void> completion = new ExecutorCompletionService<>(executor);
+
+        try {
+            for (int i = 0; i < this.boundaries.size(); i++) {
+                final int range = i;
+                completion.submit(() -> {
+                    scan(range, consumer);
+                    return null;
+                });
+            }
+
+            for (int i = 0; i < this.boundaries.size(); i++) {
+                join(completion.take());
+            }
+        } finally {
+            executor.shutdownNow();
+            // Nothing may call consumer once this returns.
+            executor.awaitTermination(Long.MAX_VALUE, TimeUnit.NANOSECONDS);
+        }
+    }
+
+    /**
+     * Scan every range in parallel, delivering records in key order.
+     *
+     * <p>
+     * Workers read ahead into bounded per-range queues, while the calling
+     * thread drains the ranges one after the other, so {@code consumer} is
+     * only ever called from the calling thread.
+     * </p>
+     *
+     * <p>
+     * If a worker or {@code consumer} fails, the remaining workers are
+     * interrupted, and the failure is rethrown.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param consumer Called with the key and value of every record.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws InterruptedException Calling thread was interrupted.
+     */
+    public void forEachOrdered(final BiConsumer<byte[], byte[]> consumer)
+            throws HseException, InterruptedException {
+        if (this.boundaries.isEmpty()) {
+            return;
+        }
+
+        final ExecutorService executor = newExecutor(this.boundaries.size());
+        final List<Future<Void>> futures = new ArrayList<>(this.boundaries.size());
+        final List<BlockingQueue<SimpleImmutableEntry<byte[], byte[]>>> queues =
+            new ArrayList<>(this.boundaries.size());
+
+        try {
+            for (int i = 0; i < this.boundaries.size(); i++) {
+                final int range = i;
+                final BlockingQueue<SimpleImmutableEntry<byte[], byte[]>> queue =
+                    new ArrayBlockingQueue<>(ORDERED_QUEUE_CAPACITY);
+
+                queues.add(queue);
+                futures.add(executor.submit(() -> {
+                    try {
+                        scan(range, (key, value) -> {
+                            try {
+                                queue.put(new SimpleImmutableEntry<>(key, value));
+                            } catch (final InterruptedException e) {
+                                // Stops the scan at the next batch.
+                                Thread.currentThread().interrupt();
+                            }
+                        });
+                    } finally {
+                        /* Even a failed range must be ended, or the calling
+                         * thread would wait on its queue forever.
+                         */
+                        queue.put(END);
+                    }
+                    return null;
+                }));
+            }
+
+            for (int i = 0; i < queues.size(); i++) {
+                SimpleImmutableEntry<byte[], byte[]> entry = queues.get(i).take();
+                while (entry != END) {
+                    consumer.accept(entry.getKey(), entry.getValue());
+                    entry = queues.get(i).take();
+                }
+
+                join(futures.get(i));
+            }
+        } finally {
+            executor.shutdownNow();
+            // Nothing may call consumer once this returns.
+            executor.awaitTermination(Long.MAX_VALUE, TimeUnit.NANOSECONDS);
+        }
+    }
+}
@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayDeque;
+import java.util.concurrent.CompletionException;
+
+/**
+ * Cursor reader which reads ahead of its consumer.
+ *
+ * <p>
+ * Batches are read with {@link KvsCursor#readBatchAsync(ByteBuffer, int)}
+ * into a fixed ring of direct buffers. As soon as a batch is read, the next
+ * one is queued to the native worker pool as long as a buffer is free, so
+ * HSE fills the following batches while the consumer processes the current
+ * one. Memory is bounded by the number and size of the buffers.
+ * </p>
+ *
+ * <p>
+ * While a prefetching cursor is open, no other operation may be performed on
+ * the underlying cursor. {@link #close()} stops reading ahead and waits for
+ * the read in flight, if any, but does not close the underlying cursor, whose
+ * position is then past every prefetched record.
+ * </p>
+ *
+ * <pre>
+ * try (KvsCursor cursor = kvs.cursor();
+ *         PrefetchingCursor prefetch = cursor.prefetch(4)) {
+ *     final KvsCursor.View view = new KvsCursor.View();
+ *     while (prefetch.read(view)) {
+ *         process(view.getKey(), view.getValue());
+ *     }
+ * }
+ * </pre>
+ *
+ * <p>This class is not thread safe.</p>
+ */
+public final class PrefetchingCursor implements AutoCloseable {
+    /** Cursor to read. */
+    private final KvsCursor cursor;
+    /** Buffers which are free to be read into. Guarded by {@code this}. */
+    private final ArrayDeque<Batch> free;
+    /** Batches read but not yet handed to the consumer. Guarded by {@code this}. */
+    private final ArrayDeque<Batch> ready;
+    /** Batch being consumed. Only accessed by the consumer. */
+    private Batch current;
+    /** Whether a read is queued to the worker pool. Guarded by {@code this}. */
+    private boolean inFlight;
+    /** Whether the end of the cursor has been read. Guarded by {@code this}. */
+    private boolean eof;
+    /** Whether {@link #close()} has been called. Guarded by {@code this}. */
+    private boolean closed;
+    /** Failure of a read, rethrown once the batches before it are consumed. */
+    private Throwable failure;
+
+    PrefetchingCursor(final KvsCursor cursor, final int buffers, final int bufSz) {
+        if (buffers < 1) {
+            throw new IllegalArgumentException("buffers must be at least 1");
+        }
+
+        this.cursor = cursor;
+        this.free = new ArrayDeque<>(buffers);
+        this.ready = new ArrayDeque<>(buffers);
+        for (int i = 0; i < buffers; i++) {
+            this.free.add(new Batch(bufSz));
+        }
+
+        synchronized (this) {
+            issue();
+        }
+    }
+
+    /**
+     * Queue the next read if nothing prevents it. Must hold {@code this}.
+     */
+    private void issue() {
+        if (this.inFlight || this.eof || this.closed || this.failure != null
+                || this.free.isEmpty()) {
+            return;
+        }
+
+        final Batch batch = this.free.poll();
+
+        batch.buf.clear();
+        this.inFlight = true;
+        this.cursor.readBatchAsync(batch.buf, Integer.MAX_VALUE)
+            .whenComplete((records, err) -> complete(batch, records, err));
+    }
+
+    private synchronized void complete(final Batch batch, final Integer records,
+            final Throwable err) {
+        this.inFlight = false;
+
+        if (err != null) {
+            this.failure = err instanceof CompletionException ? err.getCause() : err;
+            this.free.add(batch);
+        } else if (records < 0) {
+            this.eof = true;
+            this.free.add(batch);
+        } else if (records == 0) {
+            this.failure = new IllegalStateException(
+                "Record does not fit in a prefetch buffer of " + batch.buf.capacity()
+                + " bytes");
+            this.free.add(batch);
+        } else {
+            batch.records = records;
+            this.ready.add(batch);
+        }
+
+        issue();
+        notifyAll();
+    }
+
+    /**
+     * Wait for the next batch.
+     *
+     * @return Next batch, or {@code null} at the end of the cursor.
+     * @throws HseException Reading the batch failed.
+     * @throws InterruptedException Calling thread was interrupted.
+     */
+    private synchronized Batch take() throws HseException, InterruptedException {
+        if (this.closed) {
+            throw new IllegalStateException("Prefetching cursor is closed");
+        }
+
+        while (this.ready.isEmpty() && this.failure == null && !this.eof) {
+            wait();
+        }
+
+        if (!this.ready.isEmpty()) {
+            return this.ready.poll();
+        } else if (this.failure instanceof HseException) {
+            throw (HseException) this.failure;
+        } else if (this.failure instanceof RuntimeException) {
+            throw (RuntimeException) this.failure;
+        } else if (this.failure instanceof Error) {
+            throw (Error) this.failure;
+        } else if (this.failure != null) {
+            throw new IllegalStateException(this.failure);
+        }
+
+        return null;
+    }
+
+    private synchronized void recycle(final Batch batch) {
+        this.free.add(batch);
+        issue();
+    }
+
+    /**
+     * Read the next key-value pair.
+     *
+     * <p>
+     * {@code view} is updated with read-only buffers which point into a
+     * prefetch buffer. They are only valid until the next read or
+     * {@link #close()}.
+     * </p>
+     *
+     * @param view View to update with the next record.
+     * @return Whether a record was read. {@code false} means the end of the
+     *      cursor was reached, and {@code view} is left unchanged.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @throws IllegalStateException The prefetching cursor is closed, or a
+     *      record does not fit in a prefetch buffer.
+     * @throws InterruptedException Calling thread was interrupted while
+     *      waiting for a batch.
+     */
+    public boolean read(final KvsCursor.View view) throws HseException, InterruptedException {
+        while (this.current == null || this.current.records == 0) {
+            if (this.current != null) {
+                final Batch batch = this.current;
+                this.current = null;
+                recycle(batch);
+            }
+
+            this.current = take();
+            if (this.current == null) {
+                return false;
+            }
+        }
+
+        final ByteBuffer buf = this.current.buf;
+        final int end = buf.limit();
+        final int keyLen = buf.getInt();
+        final int valueLen = buf.getInt();
+        final int keyPos = buf.position();
+        final int valuePos = keyPos + keyLen;
+
+        buf.limit(valuePos);
+        final ByteBuffer key = buf.slice().asReadOnlyBuffer();
+        buf.limit(valuePos + valueLen).position(valuePos);
+        final ByteBuffer value = buf.slice().asReadOnlyBuffer();
+        buf.limit(end).position(valuePos + valueLen);
+
+        this.current.records--;
+        view.update(key, value);
+
+        return true;
+    }
+
+    /**
+     * Stop reading ahead, and wait for the read in flight, if any.
+     *
+     * <p>
+     * The underlying cursor is left open. Calling this function more than
+     * once has no effect.
+     * </p>
+     */
+    @Override
+    public void close() {
+        boolean interrupted = false;
+
+        synchronized (this) {
+            this.closed = true;
+
+            // The worker still writes into one of the buffers.
+            while (this.inFlight) {
+                try {
+                    wait();
+                } catch (final InterruptedException e) {
+                    interrupted = true;
+                }
+            }
+
+            this.ready.clear();
+            this.free.clear();
+        }
+
+        this.current = null;
+
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    /** Buffer of records read in one batch. */
+    private static final class Batch {
+        /** Records in the batch read format of {@link KvsCursor}. */
+        private final ByteBuffer buf;
+        /** Number of records left to consume. */
+        private int records;
+
+        Batch(final int bufSz) {
+            this.buf = ByteBuffer.allocateDirect(bufSz).order(ByteOrder.nativeOrder());
+        }
+    }
+}
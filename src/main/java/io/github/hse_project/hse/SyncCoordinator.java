@@ -0,0 +1,147 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.util.ArrayList;
+import java.util.EnumSet;
+import java.util.List;
+import java.util.concurrent.CompletableFuture;
+
+import io.github.hse_project.hse.Kvdb.SyncFlags;
+
+/**
+ * Coalesces concurrent sync requests of a KVDB.
+ *
+ * <p>
+ * Requests are queued to a daemon thread. Each time it wakes, it issues a
+ * single sync on behalf of every request queued since its previous sync, so
+ * no matter how many threads ask, at most one sync is in progress at a time.
+ * Every sync is numbered, and the numbers double as durability marks: a write
+ * which completed before {@link #getSyncMark()} returned {@code m} is durable
+ * once {@link #getDurableMark()} is at least {@code m}.
+ * </p>
+ */
+final class SyncCoordinator {
+    /** KVDB to sync. */
+    private final Kvdb kvdb;
+    /** Futures waiting for the next sync. */
+    private List<CompletableFuture<Long>> pending = new ArrayList<>();
+    /** Whether any of the pending requests needs to wait for durability. */
+    private boolean pendingDurable;
+    /** Number of the last sync which was started. */
+    private volatile long started;
+    /** Number of the last durable sync which completed. */
+    private volatile long durable;
+    /** Whether the coordinator is shutting down. */
+    private boolean closed;
+    /** Thread issuing syncs. */
+    private final Thread thread;
+
+    SyncCoordinator(final Kvdb kvdb) {
+        this.kvdb = kvdb;
+        this.thread = new Thread(this::run, "hse-sync");
+        this.thread.setDaemon(true);
+        this.thread.start();
+    }
+
+    private void run() {
+        while (true) {
+            final List<CompletableFuture<Long>> batch;
+            final boolean needDurable;
+            final long mark;
+
+            synchronized (this) {
+                while (this.pending.isEmpty() && !this.closed) {
+                    try {
+                        wait();
+                    } catch (final InterruptedException e) {
+                        Thread.currentThread().interrupt();
+                        return;
+                    }
+                }
+                if (this.pending.isEmpty()) {
+                    return;
+                }
+
+                batch = this.pending;
+                needDurable = this.pendingDurable;
+                this.pending = new ArrayList<>();
+                this.pendingDurable = false;
+
+                // Anyone taking a mark from here on waits for the next sync.
+                mark = ++this.started;
+            }
+
+            try {
+                /* Nobody in the batch needs to wait for the data to reach
+                 * stable media, so only start the sync.
+                 */
+                this.kvdb.sync(needDurable ? null : EnumSet.of(SyncFlags.ASYNC));
+                if (needDurable) {
+                    this.durable = mark;
+                }
+            } catch (final HseException e) {
+                for (final CompletableFuture<Long> future : batch) {
+                    future.completeExceptionally(e);
+                }
+                continue;
+            }
+
+            for (final CompletableFuture<Long> future : batch) {
+                future.complete(this.durable);
+            }
+        }
+    }
+
+    CompletableFuture<Long> request(final boolean needDurable) {
+        final CompletableFuture<Long> future = new CompletableFuture<>();
+
+        synchronized (this) {
+            if (this.closed) {
+                throw new IllegalStateException("KVDB is closed");
+            }
+
+            this.pending.add(future);
+            this.pendingDurable |= needDurable;
+            notify();
+        }
+
+        return future;
+    }
+
+    long getSyncMark() {
+        return this.started + 1;
+    }
+
+    long getDurableMark() {
+        return this.durable;
+    }
+
+    /**
+     * Stop accepting requests, and wait for queued requests to complete.
+     */
+    void close() {
+        boolean interrupted = false;
+
+        synchronized (this) {
+            this.closed = true;
+            notify();
+        }
+
+        while (true) {
+            try {
+                this.thread.join();
+                break;
+            } catch (final InterruptedException e) {
+                interrupted = true;
+            }
+        }
+
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+    }
+}
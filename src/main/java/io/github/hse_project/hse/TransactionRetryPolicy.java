@@ -0,0 +1,193 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.LongAdder;
+import java.util.concurrent.locks.LockSupport;
+
+/**
+ * Retry policy of {@link Kvdb#runInTransaction(Kvdb.TransactionFunction,
+ * TransactionRetryPolicy)}.
+ *
+ * <p>
+ * A transaction is retried if it failed with a write conflict
+ * ({@code ECANCELED}) or because it expired
+ * ({@link HseException.Context#TXN_EXPIRED}). Before each retry, the calling
+ * thread sleeps for a random time between 0 and an exponentially growing
+ * bound, so that transactions which conflicted with each other do not simply
+ * collide again.
+ * </p>
+ *
+ * <p>
+ * The policy counts the conflicts and retries of every transaction run with
+ * it. Using one policy per call site shows which call sites contend on hot
+ * keys.
+ * </p>
+ *
+ * <p>This class is thread safe.</p>
+ */
+public final class TransactionRetryPolicy {
+    /** Linux errno of a write conflict. HSE only runs on Linux. */
+    private static final int ECANCELED = 125;
+    /** Default maximum number of attempts. */
+    private static final int DEFAULT_MAX_ATTEMPTS = 10;
+    /** Default bound of the first backoff in microseconds. */
+    private static final long DEFAULT_INITIAL_BACKOFF_US = 100;
+    /** Default largest bound of a backoff in microseconds. */
+    private static final long DEFAULT_MAX_BACKOFF_US = 100_000;
+
+    /** Maximum number of attempts, including the first. */
+    private final int maxAttempts;
+    /** Bound of the first backoff in nanoseconds. */
+    private final long initialBackoffNanos;
+    /** Largest bound of a backoff in nanoseconds. */
+    private final long maxBackoffNanos;
+    /** Number of transactions which committed. */
+    private final LongAdder commits = new LongAdder();
+    /** Number of attempts which failed with a write conflict. */
+    private final LongAdder conflicts = new LongAdder();
+    /** Number of attempts which failed because the transaction expired. */
+    private final LongAdder expirations = new LongAdder();
+    /** Number of attempts after the first. */
+    private final LongAdder retries = new LongAdder();
+    /** Number of transactions which gave up after the maximum attempts. */
+    private final LongAdder exhausted = new LongAdder();
+
+    /**
+     * Create a policy with at most 10 attempts, backing off from 100
+     * microseconds up to 100 milliseconds.
+     */
+    public TransactionRetryPolicy() {
+        this(DEFAULT_MAX_ATTEMPTS, DEFAULT_INITIAL_BACKOFF_US, DEFAULT_MAX_BACKOFF_US,
+            TimeUnit.MICROSECONDS);
+    }
+
+    /**
+     * Create a policy.
+     *
+     * @param maxAttempts Maximum number of attempts, including the first.
+     * @param initialBackoff Bound of the backoff before the first retry.
+     * @param maxBackoff Largest bound of a backoff, which doubles with every
+     *      retry.
+     * @param unit Unit of {@code initialBackoff} and {@code maxBackoff}.
+     * @throws IllegalArgumentException {@code maxAttempts} is less than 1, or
+     *      a backoff is negative.
+     */
+    public TransactionRetryPolicy(final int maxAttempts, final long initialBackoff,
+            final long maxBackoff, final TimeUnit unit) {
+        if (maxAttempts < 1) {
+            throw new IllegalArgumentException("maxAttempts must be at least 1");
+        }
+        if (initialBackoff < 0 || maxBackoff < initialBackoff) {
+            throw new IllegalArgumentException(
+                "Backoffs must satisfy 0 <= initialBackoff <= maxBackoff");
+        }
+
+        this.maxAttempts = maxAttempts;
+        this.initialBackoffNanos = unit.toNanos(initialBackoff);
+        this.maxBackoffNanos = unit.toNanos(maxBackoff);
+    }
+
+    /**
+     * Decide whether a failed attempt should be retried, and back off if so.
+     *
+     * @param e Failure of the attempt.
+     * @param attempt Number of the attempt which failed, starting at 1.
+     * @return Whether to retry.
+     */
+    boolean retry(final HseException e, final int attempt) {
+        if (e.getErrno() == ECANCELED) {
+            this.conflicts.increment();
+        } else if (e.getContext() == HseException.Context.TXN_EXPIRED) {
+            this.expirations.increment();
+        } else {
+            return false;
+        }
+
+        if (attempt >= this.maxAttempts) {
+            this.exhausted.increment();
+            return false;
+        }
+
+        // Doubles per retry, without shifting into the sign bit.
+        final int shift = Math.min(attempt - 1,
+            Long.numberOfLeadingZeros(this.initialBackoffNanos) - 1);
+        final long bound = Math.min(this.maxBackoffNanos, this.initialBackoffNanos << shift);
+        if (bound > 0) {
+            LockSupport.parkNanos(ThreadLocalRandom.current().nextLong(bound + 1));
+        }
+
+        // An interrupted thread should stop retrying, but keep its status.
+        if (Thread.currentThread().isInterrupted()) {
+            return false;
+        }
+
+        this.retries.increment();
+
+        return true;
+    }
+
+    void recordCommit() {
+        this.commits.increment();
+    }
+
+    /**
+     * Get the maximum number of attempts.
+     *
+     * @return Maximum number of attempts, including the first.
+     */
+    public int getMaxAttempts() {
+        return this.maxAttempts;
+    }
+
+    /**
+     * Get the number of transactions which committed.
+     *
+     * @return Number of commits.
+     */
+    public long getCommits() {
+        return this.commits.sum();
+    }
+
+    /**
+     * Get the number of attempts which failed with a write conflict.
+     *
+     * @return Number of conflicts.
+     */
+    public long getConflicts() {
+        return this.conflicts.sum();
+    }
+
+    /**
+     * Get the number of attempts which failed because the transaction expired.
+     *
+     * @return Number of expirations.
+     */
+    public long getExpirations() {
+        return this.expirations.sum();
+    }
+
+    /**
+     * Get the number of attempts after the first.
+     *
+     * @return Number of retries.
+     */
+    public long getRetries() {
+        return this.retries.sum();
+    }
+
+    /**
+     * Get the number of transactions which failed with a retryable error on
+     * their last allowed attempt.
+     *
+     * @return Number of transactions which ran out of attempts.
+     */
+    public long getExhausted() {
+        return this.exhausted.sum();
+    }
+}
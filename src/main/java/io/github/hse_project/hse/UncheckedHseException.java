@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+/**
+ * Wraps an {@link HseException} where a checked exception cannot be thrown,
+ * such as from a {@link java.util.stream.Stream}.
+ */
+public final class UncheckedHseException extends RuntimeException {
+    private static final long serialVersionUID = -3166328624862302411L;
+
+    /**
+     * Create an unchecked wrapper.
+     *
+     * @param cause Wrapped exception.
+     */
+    public UncheckedHseException(final HseException cause) {
+        super(cause.getMessage(), cause);
+    }
+
+    /**
+     * Get the wrapped exception.
+     *
+     * @return Wrapped exception.
+     */
+    @Override
+    public HseException getCause() {
+        return (HseException) super.getCause();
+    }
+}
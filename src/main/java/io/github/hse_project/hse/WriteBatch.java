@@ -0,0 +1,479 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.EnumSet;
+
+import io.github.hse_project.hse.Kvs.PutFlags;
+
+/**
+ * Batch of KVS operations applied with a single call into HSE.
+ *
+ * <p>
+ * Operations are encoded into an off-heap buffer as they are added, and are
+ * applied in insertion order by {@link Kvs#write(WriteBatch, KvdbTransaction)}
+ * or atomically by {@link KvdbTransaction#commit(WriteBatch)}. Keys and values
+ * are copied into the batch, so callers may reuse their buffers as soon as an
+ * operation has been added.
+ * </p>
+ *
+ * <p>
+ * Operations added without a {@link Kvs} target the KVS the batch is written
+ * to. Operations added with a {@link Kvs} target that KVS, which allows a
+ * single batch to span multiple KVSs within the same KVDB.
+ * </p>
+ *
+ * <p>This class is not thread safe.</p>
+ */
+public final class WriteBatch {
+    /** Initial capacity of the operation buffer in bytes. */
+    private static final int DEFAULT_CAPACITY = 4096;
+    /**
+     * Size of an operation header: KVS handle, op, flags, key length, and value
+     * length.
+     */
+    private static final int OP_HEADER_SZ = Long.BYTES + 4 * Integer.BYTES;
+    /** Offset of the key length within an operation header. */
+    private static final int OP_KEY_LEN_OFFSET = Long.BYTES + 2 * Integer.BYTES;
+    /** Offset of the value length within an operation header. */
+    private static final int OP_VALUE_LEN_OFFSET = Long.BYTES + 3 * Integer.BYTES;
+    /** Encoded operations. */
+    private ByteBuffer ops;
+    /** Number of encoded operations. */
+    private int count;
+    /** Number of encoded operations added without a {@link Kvs}. */
+    private int defaultKvsCount;
+    /** Index of the operation which failed during the last write. */
+    private int failedIndex = -1;
+
+    /**
+     * Create an empty batch.
+     */
+    public WriteBatch() {
+        this(DEFAULT_CAPACITY);
+    }
+
+    /**
+     * Create an empty batch.
+     *
+     * @param capacity Initial size of the operation buffer in bytes. The buffer
+     *      grows as needed.
+     */
+    public WriteBatch(final int capacity) {
+        this.ops = ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+    }
+
+    private native void commit(long kvdbHandle, long txnHandle, ByteBuffer opsBuf, int opsLen)
+            throws HseException;
+    private native void write(long kvsHandle, ByteBuffer opsBuf, int opsLen, long txnHandle)
+            throws HseException;
+
+    private void ensureCapacity(final int needed) {
+        if (this.ops.remaining() >= needed) {
+            return;
+        }
+
+        final int capacity = Math.max(this.ops.capacity() * 2, this.ops.position() + needed);
+        final ByteBuffer grown = ByteBuffer.allocateDirect(capacity)
+            .order(ByteOrder.nativeOrder());
+
+        this.ops.flip();
+        grown.put(this.ops);
+        this.ops = grown;
+    }
+
+    private void addOp(final Kvs kvs, final Op op, final int flags, final byte[] key,
+            final byte[] value) {
+        final int keyLen = key == null ? 0 : key.length;
+        final int valueLen = value == null ? 0 : value.length;
+
+        ensureCapacity(OP_HEADER_SZ + keyLen + valueLen);
+
+        this.ops.putLong(kvs == null ? 0 : kvs.handle);
+        if (kvs == null) {
+            this.defaultKvsCount++;
+        }
+        this.ops.putInt(op.ordinal()).putInt(flags).putInt(keyLen).putInt(valueLen);
+        if (key != null) {
+            this.ops.put(key);
+        }
+        if (value != null) {
+            this.ops.put(value);
+        }
+
+        this.count++;
+    }
+
+    private void addOp(final Kvs kvs, final Op op, final int flags, final ByteBuffer key,
+            final ByteBuffer value) {
+        final int keyLen = key == null ? 0 : key.remaining();
+        final int valueLen = value == null ? 0 : value.remaining();
+
+        ensureCapacity(OP_HEADER_SZ + keyLen + valueLen);
+
+        this.ops.putLong(kvs == null ? 0 : kvs.handle);
+        if (kvs == null) {
+            this.defaultKvsCount++;
+        }
+        this.ops.putInt(op.ordinal()).putInt(flags).putInt(keyLen).putInt(valueLen);
+        if (key != null) {
+            this.ops.put(key);
+        }
+        if (value != null) {
+            this.ops.put(value);
+        }
+
+        this.count++;
+    }
+
+    /**
+     * Remove all operations from the batch.
+     *
+     * <p>The operation buffer is retained for reuse.</p>
+     */
+    public void clear() {
+        this.ops.clear();
+        this.count = 0;
+        this.defaultKvsCount = 0;
+        this.failedIndex = -1;
+    }
+
+    /**
+     * Refer to {@link #delete(Kvs, byte[])}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param key Key to be deleted from the KVS.
+     * @return This batch.
+     */
+    public WriteBatch delete(final byte[] key) {
+        return delete(null, key);
+    }
+
+    /**
+     * Refer to {@link #delete(Kvs, ByteBuffer)}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param key Key to be deleted from the KVS.
+     * @return This batch.
+     */
+    public WriteBatch delete(final ByteBuffer key) {
+        return delete(null, key);
+    }
+
+    /**
+     * Add a delete operation to the batch.
+     *
+     * @param kvs KVS to delete from, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to be deleted from the KVS.
+     * @return This batch.
+     * @see Kvs#delete(byte[], KvdbTransaction)
+     */
+    public WriteBatch delete(final Kvs kvs, final byte[] key) {
+        addOp(kvs, Op.DELETE, 0, key, (byte[]) null);
+
+        return this;
+    }
+
+    /**
+     * Add a delete operation to the batch.
+     *
+     * <p>
+     * The {@link ByteBuffer#remaining} bytes of {@code key} are copied into the
+     * batch, and its position is advanced to its limit. The buffer does not
+     * need to be direct.
+     * </p>
+     *
+     * @param kvs KVS to delete from, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to be deleted from the KVS.
+     * @return This batch.
+     * @see Kvs#delete(ByteBuffer, KvdbTransaction)
+     */
+    public WriteBatch delete(final Kvs kvs, final ByteBuffer key) {
+        addOp(kvs, Op.DELETE, 0, key, (ByteBuffer) null);
+
+        return this;
+    }
+
+    /**
+     * Get the index of the operation which failed during the last write.
+     *
+     * <p>
+     * Operations after the failed operation were not attempted. Whether the
+     * operations before it remain applied depends on how the batch was written.
+     * </p>
+     *
+     * @return Index of the failed operation, or -1 if no operation failed.
+     */
+    public int getFailedIndex() {
+        return this.failedIndex;
+    }
+
+    /**
+     * Refer to {@link #prefixDelete(Kvs, byte[])}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param pfx Prefix of keys to delete.
+     * @return This batch.
+     */
+    public WriteBatch prefixDelete(final byte[] pfx) {
+        return prefixDelete(null, pfx);
+    }
+
+    /**
+     * Refer to {@link #prefixDelete(Kvs, ByteBuffer)}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param pfx Prefix of keys to delete.
+     * @return This batch.
+     */
+    public WriteBatch prefixDelete(final ByteBuffer pfx) {
+        return prefixDelete(null, pfx);
+    }
+
+    /**
+     * Add a prefix delete operation to the batch.
+     *
+     * @param kvs KVS to delete from, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param pfx Prefix of keys to delete.
+     * @return This batch.
+     * @see Kvs#prefixDelete(byte[], KvdbTransaction)
+     */
+    public WriteBatch prefixDelete(final Kvs kvs, final byte[] pfx) {
+        addOp(kvs, Op.PREFIX_DELETE, 0, pfx, (byte[]) null);
+
+        return this;
+    }
+
+    /**
+     * Add a prefix delete operation to the batch.
+     *
+     * <p>
+     * The {@link ByteBuffer#remaining} bytes of {@code pfx} are copied into the
+     * batch, and its position is advanced to its limit. The buffer does not
+     * need to be direct.
+     * </p>
+     *
+     * @param kvs KVS to delete from, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param pfx Prefix of keys to delete.
+     * @return This batch.
+     * @see Kvs#prefixDelete(ByteBuffer, KvdbTransaction)
+     */
+    public WriteBatch prefixDelete(final Kvs kvs, final ByteBuffer pfx) {
+        addOp(kvs, Op.PREFIX_DELETE, 0, pfx, (ByteBuffer) null);
+
+        return this;
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, byte[], byte[], EnumSet)}.
+     *
+     * <p>{@code kvs} and {@code flags} default to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return This batch.
+     */
+    public WriteBatch put(final byte[] key, final byte[] value) {
+        return put(null, key, value, null);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * <p>{@code kvs} and {@code flags} default to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return This batch.
+     */
+    public WriteBatch put(final ByteBuffer key, final ByteBuffer value) {
+        return put(null, key, value, null);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, byte[], byte[], EnumSet)}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return This batch.
+     */
+    public WriteBatch put(final byte[] key, final byte[] value, final EnumSet<PutFlags> flags) {
+        return put(null, key, value, flags);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * <p>{@code kvs} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return This batch.
+     */
+    public WriteBatch put(final ByteBuffer key, final ByteBuffer value,
+            final EnumSet<PutFlags> flags) {
+        return put(null, key, value, flags);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, byte[], byte[], EnumSet)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to put into, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return This batch.
+     */
+    public WriteBatch put(final Kvs kvs, final byte[] key, final byte[] value) {
+        return put(kvs, key, value, null);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to put into, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return This batch.
+     */
+    public WriteBatch put(final Kvs kvs, final ByteBuffer key, final ByteBuffer value) {
+        return put(kvs, key, value, null);
+    }
+
+    /**
+     * Add a put operation to the batch.
+     *
+     * @param kvs KVS to put into, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return This batch.
+     * @see Kvs#put(byte[], byte[], EnumSet, KvdbTransaction)
+     */
+    public WriteBatch put(final Kvs kvs, final byte[] key, final byte[] value,
+            final EnumSet<PutFlags> flags) {
+        final int flagsValue = flags == null ? 0 : flags.stream()
+            .mapToInt(flag -> 1 << flag.ordinal())
+            .sum();
+
+        addOp(kvs, Op.PUT, flagsValue, key, value);
+
+        return this;
+    }
+
+    /**
+     * Add a put operation to the batch.
+     *
+     * <p>
+     * The {@link ByteBuffer#remaining} bytes of {@code key} and {@code value}
+     * are copied into the batch, and their positions are advanced to their
+     * limits. The buffers do not need to be direct.
+     * </p>
+     *
+     * @param kvs KVS to put into, or {@code null} for the KVS the batch is
+     *      written to.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return This batch.
+     * @see Kvs#put(ByteBuffer, ByteBuffer, EnumSet, KvdbTransaction)
+     */
+    public WriteBatch put(final Kvs kvs, final ByteBuffer key, final ByteBuffer value,
+            final EnumSet<PutFlags> flags) {
+        final int flagsValue = flags == null ? 0 : flags.stream()
+            .mapToInt(flag -> 1 << flag.ordinal())
+            .sum();
+
+        addOp(kvs, Op.PUT, flagsValue, key, value);
+
+        return this;
+    }
+
+    /**
+     * Get the number of operations in the batch.
+     *
+     * @return Number of operations.
+     */
+    public int size() {
+        return this.count;
+    }
+
+    void commit(final long kvdbHandle, final long txnHandle) throws HseException {
+        if (this.defaultKvsCount > 0) {
+            throw new IllegalArgumentException(
+                "Every operation of a committed batch must be added with a Kvs");
+        }
+
+        this.failedIndex = -1;
+
+        commit(kvdbHandle, txnHandle, this.ops, this.ops.position());
+    }
+
+    void write(final long kvsHandle, final long txnHandle) throws HseException {
+        this.failedIndex = -1;
+
+        write(kvsHandle, this.ops, this.ops.position(), txnHandle);
+    }
+
+    /**
+     * Write the operations starting at {@code from}, which is typically just
+     * past a failed operation.
+     *
+     * @param kvsHandle Handle of the KVS to write to.
+     * @param txnHandle Handle of the transaction, or 0.
+     * @param from Index of the first operation to apply.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    void write(final long kvsHandle, final long txnHandle, final int from) throws HseException {
+        int off = 0;
+        for (int i = 0; i < from; i++) {
+            off += OP_HEADER_SZ + this.ops.getInt(off + OP_KEY_LEN_OFFSET)
+                + this.ops.getInt(off + OP_VALUE_LEN_OFFSET);
+        }
+
+        // GetDirectBufferAddress() of a slice is the address of its first byte.
+        final ByteBuffer dup = this.ops.duplicate();
+        dup.position(off);
+
+        this.failedIndex = -1;
+        try {
+            write(kvsHandle, dup.slice(), this.ops.position() - off, txnHandle);
+        } catch (final HseException e) {
+            this.failedIndex += from;
+            throw e;
+        }
+    }
+
+    /** Operation codes understood by the native side. */
+    private enum Op {
+        /** Refer to {@link Kvs#put(byte[], byte[], EnumSet, KvdbTransaction)}. */
+        PUT,
+        /** Refer to {@link Kvs#delete(byte[], KvdbTransaction)}. */
+        DELETE,
+        /** Refer to {@link Kvs#prefixDelete(byte[], KvdbTransaction)}. */
+        PREFIX_DELETE,
+    }
+}
@@ -0,0 +1,456 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.EnumSet;
+import java.util.List;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.TimeUnit;
+
+import io.github.hse_project.hse.Kvs.PutFlags;
+
+/**
+ * Group commit of small writes from many threads.
+ *
+ * <p>
+ * Puts and deletes are copied into one of several off-heap
+ * {@link WriteBatch}es, as many as there are available processors. The
+ * stripe of a thread is its ID modulo the number of stripes, so threads are
+ * spread across stripes but not tied to the processor they run on, and two
+ * busy threads may well share a stripe. A batch is written to the KVS with a
+ * single call into HSE once it holds {@code maxBatchOps} operations, or at the
+ * latest {@code maxDelay} after its first operation was added. The future
+ * returned for each operation completes once its batch has been written,
+ * trading a bounded delay for far fewer calls into HSE than one per
+ * operation.
+ * </p>
+ *
+ * <p>
+ * Operations from the same thread are applied in the order they were added.
+ * Operations from different threads may be applied in any order. Coalesced
+ * operations are not atomic with respect to one another, and the failure of
+ * one operation does not fail any other.
+ * </p>
+ *
+ * <p>
+ * If a {@link Kvdb} is given, each batch is followed by
+ * {@link Kvdb#syncAsync()}, and futures complete only once their operations
+ * are on stable media. Syncs requested by different stripes while a sync is
+ * in progress are coalesced into one. Those futures, and the stages which
+ * depend on them, are completed on the thread of the sync; refer to
+ * {@link Kvdb#syncAsync(EnumSet)}.
+ * </p>
+ *
+ * <p>
+ * The coalescer must be closed before the KVS it writes to.
+ * </p>
+ *
+ * <p>This class is thread safe.</p>
+ */
+public final class WriteCoalescer implements AutoCloseable {
+    /** KVS operations are written to. */
+    private final Kvs kvs;
+    /** KVDB to sync after each batch, or {@code null}. */
+    private final Kvdb kvdb;
+    /** Number of operations which triggers a flush. */
+    private final int maxBatchOps;
+    /** As many stripes as available processors, indexed by thread ID. */
+    private final Stripe[] stripes;
+    /** Flushes batches which have waited for {@code maxDelay}. */
+    private final ScheduledExecutorService flusher;
+    /** Whether the coalescer has been closed. */
+    private volatile boolean closed;
+
+    /**
+     * Refer to {@link #WriteCoalescer(Kvs, Kvdb, int, long, TimeUnit)}.
+     *
+     * <p>{@code kvdb} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to write to.
+     * @param maxBatchOps Number of operations which triggers a flush.
+     * @param maxDelay Longest time an operation waits to be flushed.
+     * @param unit Unit of {@code maxDelay}.
+     */
+    public WriteCoalescer(final Kvs kvs, final int maxBatchOps, final long maxDelay,
+            final TimeUnit unit) {
+        this(kvs, null, maxBatchOps, maxDelay, unit);
+    }
+
+    /**
+     * Create a write coalescer.
+     *
+     * @param kvs KVS to write to.
+     * @param kvdb KVDB which contains {@code kvs}, to sync after each batch, or
+     *      {@code null} to not wait for durability.
+     * @param maxBatchOps Number of operations which triggers a flush.
+     * @param maxDelay Longest time an operation waits to be flushed.
+     * @param unit Unit of {@code maxDelay}.
+     * @throws IllegalArgumentException {@code maxBatchOps} or {@code maxDelay}
+     *      is less than 1.
+     */
+    public WriteCoalescer(final Kvs kvs, final Kvdb kvdb, final int maxBatchOps,
+            final long maxDelay, final TimeUnit unit) {
+        if (maxBatchOps < 1) {
+            throw new IllegalArgumentException("maxBatchOps must be at least 1");
+        }
+        if (maxDelay < 1) {
+            throw new IllegalArgumentException("maxDelay must be at least 1");
+        }
+
+        this.kvs = kvs;
+        this.kvdb = kvdb;
+        this.maxBatchOps = maxBatchOps;
+        this.stripes = new Stripe[Runtime.getRuntime().availableProcessors()];
+        for (int i = 0; i < this.stripes.length; i++) {
+            this.stripes[i] = new Stripe();
+        }
+
+        this.flusher = Executors.newSingleThreadScheduledExecutor(r -> {
+            final Thread thread = new Thread(r, "hse-write-coalescer");
+            thread.setDaemon(true);
+            return thread;
+        });
+        // flush() fails the futures of a batch rather than throw, as anything
+        // escaping this task would silently cancel every later run of it.
+        this.flusher.scheduleAtFixedRate(() -> {
+            for (final Stripe stripe : this.stripes) {
+                flush(stripe, false);
+            }
+        }, maxDelay, maxDelay, unit);
+    }
+
+    /**
+     * Stripe of the calling thread. This is not the stripe of the processor
+     * the thread runs on: a cheap, stable per-thread choice needs no probe,
+     * and keeps all operations of a thread in one stripe, hence in order.
+     */
+    private Stripe stripe() {
+        return this.stripes[(int) (Thread.currentThread().getId() % this.stripes.length)];
+    }
+
+    /**
+     * Track the future of an operation just added to the stripe's batch. The
+     * caller must hold the stripe's monitor.
+     *
+     * @param stripe Stripe the operation was added to.
+     * @param future Future of the operation.
+     * @return Whether the batch is due to be flushed.
+     */
+    private boolean add(final Stripe stripe, final CompletableFuture<Void> future) {
+        stripe.futures.add(future);
+
+        return stripe.futures.size() >= this.maxBatchOps;
+    }
+
+    /**
+     * Write out the pending batch of a stripe.
+     *
+     * <p>
+     * Holding {@code flushLock} for the whole flush keeps a thread's operations
+     * in order across batches, and bounds each stripe to one batch in flight.
+     * Writers only need the stripe's monitor, so they keep adding to the other
+     * batch while a flush runs.
+     * </p>
+     *
+     * <p>
+     * This never throws. If a batch cannot be written or synced for any
+     * reason other than a failed operation, the futures of all of its
+     * operations complete exceptionally, since any of them may not have been
+     * applied.
+     * </p>
+     *
+     * @param stripe Stripe to flush.
+     * @param onlyIfFull Skip the flush unless the batch reached maxBatchOps
+     *      while waiting for {@code flushLock}.
+     */
+    private void flush(final Stripe stripe, final boolean onlyIfFull) {
+        final WriteBatch batch;
+        final List<CompletableFuture<Void>> futures;
+        final Throwable[] errors;
+
+        synchronized (stripe.flushLock) {
+            synchronized (stripe) {
+                if (stripe.futures.isEmpty()
+                        || onlyIfFull && stripe.futures.size() < this.maxBatchOps) {
+                    return;
+                }
+
+                batch = stripe.batch;
+                futures = stripe.futures;
+                stripe.batch = stripe.spare == null ? new WriteBatch() : stripe.spare;
+                stripe.futures = new ArrayList<>(futures.size());
+                stripe.spare = null;
+            }
+
+            try {
+                errors = write(batch, futures.size());
+            } catch (final Throwable e) {
+                fail(futures, e);
+                return;
+            } finally {
+                batch.clear();
+                synchronized (stripe) {
+                    stripe.spare = batch;
+                }
+            }
+        }
+
+        if (this.kvdb == null) {
+            // Dependent stages run here, so do not hold up the stripe.
+            complete(futures, errors, null);
+        } else {
+            try {
+                this.kvdb.syncAsync().whenComplete((mark, e) -> complete(futures, errors, e));
+            } catch (final Throwable e) {
+                complete(futures, errors, e);
+            }
+        }
+    }
+
+    private static void fail(final List<CompletableFuture<Void>> futures, final Throwable e) {
+        for (final CompletableFuture<Void> future : futures) {
+            future.completeExceptionally(e);
+        }
+    }
+
+    private static void complete(final List<CompletableFuture<Void>> futures,
+            final Throwable[] errors, final Throwable syncError) {
+        for (int i = 0; i < futures.size(); i++) {
+            if (errors[i] != null) {
+                futures.get(i).completeExceptionally(errors[i]);
+            } else if (syncError != null) {
+                futures.get(i).completeExceptionally(syncError);
+            } else {
+                futures.get(i).complete(null);
+            }
+        }
+    }
+
+    private Throwable[] write(final WriteBatch batch, final int count) {
+        final Throwable[] errors = new Throwable[count];
+        int from = 0;
+
+        while (from < count) {
+            try {
+                batch.write(this.kvs.handle, 0, from);
+                break;
+            } catch (final HseException e) {
+                // Only the failed operation fails. Resume just past it.
+                final int failed = batch.getFailedIndex();
+
+                errors[failed] = e;
+                from = failed + 1;
+            }
+        }
+
+        return errors;
+    }
+
+    /**
+     * Refer to {@link #delete(ByteBuffer)}.
+     *
+     * @param key Key to be deleted from the KVS.
+     * @return Future which completes once the key has been deleted.
+     * @throws IllegalStateException Coalescer has been closed.
+     */
+    public CompletableFuture<Void> delete(final byte[] key) {
+        final Stripe stripe = stripe();
+        final CompletableFuture<Void> future = new CompletableFuture<>();
+        final boolean full;
+
+        synchronized (stripe) {
+            checkOpen();
+            stripe.batch.delete(key);
+            full = add(stripe, future);
+        }
+
+        if (full) {
+            flush(stripe, true);
+        }
+
+        return future;
+    }
+
+    /**
+     * Coalesce a delete of a key.
+     *
+     * <p>
+     * The {@link ByteBuffer#remaining} bytes of {@code key} are copied, and its
+     * position is advanced to its limit. The buffer does not need to be direct.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param key Key to be deleted from the KVS.
+     * @return Future which completes once the key has been deleted.
+     * @throws IllegalStateException Coalescer has been closed.
+     * @see Kvs#delete(ByteBuffer, KvdbTransaction)
+     */
+    public CompletableFuture<Void> delete(final ByteBuffer key) {
+        final Stripe stripe = stripe();
+        final CompletableFuture<Void> future = new CompletableFuture<>();
+        final boolean full;
+
+        synchronized (stripe) {
+            checkOpen();
+            stripe.batch.delete(key);
+            full = add(stripe, future);
+        }
+
+        if (full) {
+            flush(stripe, true);
+        }
+
+        return future;
+    }
+
+    /**
+     * Write out all pending operations.
+     *
+     * <p>
+     * Returns once every operation added before the call has been written,
+     * though their futures may still be completing.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     */
+    public void flush() {
+        for (final Stripe stripe : this.stripes) {
+            flush(stripe, false);
+        }
+    }
+
+    /**
+     * Refer to {@link #put(ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return Future which completes once the key-value pair has been put.
+     * @throws IllegalStateException Coalescer has been closed.
+     */
+    public CompletableFuture<Void> put(final byte[] key, final byte[] value) {
+        return put(key, value, null);
+    }
+
+    /**
+     * Refer to {@link #put(ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @return Future which completes once the key-value pair has been put.
+     * @throws IllegalStateException Coalescer has been closed.
+     */
+    public CompletableFuture<Void> put(final ByteBuffer key, final ByteBuffer value) {
+        return put(key, value, null);
+    }
+
+    /**
+     * Refer to {@link #put(ByteBuffer, ByteBuffer, EnumSet)}.
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return Future which completes once the key-value pair has been put.
+     * @throws IllegalStateException Coalescer has been closed.
+     */
+    public CompletableFuture<Void> put(final byte[] key, final byte[] value,
+            final EnumSet<PutFlags> flags) {
+        final Stripe stripe = stripe();
+        final CompletableFuture<Void> future = new CompletableFuture<>();
+        final boolean full;
+
+        synchronized (stripe) {
+            checkOpen();
+            stripe.batch.put(key, value, flags);
+            full = add(stripe, future);
+        }
+
+        if (full) {
+            flush(stripe, true);
+        }
+
+        return future;
+    }
+
+    /**
+     * Coalesce a put of a key-value pair.
+     *
+     * <p>
+     * The {@link ByteBuffer#remaining} bytes of {@code key} and {@code value}
+     * are copied, and their positions are advanced to their limits. The
+     * buffers do not need to be direct.
+     * </p>
+     *
+     * <p>This function is thread safe.</p>
+     *
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @return Future which completes once the key-value pair has been put.
+     * @throws IllegalStateException Coalescer has been closed.
+     * @see Kvs#put(ByteBuffer, ByteBuffer, EnumSet, KvdbTransaction)
+     */
+    public CompletableFuture<Void> put(final ByteBuffer key, final ByteBuffer value,
+            final EnumSet<PutFlags> flags) {
+        final Stripe stripe = stripe();
+        final CompletableFuture<Void> future = new CompletableFuture<>();
+        final boolean full;
+
+        synchronized (stripe) {
+            checkOpen();
+            stripe.batch.put(key, value, flags);
+            full = add(stripe, future);
+        }
+
+        if (full) {
+            flush(stripe, true);
+        }
+
+        return future;
+    }
+
+    private void checkOpen() {
+        if (this.closed) {
+            throw new IllegalStateException("Write coalescer is closed");
+        }
+    }
+
+    /**
+     * Flush all pending operations, and stop accepting new ones.
+     *
+     * <p>This function is thread safe.</p>
+     */
+    @Override
+    public void close() {
+        this.closed = true;
+        this.flusher.shutdown();
+
+        /* A writer checks closed under the stripe's monitor, so anything added
+         * before this point is picked up by the final flush.
+         */
+        flush();
+    }
+
+    /** Pending operations of the threads whose ID maps to one stripe. */
+    private static final class Stripe {
+        /** Serializes flushes of the stripe. */
+        private final Object flushLock = new Object();
+        /** Batch operations are being added to. */
+        private WriteBatch batch = new WriteBatch();
+        /** Futures of the operations in {@link #batch}, in order. */
+        private List<CompletableFuture<Void>> futures = new ArrayList<>();
+        /** Cleared batch from the last flush, available for reuse. */
+        private WriteBatch spare;
+    }
+}
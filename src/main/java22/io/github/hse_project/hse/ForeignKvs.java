@@ -0,0 +1,341 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.FunctionDescriptor;
+import java.lang.foreign.Linker;
+import java.lang.foreign.MemorySegment;
+import java.lang.foreign.ValueLayout;
+import java.lang.invoke.MethodHandle;
+import java.util.EnumSet;
+import java.util.Optional;
+
+import io.github.hse_project.hse.Kvs.PutFlags;
+
+/**
+ * {@link MemorySegment} variants of the {@link Kvs} point operations: get,
+ * put, and delete.
+ *
+ * <p>
+ * These call directly into the HSE C library through the Foreign Function and
+ * Memory API rather than through JNI, so there is no JNI transition or array
+ * pinning on each call. They operate on a {@link Kvs} opened through the usual
+ * {@link Kvdb#kvsOpen(String, String...)}, and may be freely mixed with the
+ * JNI-based methods of {@link Kvs}.
+ * </p>
+ *
+ * <p>
+ * Nothing else is offered here on purpose. Prefix deletes, cursors, batches,
+ * and every KVDB, KVS, and transaction lifecycle call stay on JNI, where their
+ * cost is dominated by HSE rather than by the transition.
+ * </p>
+ *
+ * <p>
+ * This class is only available on Java 22 and later. The JNI library is loaded
+ * on first use if it has not been already, but {@link Hse#init(java.nio.file.Path,
+ * String...)} must still have been called, as for any HSE operation.
+ * </p>
+ *
+ * <p>All {@link MemorySegment} parameters must be native.</p>
+ */
+public final class ForeignKvs {
+    /** Size of the out parameters of {@code hse_kvs_get()}. */
+    private static final long GET_OUT_SZ = 16;
+    /** Offset of the {@code size_t} value length out parameter. */
+    private static final long GET_OUT_VAL_LEN_OFFSET = 0;
+    /** Offset of the {@code bool} found out parameter. */
+    private static final long GET_OUT_FOUND_OFFSET = 8;
+    /** Value of {@code HSE_ERR_CTX_TXN_EXPIRED}. */
+    private static final int HSE_ERR_CTX_TXN_EXPIRED = 1;
+
+    /**
+     * Per-thread storage for out parameters, so that a get does not need to
+     * allocate.
+     */
+    private static final ThreadLocal<MemorySegment> GET_OUT = ThreadLocal.withInitial(
+        () -> Arena.ofAuto().allocate(GET_OUT_SZ, Long.BYTES));
+
+    private ForeignKvs() {}
+
+    /**
+     * Lazily resolved downcall handles.
+     *
+     * <p>
+     * The function addresses come from {@link Hse#cforeignSymbols()} rather
+     * than from a symbol lookup, as the JNI library exports nothing but its
+     * load hooks. The indices follow the order of that array.
+     * </p>
+     */
+    private static final class Downcalls {
+        /** Index of {@code hse_err_to_ctx()}. */
+        private static final int ERR_TO_CTX_INDEX = 0;
+        /** Index of {@code hse_err_to_errno()}. */
+        private static final int ERR_TO_ERRNO_INDEX = 1;
+        /** Index of {@code hse_kvs_delete()}. */
+        private static final int KVS_DELETE_INDEX = 2;
+        /** Index of {@code hse_kvs_get()}. */
+        private static final int KVS_GET_INDEX = 3;
+        /** Index of {@code hse_kvs_put()}. */
+        private static final int KVS_PUT_INDEX = 4;
+        /** Index of {@code hse_strerror()}. */
+        private static final int STRERROR_INDEX = 5;
+
+        /** {@code hse_kvs_delete()}. */
+        static final MethodHandle KVS_DELETE;
+        /** {@code hse_kvs_get()}. */
+        static final MethodHandle KVS_GET;
+        /** {@code hse_kvs_put()}. */
+        static final MethodHandle KVS_PUT;
+        /** {@code hse_err_to_ctx()}. */
+        static final MethodHandle ERR_TO_CTX;
+        /** {@code hse_err_to_errno()}. */
+        static final MethodHandle ERR_TO_ERRNO;
+        /** {@code hse_strerror()}. */
+        static final MethodHandle STRERROR;
+
+        static {
+            Hse.loadLibrary();
+
+            final Linker linker = Linker.nativeLinker();
+            final long[] symbols = Hse.cforeignSymbols();
+
+            ERR_TO_CTX = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[ERR_TO_CTX_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_INT, ValueLayout.JAVA_LONG));
+            ERR_TO_ERRNO = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[ERR_TO_ERRNO_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_INT, ValueLayout.JAVA_LONG));
+            KVS_DELETE = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[KVS_DELETE_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_LONG, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_INT, ValueLayout.ADDRESS, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_LONG));
+            KVS_GET = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[KVS_GET_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_LONG, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_INT, ValueLayout.ADDRESS, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_LONG, ValueLayout.ADDRESS, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_LONG, ValueLayout.ADDRESS));
+            KVS_PUT = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[KVS_PUT_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_LONG, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_INT, ValueLayout.ADDRESS, ValueLayout.ADDRESS,
+                    ValueLayout.JAVA_LONG, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+            STRERROR = linker.downcallHandle(
+                MemorySegment.ofAddress(symbols[STRERROR_INDEX]),
+                FunctionDescriptor.of(ValueLayout.JAVA_LONG, ValueLayout.JAVA_LONG,
+                    ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+        }
+    }
+
+    private static MemorySegment address(final NativeObject obj) {
+        return obj == null ? MemorySegment.NULL : MemorySegment.ofAddress(obj.handle);
+    }
+
+    private static MemorySegment orNull(final MemorySegment segment) {
+        assert segment == null || segment.isNative();
+
+        return segment == null ? MemorySegment.NULL : segment;
+    }
+
+    private static long byteSize(final MemorySegment segment) {
+        return segment == null ? 0 : segment.byteSize();
+    }
+
+    private static HseException toException(final long err) throws Throwable {
+        final long neededSz = (long) Downcalls.STRERROR.invokeExact(err, MemorySegment.NULL,
+            0L);
+
+        final String message;
+        try (Arena arena = Arena.ofConfined()) {
+            final MemorySegment buf = arena.allocate(neededSz + 1);
+            final long unused = (long) Downcalls.STRERROR.invokeExact(err, buf, neededSz + 1);
+
+            message = buf.getString(0);
+        }
+
+        final int errno = (int) Downcalls.ERR_TO_ERRNO.invokeExact(err);
+        final int ctx = (int) Downcalls.ERR_TO_CTX.invokeExact(err);
+
+        return new HseException(message, errno, ctx == HSE_ERR_CTX_TXN_EXPIRED
+            ? HseException.Context.TXN_EXPIRED : HseException.Context.NONE);
+    }
+
+    private static void check(final long err) throws HseException {
+        if (err == 0) {
+            return;
+        }
+
+        try {
+            throw toException(err);
+        } catch (final HseException e) {
+            throw e;
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+    }
+
+    /**
+     * Refer to {@link #delete(Kvs, MemorySegment, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to delete from.
+     * @param key Key to delete from the KVS.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public static void delete(final Kvs kvs, final MemorySegment key) throws HseException {
+        delete(kvs, key, null);
+    }
+
+    /**
+     * Delete the key and its associated value from the KVS.
+     *
+     * @param kvs KVS to delete from.
+     * @param key Key to delete from the KVS.
+     * @param txn Transaction context.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @see Kvs#delete(java.nio.ByteBuffer, KvdbTransaction)
+     */
+    public static void delete(final Kvs kvs, final MemorySegment key, final KvdbTransaction txn)
+            throws HseException {
+        final long err;
+        try {
+            err = (long) Downcalls.KVS_DELETE.invokeExact(address(kvs), 0, address(txn),
+                orNull(key), byteSize(key));
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+
+        check(err);
+    }
+
+    /**
+     * Refer to {@link #get(Kvs, MemorySegment, MemorySegment, KvdbTransaction)}.
+     *
+     * <p>{@code txn} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to get from.
+     * @param key Key to get from the KVS.
+     * @param valueBuf Buffer into which the value associated with {@code key} will
+     *     be copied.
+     * @return Length of the value, or {@link Optional#empty()} if {@code key} was
+     *     not found.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public static Optional<Integer> get(final Kvs kvs, final MemorySegment key,
+            final MemorySegment valueBuf) throws HseException {
+        return get(kvs, key, valueBuf, null);
+    }
+
+    /**
+     * Retrieve the value for a given key from the KVS.
+     *
+     * <p>
+     * At most {@code valueBuf.byteSize()} bytes of the value are copied into
+     * {@code valueBuf}. The returned length is that of the whole value, so a
+     * value larger than the buffer can be detected by comparing the two.
+     * </p>
+     *
+     * @param kvs KVS to get from.
+     * @param key Key to get from the KVS.
+     * @param valueBuf Buffer into which the value associated with {@code key} will
+     *     be copied.
+     * @param txn Transaction context.
+     * @return Length of the value, or {@link Optional#empty()} if {@code key} was
+     *     not found.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @see Kvs#get(java.nio.ByteBuffer, java.nio.ByteBuffer, KvdbTransaction)
+     */
+    public static Optional<Integer> get(final Kvs kvs, final MemorySegment key,
+            final MemorySegment valueBuf, final KvdbTransaction txn) throws HseException {
+        final MemorySegment out = GET_OUT.get();
+
+        final long err;
+        try {
+            err = (long) Downcalls.KVS_GET.invokeExact(address(kvs), 0, address(txn),
+                orNull(key), byteSize(key), out.asSlice(GET_OUT_FOUND_OFFSET),
+                orNull(valueBuf), byteSize(valueBuf), out.asSlice(GET_OUT_VAL_LEN_OFFSET));
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+
+        check(err);
+
+        if (!out.get(ValueLayout.JAVA_BOOLEAN, GET_OUT_FOUND_OFFSET)) {
+            return Optional.empty();
+        }
+
+        return Optional.of((int) out.get(ValueLayout.JAVA_LONG, GET_OUT_VAL_LEN_OFFSET));
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, MemorySegment, MemorySegment, EnumSet, KvdbTransaction)}.
+     *
+     * <p>{@code flags} and {@code txn} default to {@code null}.</p>
+     *
+     * @param kvs KVS to put into.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public static void put(final Kvs kvs, final MemorySegment key, final MemorySegment value)
+            throws HseException {
+        put(kvs, key, value, null, null);
+    }
+
+    /**
+     * Refer to {@link #put(Kvs, MemorySegment, MemorySegment, EnumSet, KvdbTransaction)}.
+     *
+     * <p>{@code flags} defaults to {@code null}.</p>
+     *
+     * @param kvs KVS to put into.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param txn Transaction context.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     */
+    public static void put(final Kvs kvs, final MemorySegment key, final MemorySegment value,
+            final KvdbTransaction txn) throws HseException {
+        put(kvs, key, value, null, txn);
+    }
+
+    /**
+     * Put a key-value pair into the KVS.
+     *
+     * @param kvs KVS to put into.
+     * @param key Key to put into the KVS.
+     * @param value Value associated with {@code key}.
+     * @param flags Flags for operation specialization.
+     * @param txn Transaction context.
+     * @throws AssertionError All {@link MemorySegment} parameters must be native.
+     * @throws HseException Underlying C function returned a non-zero value.
+     * @see Kvs#put(java.nio.ByteBuffer, java.nio.ByteBuffer, EnumSet, KvdbTransaction)
+     */
+    public static void put(final Kvs kvs, final MemorySegment key, final MemorySegment value,
+            final EnumSet<PutFlags> flags, final KvdbTransaction txn) throws HseException {
+        final int flagsValue = flags == null ? 0 : flags.stream()
+            .mapToInt(flag -> 1 << flag.ordinal())
+            .sum();
+
+        final long err;
+        try {
+            err = (long) Downcalls.KVS_PUT.invokeExact(address(kvs), flagsValue, address(txn),
+                orNull(key), byteSize(key), orNull(value), byteSize(value));
+        } catch (final Throwable e) {
+            throw new AssertionError(e);
+        }
+
+        check(err);
+    }
+}
@@ -7,16 +7,23 @@ package io.github.hse_project.hse;
 
 import static org.junit.jupiter.api.Assertions.assertArrayEquals;
 import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
 import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
 import static org.junit.jupiter.api.Assertions.fail;
 
 import java.io.EOFException;
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 import java.util.EnumSet;
+import java.util.List;
+import java.util.Map;
 import java.util.Optional;
 import java.util.AbstractMap.SimpleImmutableEntry;
+import java.util.stream.Collectors;
+import java.util.stream.Stream;
 
 import org.junit.jupiter.api.AfterAll;
 import org.junit.jupiter.api.AfterEach;
@@ -457,6 +464,209 @@ public final class CursorTest {
         });
     }
 
+    @Test
+    public void read_Entry() throws HseException {
+        final KvsCursor.Entry entry = new KvsCursor.Entry();
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                final byte[] key = String.format("key%d", i).getBytes(StandardCharsets.UTF_8);
+                final byte[] value = String.format("value%d", i).getBytes(StandardCharsets.UTF_8);
+
+                assertTrue(cursor.read(entry));
+                assertEquals(key.length, entry.getKeyLength());
+                assertEquals(value.length, entry.getValueLength());
+                assertEquals(ByteBuffer.wrap(key), entry.getKey());
+                assertEquals(ByteBuffer.wrap(value), entry.getValue());
+            }
+
+            assertFalse(cursor.read(entry));
+            assertFalse(cursor.read(entry));
+            assertEquals(ByteBuffer.wrap("key4".getBytes(StandardCharsets.UTF_8)),
+                entry.getKey());
+        }
+    }
+
+    @Test
+    public void read_EntryTruncated() throws HseException {
+        final KvsCursor.Entry entry = new KvsCursor.Entry(3, 5);
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            assertTrue(cursor.read(entry));
+            assertEquals(4, entry.getKeyLength());
+            assertEquals(6, entry.getValueLength());
+            assertEquals(ByteBuffer.wrap("key".getBytes(StandardCharsets.UTF_8)),
+                entry.getKey());
+            assertEquals(ByteBuffer.wrap("value".getBytes(StandardCharsets.UTF_8)),
+                entry.getValue());
+        }
+    }
+
+    @Test
+    public void read_View() throws HseException {
+        final KvsCursor.View view = new KvsCursor.View();
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                final byte[] key = String.format("key%d", i).getBytes(StandardCharsets.UTF_8);
+                final byte[] value = String.format("value%d", i).getBytes(StandardCharsets.UTF_8);
+
+                assertTrue(cursor.read(view));
+                assertTrue(view.getKey().isDirect());
+                assertTrue(view.getKey().isReadOnly());
+                assertTrue(view.getValue().isReadOnly());
+                assertEquals(ByteBuffer.wrap(key), view.getKey());
+                assertEquals(ByteBuffer.wrap(value), view.getValue());
+            }
+
+            assertFalse(cursor.read(view));
+        }
+    }
+
+    private static void assertRecord(final ByteBuffer buf, final int i) {
+        final byte[] key = String.format("key%d", i).getBytes(StandardCharsets.UTF_8);
+        final byte[] value = String.format("value%d", i).getBytes(StandardCharsets.UTF_8);
+        final byte[] foundKey = new byte[buf.getInt()];
+        final byte[] foundValue = new byte[buf.getInt()];
+
+        buf.get(foundKey).get(foundValue);
+        assertArrayEquals(key, foundKey);
+        assertArrayEquals(value, foundValue);
+    }
+
+    @Test
+    public void readBatch() throws HseException {
+        final ByteBuffer buf = ByteBuffer.allocateDirect(1024).order(ByteOrder.nativeOrder());
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            assertEquals(0, cursor.readBatch(buf, 0));
+            assertEquals(0, buf.remaining());
+
+            buf.clear();
+            assertEquals(2, cursor.readBatch(buf, 2));
+            assertRecord(buf, 0);
+            assertRecord(buf, 1);
+            assertEquals(0, buf.remaining());
+
+            buf.clear();
+            assertEquals(NUM_ENTRIES - 2, cursor.readBatch(buf, Integer.MAX_VALUE));
+            for (int i = 2; i < NUM_ENTRIES; i++) {
+                assertRecord(buf, i);
+            }
+            assertEquals(0, buf.remaining());
+
+            buf.clear();
+            assertEquals(-1, cursor.readBatch(buf, Integer.MAX_VALUE));
+            assertEquals(0, buf.remaining());
+        }
+
+        try (KvsCursor cursor = kvs.cursor(EnumSet.of(KvsCursor.CreateFlags.REV))) {
+            buf.clear();
+            assertEquals(NUM_ENTRIES, cursor.readBatch(buf, Integer.MAX_VALUE));
+            for (int i = NUM_ENTRIES - 1; i >= 0; i--) {
+                assertRecord(buf, i);
+            }
+        }
+    }
+
+    @Test
+    public void readBatch_SmallBuffer() throws HseException, EOFException {
+        // Exactly one record: two lengths, "keyN", and "valueN"
+        final int recordSz = 2 * Integer.BYTES + 4 + 6;
+        final ByteBuffer buf = ByteBuffer.allocateDirect(recordSz + 1)
+            .order(ByteOrder.nativeOrder());
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            buf.limit(recordSz - 1);
+            assertEquals(0, cursor.readBatch(buf, Integer.MAX_VALUE));
+            assertEquals(0, buf.remaining());
+
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                buf.clear();
+                assertEquals(1, cursor.readBatch(buf, Integer.MAX_VALUE));
+                assertRecord(buf, i);
+            }
+
+            buf.clear();
+            assertEquals(-1, cursor.readBatch(buf, Integer.MAX_VALUE));
+            assertThrows(EOFException.class, () -> cursor.read());
+        }
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            buf.limit(recordSz - 1);
+            assertEquals(0, cursor.readBatch(buf, Integer.MAX_VALUE));
+
+            final SimpleImmutableEntry<byte[], byte[]> entry = cursor.read();
+            assertArrayEquals("key0".getBytes(StandardCharsets.UTF_8), entry.getKey());
+        }
+    }
+
+    @Test
+    public void readBatch_SmallBufferSeekRange() throws HseException {
+        // Exactly one record: two lengths, "keyN", and "valueN"
+        final int recordSz = 2 * Integer.BYTES + 4 + 6;
+        final ByteBuffer buf = ByteBuffer.allocateDirect(recordSz + 1)
+            .order(ByteOrder.nativeOrder());
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            cursor.seekRange("key1", "key2");
+
+            // A record which does not fit must not lose the bound.
+            for (int i = 1; i <= 2; i++) {
+                buf.clear().limit(recordSz - 1);
+                assertEquals(0, cursor.readBatch(buf, Integer.MAX_VALUE));
+
+                buf.clear();
+                assertEquals(1, cursor.readBatch(buf, Integer.MAX_VALUE));
+                assertRecord(buf, i);
+            }
+
+            buf.clear();
+            assertEquals(-1, cursor.readBatch(buf, Integer.MAX_VALUE));
+        }
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            buf.limit(recordSz - 1);
+            assertEquals(0, cursor.readBatch(buf, Integer.MAX_VALUE));
+
+            // Seeking discards the record which did not fit.
+            cursor.seek("key3");
+            buf.clear();
+            assertEquals(1, cursor.readBatch(buf, 1));
+            assertRecord(buf, 3);
+        }
+    }
+
+    @Test
+    public void readBatchAsync() throws Exception {
+        final ByteBuffer buf = ByteBuffer.allocateDirect(1024).order(ByteOrder.nativeOrder());
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            assertEquals(2, cursor.readBatchAsync(buf, 2).get());
+            assertRecord(buf, 0);
+            assertRecord(buf, 1);
+
+            buf.clear();
+            assertEquals(NUM_ENTRIES - 2, cursor.readBatchAsync(buf, Integer.MAX_VALUE).get());
+            for (int i = 2; i < NUM_ENTRIES; i++) {
+                assertRecord(buf, i);
+            }
+            assertEquals(0, buf.remaining());
+
+            buf.clear();
+            assertEquals(-1, cursor.readBatchAsync(buf, Integer.MAX_VALUE).get());
+        }
+    }
+
+    @Test
+    public void readBatch_NonDirectByteBuffer() {
+        assertThrows(AssertionError.class, () -> {
+            try (KvsCursor cursor = kvs.cursor()) {
+                cursor.readBatch(ByteBuffer.allocate(1024), 1);
+            }
+        });
+    }
+
     @Test
     public void seek() throws HseException {
         final String key = "key3";
@@ -908,6 +1118,120 @@ public final class CursorTest {
         });
     }
 
+    @Test
+    public void prefetch() throws HseException, InterruptedException {
+        final KvsCursor.View view = new KvsCursor.View();
+
+        // Small buffers hold one record each, so every record is its own batch.
+        for (final int bufSz : new int[]{32, 4096}) {
+            try (KvsCursor cursor = kvs.cursor();
+                    PrefetchingCursor prefetch = cursor.prefetch(2, bufSz)) {
+                for (int i = 0; i < NUM_ENTRIES; i++) {
+                    assertTrue(prefetch.read(view));
+                    assertEquals(String.format("key%d", i),
+                        StandardCharsets.UTF_8.decode(view.getKey()).toString());
+                    assertEquals(String.format("value%d", i),
+                        StandardCharsets.UTF_8.decode(view.getValue()).toString());
+                }
+                assertFalse(prefetch.read(view));
+            }
+        }
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            final PrefetchingCursor prefetch = cursor.prefetch(4);
+
+            assertTrue(prefetch.read(view));
+            prefetch.close();
+            prefetch.close();
+            assertThrows(IllegalStateException.class, () -> prefetch.read(view));
+        }
+
+        try (KvsCursor cursor = kvs.cursor();
+                PrefetchingCursor prefetch = cursor.prefetch(1, 8)) {
+            assertThrows(IllegalStateException.class, () -> prefetch.read(view));
+        }
+
+        try (KvsCursor cursor = kvs.cursor()) {
+            assertThrows(IllegalArgumentException.class, () -> cursor.prefetch(0));
+        }
+    }
+
+    @Test
+    public void stream() throws HseException {
+        try (Stream<Map.Entry<byte[], byte[]>> stream = kvs.stream()) {
+            final List<String> keys = stream
+                .map(entry -> new String(entry.getKey(), StandardCharsets.UTF_8))
+                .collect(Collectors.toList());
+
+            assertEquals(NUM_ENTRIES, keys.size());
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                assertEquals(String.format("key%d", i), keys.get(i));
+            }
+        }
+
+        try (Stream<Map.Entry<byte[], byte[]>> stream = kvs.stream(
+                "key1".getBytes(StandardCharsets.UTF_8), "key3".getBytes(StandardCharsets.UTF_8))) {
+            final List<String> values = stream
+                .map(entry -> new String(entry.getValue(), StandardCharsets.UTF_8))
+                .collect(Collectors.toList());
+
+            assertEquals(Arrays.asList("value1", "value2", "value3"), values);
+        }
+
+        try (Stream<Map.Entry<byte[], byte[]>> stream = kvs.stream().parallel()) {
+            final List<String> keys = stream
+                .map(entry -> new String(entry.getKey(), StandardCharsets.UTF_8))
+                .collect(Collectors.toList());
+
+            assertEquals(NUM_ENTRIES, keys.size());
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                assertEquals(String.format("key%d", i), keys.get(i));
+            }
+        }
+
+        // Not reading to the end leaves the cursor to be closed with the stream.
+        try (Stream<Map.Entry<byte[], byte[]>> stream = kvs.stream()) {
+            assertTrue(stream.findFirst().isPresent());
+        }
+    }
+
+    @Test
+    public void stream_LargeValue() throws HseException {
+        // Larger than the batch buffer a stream starts with.
+        final byte[] large = new byte[Limits.KVS_VALUE_LEN_MAX];
+        Arrays.fill(large, (byte) 'x');
+        kvs.put("key2".getBytes(StandardCharsets.UTF_8), large);
+
+        try (Stream<Map.Entry<byte[], byte[]>> stream = kvs.stream(
+                "key1".getBytes(StandardCharsets.UTF_8), "key3".getBytes(StandardCharsets.UTF_8))
+                .parallel()) {
+            final List<Integer> lengths = stream
+                .map(entry -> entry.getValue().length)
+                .collect(Collectors.toList());
+
+            assertEquals(Arrays.asList(6, Limits.KVS_VALUE_LEN_MAX, 6), lengths);
+        }
+    }
+
+    @Test
+    public void stream_Transaction() throws HseException {
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            addData(txnKvs, txn);
+
+            try (Stream<Map.Entry<byte[], byte[]>> stream = txnKvs.stream(txn).parallel()) {
+                assertEquals(NUM_ENTRIES, stream.count());
+            }
+
+            try (Stream<Map.Entry<byte[], byte[]>> stream = txnKvs.stream()) {
+                assertEquals(0, stream.count());
+            }
+
+            txn.abort();
+        }
+    }
+
     @Test
     public void createFlags() {
         for (final KvsCursor.CreateFlags flag : EnumSet.allOf(KvsCursor.CreateFlags.class)) {
@@ -7,12 +7,15 @@ package io.github.hse_project.hse;
 
 import static org.junit.jupiter.api.Assertions.assertArrayEquals;
 import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
 import static org.junit.jupiter.api.Assertions.assertNotEquals;
 import static org.junit.jupiter.api.Assertions.assertThrows;
 import static org.junit.jupiter.api.Assertions.assertTrue;
 import static org.junit.jupiter.api.Assertions.fail;
 
 import java.nio.file.Paths;
+import java.util.EnumSet;
+import java.util.concurrent.CompletableFuture;
 
 import org.junit.jupiter.api.AfterAll;
 import org.junit.jupiter.api.BeforeAll;
@@ -93,4 +96,36 @@ public final class KvdbTest {
     public void sync() throws HseException {
         kvdb.sync();
     }
+
+    @Test
+    public void syncAsync() throws Exception {
+        final long mark = kvdb.getSyncMark();
+
+        assertFalse(kvdb.isDurable(mark));
+
+        kvdb.syncAsync(EnumSet.of(Kvdb.SyncFlags.ASYNC)).get();
+
+        final CompletableFuture<?>[] futures = new CompletableFuture<?>[8];
+        for (int i = 0; i < futures.length; i++) {
+            futures[i] = kvdb.syncAsync();
+        }
+        CompletableFuture.allOf(futures).get();
+
+        assertTrue(kvdb.isDurable(mark));
+        assertTrue(kvdb.getDurableMark() >= mark);
+        assertTrue(kvdb.getSyncMark() > kvdb.getDurableMark());
+    }
+
+    @Test
+    public void syncAsync_AfterClose() throws HseException {
+        kvdb.close();
+        try {
+            assertThrows(IllegalStateException.class, () -> kvdb.syncAsync());
+            assertThrows(IllegalStateException.class, () -> kvdb.getSyncMark());
+            assertThrows(IllegalStateException.class, () -> kvdb.getDurableMark());
+            assertThrows(IllegalStateException.class, () -> kvdb.isDurable(1));
+        } finally {
+            kvdb = Kvdb.open(TestUtils.getKvdbHome());
+        }
+    }
 }
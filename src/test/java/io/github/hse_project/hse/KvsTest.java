@@ -8,13 +8,18 @@ package io.github.hse_project.hse;
 import static org.junit.jupiter.api.Assertions.assertArrayEquals;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertInstanceOf;
 import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
 
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 import java.util.EnumSet;
 import java.util.Optional;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ExecutionException;
 
 import org.junit.jupiter.api.AfterAll;
 import org.junit.jupiter.api.AfterEach;
@@ -24,6 +29,7 @@ import org.junit.jupiter.api.Test;
 
 public final class KvsTest {
     private static final int NUM_ENTRIES = 5;
+    private static final int ASYNC_THREADS = 4;
     private static Kvdb kvdb;
     private static Kvs kvs;
     private static Kvs txnKvs;
@@ -32,6 +38,8 @@ public final class KvsTest {
     public static void setupSuite() throws HseException {
         TestUtils.registerShutdownHook();
         Hse.init("rest.enabled=false");
+        // Several workers, even on one CPU, so that they contend for transactions.
+        Hse.setAsyncThreads(ASYNC_THREADS);
         kvdb = TestUtils.setupKvdb();
     }
 
@@ -226,6 +234,58 @@ public final class KvsTest {
         Arrays.fill(valueBufArray, (byte) 0);
     }
 
+    @Test
+    public void get_LargeValue() throws HseException {
+        final String key = String.format("key%d", NUM_ENTRIES);
+        final byte[] keyData = key.getBytes(StandardCharsets.UTF_8);
+        final ByteBuffer keyBuffer = ByteBuffer.allocateDirect(keyData.length);
+        final byte[] value = new byte[Limits.KVS_VALUE_LEN_MAX];
+
+        for (int i = 0; i < value.length; i++) {
+            value[i] = (byte) i;
+        }
+
+        kvs.put(key, value);
+
+        assertArrayEquals(value, kvs.get(key).get());
+        assertArrayEquals(value, kvs.get(keyData).get());
+        keyBuffer.put(keyData);
+        keyBuffer.position(0);
+        assertArrayEquals(value, kvs.get(keyBuffer).get());
+
+        // Smaller values must still be returned in full after the buffer grew.
+        assertArrayEquals("value0".getBytes(StandardCharsets.UTF_8), kvs.get("key0").get());
+    }
+
+    @Test
+    public void get_LargeValueBuf() throws HseException {
+        final byte[] key = String.format("key%d", NUM_ENTRIES).getBytes(StandardCharsets.UTF_8);
+        final byte[] value = new byte[Limits.KVS_VALUE_LEN_MAX];
+        final byte[] valueBuf = new byte[Limits.KVS_VALUE_LEN_MAX];
+        final byte[] smallValueBuf = new byte[Byte.MAX_VALUE];
+        Optional<Integer> valueLen;
+
+        for (int i = 0; i < value.length; i++) {
+            value[i] = (byte) i;
+        }
+
+        kvs.put(key, value);
+
+        valueLen = kvs.get(key, valueBuf);
+        assertEquals(value.length, valueLen.get());
+        assertArrayEquals(value, valueBuf);
+
+        // Only as much of the value as fits is copied into the buffer.
+        valueLen = kvs.get(key, smallValueBuf);
+        assertEquals(value.length, valueLen.get());
+        assertArrayEquals(Arrays.copyOf(value, smallValueBuf.length), smallValueBuf);
+
+        // Buffer contents are left alone when the key does not exist.
+        Arrays.fill(valueBuf, (byte) 0);
+        assertFalse(kvs.get("nonexistent".getBytes(StandardCharsets.UTF_8), valueBuf).isPresent());
+        assertArrayEquals(new byte[valueBuf.length], valueBuf);
+    }
+
     @Test
     public void get_Transactional() throws HseException {
         try (KvdbTransaction txn = kvdb.transaction()) {
@@ -290,6 +350,95 @@ public final class KvsTest {
         }
     }
 
+    @Test
+    public void getBatch_NonDirectByteBuffer() {
+        final byte[][] keys = new byte[][]{"key0".getBytes(StandardCharsets.UTF_8)};
+
+        assertThrows(AssertionError.class, () -> kvs.getBatch(keys, ByteBuffer.allocate(16)));
+        assertThrows(AssertionError.class,
+            () -> kvs.getBatch(ByteBuffer.allocate(16), ByteBuffer.allocateDirect(16)));
+    }
+
+    @Test
+    public void getBatch() throws HseException {
+        final byte[][] keys = new byte[][]{
+            "key0".getBytes(StandardCharsets.UTF_8),
+            "missing".getBytes(StandardCharsets.UTF_8),
+            "key2".getBytes(StandardCharsets.UTF_8),
+        };
+        final ByteBuffer packedKeys = ByteBuffer.allocateDirect(64).order(ByteOrder.nativeOrder());
+        final ByteBuffer valueBuf = ByteBuffer.allocateDirect(64).order(ByteOrder.nativeOrder());
+        final byte[] value = new byte[6];
+
+        for (final byte[] key : keys) {
+            packedKeys.putInt(key.length).put(key);
+        }
+        packedKeys.flip();
+
+        assertEquals(3, kvs.getBatch(keys, valueBuf));
+        assertEquals(6, valueBuf.getInt());
+        valueBuf.get(value);
+        assertArrayEquals("value0".getBytes(StandardCharsets.UTF_8), value);
+        assertEquals(-1, valueBuf.getInt());
+        assertEquals(6, valueBuf.getInt());
+        valueBuf.get(value);
+        assertArrayEquals("value2".getBytes(StandardCharsets.UTF_8), value);
+        assertFalse(valueBuf.hasRemaining());
+
+        valueBuf.clear();
+        assertEquals(3, kvs.getBatch(packedKeys, valueBuf));
+        assertFalse(packedKeys.hasRemaining());
+        assertEquals(6, valueBuf.getInt());
+        valueBuf.get(value);
+        assertArrayEquals("value0".getBytes(StandardCharsets.UTF_8), value);
+        assertEquals(-1, valueBuf.getInt());
+        assertEquals(6, valueBuf.getInt());
+        valueBuf.get(value);
+        assertArrayEquals("value2".getBytes(StandardCharsets.UTF_8), value);
+    }
+
+    @Test
+    public void getBatch_Partial() throws HseException {
+        final byte[][] keys = new byte[][]{
+            "key0".getBytes(StandardCharsets.UTF_8),
+            "key1".getBytes(StandardCharsets.UTF_8),
+        };
+        final ByteBuffer valueBuf = ByteBuffer.allocateDirect(Integer.BYTES + 6)
+            .order(ByteOrder.nativeOrder());
+
+        assertEquals(1, kvs.getBatch(keys, valueBuf));
+        assertEquals(Integer.BYTES + 6, valueBuf.limit());
+        assertEquals(6, valueBuf.getInt());
+
+        valueBuf.clear();
+        valueBuf.limit(Integer.BYTES);
+        assertEquals(0, kvs.getBatch(keys, valueBuf));
+        assertEquals(0, valueBuf.limit());
+    }
+
+    @Test
+    public void getBatch_Transactional() throws HseException {
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            final String key = String.format("key%d", NUM_ENTRIES);
+            final byte[][] keys = new byte[][]{key.getBytes(StandardCharsets.UTF_8)};
+            final ByteBuffer valueBuf = ByteBuffer.allocateDirect(16)
+                .order(ByteOrder.nativeOrder());
+
+            txnKvs.put(key, "value", txn);
+
+            assertEquals(1, txnKvs.getBatch(keys, valueBuf, txn));
+            assertEquals(5, valueBuf.getInt());
+
+            valueBuf.clear();
+            assertEquals(1, txnKvs.getBatch(keys, valueBuf, null));
+            assertEquals(-1, valueBuf.getInt());
+
+            txn.abort();
+        }
+    }
+
     @Test
     public void getName() {
         assertEquals("kvs", kvs.getName());
@@ -434,6 +583,26 @@ public final class KvsTest {
         valueBuffer.position(0);
     }
 
+    @Test
+    public void put_String() throws HseException {
+        // NUL, 2 and 3 byte sequences, a surrogate pair, and an unpaired surrogate
+        final String key = "k\u0000\u00e9\u20ac\ud83d\ude00\ud800";
+        final StringBuilder value = new StringBuilder();
+        final byte[] keyData = key.getBytes(StandardCharsets.UTF_8);
+
+        // Long enough to not be copied onto the stack
+        for (int i = 0; i < Short.MAX_VALUE / key.length(); i++) {
+            value.append(key);
+        }
+
+        kvs.put(key, value.toString());
+        assertArrayEquals(value.toString().getBytes(StandardCharsets.UTF_8),
+            kvs.get(keyData).get());
+
+        kvs.delete(key);
+        assertFalse(kvs.get(keyData).isPresent());
+    }
+
     @Test
     public void put_Transactional() throws HseException {
         final String key = String.format("key%d", NUM_ENTRIES);
@@ -506,6 +675,109 @@ public final class KvsTest {
         }
     }
 
+    @Test
+    public void putAsync() throws Exception {
+        final byte[] keyData = String.format("key%d", NUM_ENTRIES).getBytes(StandardCharsets.UTF_8);
+        final byte[] valueData = String.format("value%d", NUM_ENTRIES)
+            .getBytes(StandardCharsets.UTF_8);
+
+        assertThrows(IllegalArgumentException.class, () -> Hse.setAsyncThreads(0));
+
+        assertFalse(kvs.getAsync(keyData).get().isPresent());
+
+        kvs.putAsync(keyData, valueData).get();
+        assertArrayEquals(valueData, kvs.getAsync(keyData).get().get());
+        kvs.deleteAsync(keyData).get();
+        assertFalse(kvs.getAsync(keyData).get().isPresent());
+
+        kvs.putAsync(keyData, valueData, EnumSet.of(Kvs.PutFlags.PRIO)).get();
+        assertArrayEquals(valueData, kvs.get(keyData).get());
+
+        final ExecutionException e = assertThrows(ExecutionException.class,
+            () -> kvs.putAsync(null, valueData).get());
+        assertInstanceOf(HseException.class, e.getCause());
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            txnKvs.putAsync(keyData, valueData, txn).get();
+            assertFalse(txnKvs.get(keyData).isPresent());
+            assertArrayEquals(valueData, txnKvs.getAsync(keyData, txn).get().get());
+            txnKvs.deleteAsync(keyData, txn).get();
+            assertFalse(txnKvs.getAsync(keyData, txn).get().isPresent());
+
+            txn.abort();
+        }
+    }
+
+    @Test
+    public void putAsync_DrainedByClose() throws Exception {
+        final byte[] valueData = "value".getBytes(StandardCharsets.UTF_8);
+        @SuppressWarnings("unchecked")
+        final CompletableFuture<Void>[] futures = new CompletableFuture[1000];
+
+        for (int i = 0; i < futures.length; i++) {
+            futures[i] = kvs.putAsync(String.format("drain%d", i)
+                .getBytes(StandardCharsets.UTF_8), valueData);
+        }
+        kvs.close();
+
+        for (final CompletableFuture<Void> future : futures) {
+            assertTrue(future.isDone());
+            future.get();
+        }
+    }
+
+    @Test
+    public void putAsync_DrainedByCommit() throws Exception {
+        final byte[] valueData = "value".getBytes(StandardCharsets.UTF_8);
+        @SuppressWarnings("unchecked")
+        final CompletableFuture<Void>[] futures = new CompletableFuture[1000];
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            for (int i = 0; i < futures.length; i++) {
+                futures[i] = txnKvs.putAsync(String.format("drain%d", i)
+                    .getBytes(StandardCharsets.UTF_8), valueData, txn);
+            }
+            txn.commit();
+
+            for (final CompletableFuture<Void> future : futures) {
+                assertTrue(future.isDone());
+                future.get();
+            }
+        }
+
+        for (int i = 0; i < futures.length; i++) {
+            assertTrue(txnKvs.get(String.format("drain%d", i)).isPresent());
+        }
+    }
+
+    @Test
+    public void putAsync_OneTransaction() throws Exception {
+        final byte[] valueData = "value".getBytes(StandardCharsets.UTF_8);
+        @SuppressWarnings("unchecked")
+        final CompletableFuture<Void>[] futures = new CompletableFuture[1000];
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            for (int i = 0; i < futures.length; i++) {
+                futures[i] = txnKvs.putAsync(String.format("serial%d", i)
+                    .getBytes(StandardCharsets.UTF_8), valueData, txn);
+            }
+
+            // Let the workers run every put, rather than the commit.
+            CompletableFuture.allOf(futures).get();
+            txn.commit();
+        }
+
+        for (int i = 0; i < futures.length; i++) {
+            assertArrayEquals(valueData, txnKvs.get(String.format("serial%d", i)).get());
+        }
+    }
+
     @Test
     public void putFlags() {
         for (final Kvs.PutFlags flag : EnumSet.allOf(Kvs.PutFlags.class)) {
@@ -524,4 +796,111 @@ public final class KvsTest {
             }
         }
     }
+
+    private static KvsRing.Completion reap(final KvsRing ring) {
+        final KvsRing.Completion completion = new KvsRing.Completion();
+        while (!ring.poll(completion)) {
+            Thread.yield();
+        }
+
+        return completion;
+    }
+
+    @Test
+    public void ring() throws HseException {
+        final byte[] keyData = String.format("key%d", NUM_ENTRIES).getBytes(StandardCharsets.UTF_8);
+        final byte[] valueData = String.format("value%d", NUM_ENTRIES)
+            .getBytes(StandardCharsets.UTF_8);
+        final int valueOff = keyData.length;
+        final int valueBufOff = valueOff + valueData.length;
+        final ByteBuffer buf = ByteBuffer.allocateDirect(64);
+
+        buf.put(keyData).put(valueData);
+
+        assertThrows(IllegalArgumentException.class, () -> kvs.ring(buf, 3));
+        assertThrows(IllegalArgumentException.class, () -> kvs.ring(ByteBuffer.allocate(64), 2));
+
+        try (KvsRing ring = kvs.ring(buf, 2)) {
+            assertTrue(ring.prepareGet(0, 0, keyData.length, valueBufOff, valueData.length, null));
+            assertTrue(ring.preparePut(1, 0, keyData.length, valueOff, valueData.length, null,
+                null));
+            assertFalse(ring.prepareDelete(2, 0, keyData.length, null));
+            assertEquals(2, ring.submit());
+
+            KvsRing.Completion completion = reap(ring);
+            assertEquals(0, completion.getUserData());
+            assertEquals(-1, completion.getResult());
+
+            completion = reap(ring);
+            assertEquals(1, completion.getUserData());
+            assertEquals(0, completion.getResult());
+
+            assertTrue(ring.prepareGet(2, 0, keyData.length, valueBufOff, valueData.length, null));
+            assertEquals(1, ring.submit());
+            completion = reap(ring);
+            assertEquals(2, completion.getUserData());
+            assertEquals(valueData.length, completion.getResult());
+
+            final byte[] value = new byte[valueData.length];
+            buf.position(valueBufOff);
+            buf.get(value);
+            assertArrayEquals(valueData, value);
+
+            assertTrue(ring.prepareDelete(3, 0, keyData.length, null));
+            assertTrue(ring.prepareGet(4, 0, keyData.length, buf.capacity(), 1, null));
+            assertEquals(2, ring.submit());
+            assertEquals(0, reap(ring).getResult());
+            assertThrows(IllegalArgumentException.class, () -> reap(ring).getResult());
+            assertFalse(kvs.get(keyData).isPresent());
+        }
+    }
+
+    @Test
+    public void ring_CompletionQueueFull() throws Exception {
+        final byte[] keyData = "key0".getBytes(StandardCharsets.UTF_8);
+        final ByteBuffer buf = ByteBuffer.allocateDirect(16);
+        final int entries = 2;
+        // Enough to fill the completion queue, twice the size, and then the submission queue.
+        final int ops = 3 * entries;
+
+        buf.put(keyData);
+
+        try (KvsRing ring = kvs.ring(buf, entries)) {
+            for (int i = 0; i < ops; i++) {
+                while (!ring.prepareGet(i, 0, keyData.length, keyData.length, 8, null)) {
+                    ring.submit();
+                    Thread.yield();
+                }
+            }
+            ring.submit();
+
+            // Leave the service thread time to go to sleep on the full completion queue.
+            Thread.sleep(100);
+
+            for (int i = 0; i < ops; i++) {
+                final KvsRing.Completion completion = reap(ring);
+                assertEquals(i, completion.getUserData());
+                assertEquals("value0".length(), completion.getResult());
+            }
+        }
+    }
+
+    @Test
+    public void ring_ClosedByKvs() throws HseException {
+        final byte[] keyData = String.format("key%d", NUM_ENTRIES).getBytes(StandardCharsets.UTF_8);
+        final ByteBuffer buf = ByteBuffer.allocateDirect(16);
+        final KvsRing ring = kvs.ring(buf, 2);
+
+        buf.put(keyData);
+        assertTrue(ring.preparePut(0, 0, keyData.length, 0, keyData.length, null, null));
+        assertEquals(1, ring.submit());
+
+        // Runs the submitted put before the KVS goes away.
+        kvs.close();
+        ring.close();
+
+        try (Kvs reopened = kvdb.kvsOpen("kvs")) {
+            assertArrayEquals(keyData, reopened.get(keyData).get());
+        }
+    }
 }
@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicInteger;
+
+import org.junit.jupiter.api.AfterAll;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+
+public final class ParallelScanTest {
+    private static final int NUM_ENTRIES = 1000;
+    private static final int PARALLELISM = 4;
+    private static Kvdb kvdb;
+    private static Kvs kvs;
+
+    @BeforeAll
+    public static void setupSuite() throws HseException {
+        TestUtils.registerShutdownHook();
+        Hse.init("rest.enabled=false");
+        kvdb = TestUtils.setupKvdb();
+    }
+
+    @AfterAll
+    public static void tearDownSuite() throws HseException {
+        TestUtils.tearDownKvdb(kvdb);
+        Hse.fini();
+    }
+
+    @BeforeEach
+    public void setupTest() throws HseException {
+        kvs = TestUtils.setupKvs(kvdb, "kvs");
+
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            kvs.put(String.format("key%04d", i), String.format("value%04d", i));
+        }
+    }
+
+    @AfterEach
+    public void tearDownTest() throws HseException {
+        TestUtils.tearDownKvs(kvdb, kvs);
+    }
+
+    @Test
+    public void boundaries() throws HseException {
+        final List<byte[]> boundaries = kvs.parallelScan(PARALLELISM).getBoundaries();
+
+        assertFalse(boundaries.isEmpty());
+        assertTrue(boundaries.size() <= PARALLELISM);
+        for (int i = 1; i < boundaries.size(); i++) {
+            final String prev = new String(boundaries.get(i - 1), StandardCharsets.UTF_8);
+            final String curr = new String(boundaries.get(i), StandardCharsets.UTF_8);
+            assertTrue(prev.compareTo(curr) < 0);
+        }
+
+        assertThrows(IllegalArgumentException.class, () -> kvs.parallelScan(0));
+    }
+
+    @Test
+    public void forEachOrdered() throws HseException, InterruptedException {
+        final List<String> keys = new ArrayList<>();
+
+        kvs.parallelScan(PARALLELISM).forEachOrdered((key, value) -> {
+            keys.add(new String(key, StandardCharsets.UTF_8));
+        });
+
+        assertEquals(NUM_ENTRIES, keys.size());
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            assertEquals(String.format("key%04d", i), keys.get(i));
+        }
+    }
+
+    @Test
+    public void forEachUnordered() throws HseException, InterruptedException {
+        final Set<String> keys = Collections.newSetFromMap(new ConcurrentHashMap<>());
+
+        kvs.parallelScan(PARALLELISM).forEachUnordered((key, value) -> {
+            final String k = new String(key, StandardCharsets.UTF_8);
+            assertArrayEquals(k.replace("key", "value").getBytes(StandardCharsets.UTF_8), value);
+            assertTrue(keys.add(k));
+        });
+
+        assertEquals(NUM_ENTRIES, keys.size());
+    }
+
+    @Test
+    public void forEachUnordered_MultipleRanges() throws HseException, InterruptedException {
+        final ParallelScan scan = kvs.parallelScan(PARALLELISM);
+        final Map<String, AtomicInteger> visits = new ConcurrentHashMap<>();
+
+        // Keys are evenly spread, so interpolation finds every boundary.
+        assertEquals(PARALLELISM, scan.getBoundaries().size());
+
+        scan.forEachUnordered((key, value) -> visits.computeIfAbsent(
+            new String(key, StandardCharsets.UTF_8), k -> new AtomicInteger()).incrementAndGet());
+
+        assertEquals(NUM_ENTRIES, visits.size());
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            assertEquals(1, visits.get(String.format("key%04d", i)).get());
+        }
+    }
+
+    @Test
+    public void forEachUnordered_Failure() throws HseException {
+        final ParallelScan scan = kvs.parallelScan(PARALLELISM);
+        final byte[] last = String.format("key%04d", NUM_ENTRIES - 1)
+            .getBytes(StandardCharsets.UTF_8);
+
+        // Only the last range fails, though it is joined last if joined in order.
+        assertThrows(IllegalStateException.class, () -> scan.forEachUnordered((key, value) -> {
+            if (ParallelScan.compare(key, last) == 0) {
+                throw new IllegalStateException();
+            }
+        }));
+    }
+
+    @Test
+    public void filter() throws HseException, InterruptedException {
+        final List<String> keys = new ArrayList<>();
+
+        kvs.parallelScan("key01".getBytes(StandardCharsets.UTF_8), PARALLELISM)
+            .forEachOrdered((key, value) -> keys.add(new String(key, StandardCharsets.UTF_8)));
+
+        assertEquals(100, keys.size());
+        assertEquals("key0100", keys.get(0));
+        assertEquals("key0199", keys.get(keys.size() - 1));
+    }
+}
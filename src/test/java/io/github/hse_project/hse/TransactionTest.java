@@ -5,10 +5,15 @@
 
 package io.github.hse_project.hse;
 
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
 import static org.junit.jupiter.api.Assertions.assertTrue;
 
+import java.nio.charset.StandardCharsets;
+import java.util.concurrent.TimeUnit;
+
 import io.github.hse_project.hse.KvdbTransaction.State;
 
 import org.junit.jupiter.api.AfterAll;
@@ -73,4 +78,59 @@ public final class TransactionTest {
 
         assertFalse(kvs.get("world").isPresent());
     }
+
+    @Test
+    public void pool() throws HseException {
+        final Kvdb.TransactionPoolStats before = kvdb.getTransactionPoolStats();
+
+        for (int i = 0; i < 4; i++) {
+            try (KvdbTransaction txn = kvdb.transaction()) {
+                assertEquals(State.INVALID, txn.getState());
+                txn.begin();
+
+                // Leave the transaction ACTIVE for close() to deal with.
+                kvs.put("pool", "hit", txn);
+            }
+        }
+
+        final Kvdb.TransactionPoolStats after = kvdb.getTransactionPoolStats();
+        assertTrue(after.getHits() - before.getHits() >= 3);
+        assertTrue(after.getHitRate() > 0);
+        assertTrue(kvs.get("pool").isPresent());
+    }
+
+    @Test
+    public void runInTransaction() throws HseException {
+        final TransactionRetryPolicy policy = new TransactionRetryPolicy(3, 1, 10,
+            TimeUnit.MILLISECONDS);
+        final int[] attempts = new int[1];
+
+        final String result = kvdb.runInTransaction(txn -> {
+            attempts[0]++;
+            if (attempts[0] == 1) {
+                // Commit a write to the same key after this snapshot was taken.
+                try (KvdbTransaction other = kvdb.transaction()) {
+                    other.begin();
+                    kvs.put("retry", "other", other);
+                }
+            }
+
+            kvs.put("retry", "mine", txn);
+
+            return "done";
+        }, policy);
+
+        assertEquals("done", result);
+        assertEquals(2, attempts[0]);
+        assertEquals(1, policy.getConflicts());
+        assertEquals(1, policy.getRetries());
+        assertEquals(1, policy.getCommits());
+        assertArrayEquals("mine".getBytes(StandardCharsets.UTF_8), kvs.get("retry").get());
+
+        assertThrows(HseException.class, () -> kvdb.runInTransaction(txn -> {
+            kvs.put((byte[]) null, (byte[]) null, txn);
+            return null;
+        }, policy));
+        assertEquals(1, policy.getRetries());
+    }
 }
@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.EnumSet;
+
+import org.junit.jupiter.api.AfterAll;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+
+public final class WriteBatchTest {
+    private static final int NUM_ENTRIES = 5;
+    private static Kvdb kvdb;
+    private static Kvs kvs;
+    private static Kvs txnKvs;
+    private static Kvs otherTxnKvs;
+
+    @BeforeAll
+    public static void setupSuite() throws HseException {
+        TestUtils.registerShutdownHook();
+        Hse.init("rest.enabled=false");
+        kvdb = TestUtils.setupKvdb();
+    }
+
+    @AfterAll
+    public static void tearDownSuite() throws HseException {
+        TestUtils.tearDownKvdb(kvdb);
+        Hse.fini();
+    }
+
+    @BeforeEach
+    public void setupTest() throws HseException {
+        final String[] cparams = new String[]{"prefix.length=3"};
+        final String[] rparams = new String[]{"transactions.enabled=true"};
+
+        kvs = TestUtils.setupKvs(kvdb, "kvs", cparams, null);
+        txnKvs = TestUtils.setupKvs(kvdb, "txnKvs", cparams, rparams);
+        otherTxnKvs = TestUtils.setupKvs(kvdb, "otherTxnKvs", cparams, rparams);
+    }
+
+    @AfterEach
+    public void tearDownTest() throws HseException {
+        TestUtils.tearDownKvs(kvdb, kvs);
+        TestUtils.tearDownKvs(kvdb, txnKvs);
+        TestUtils.tearDownKvs(kvdb, otherTxnKvs);
+    }
+
+    private static byte[] bytes(final String s) {
+        return s.getBytes(StandardCharsets.UTF_8);
+    }
+
+    @Test
+    public void put() throws HseException {
+        final WriteBatch batch = new WriteBatch();
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            batch.put(bytes(String.format("key%d", i)), bytes(String.format("value%d", i)));
+        }
+        assertEquals(NUM_ENTRIES, batch.size());
+
+        kvs.write(batch);
+        assertEquals(-1, batch.getFailedIndex());
+
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            assertArrayEquals(bytes(String.format("value%d", i)),
+                kvs.get(String.format("key%d", i)).get());
+        }
+    }
+
+    @Test
+    public void put_ByteBuffer() throws HseException {
+        final ByteBuffer key = ByteBuffer.wrap(bytes("key0"));
+        final ByteBuffer value = ByteBuffer.allocateDirect(6).put(bytes("value0"));
+        value.position(0);
+
+        final WriteBatch batch = new WriteBatch()
+            .put(key, value, EnumSet.of(Kvs.PutFlags.VCOMP_OFF));
+        assertFalse(key.hasRemaining());
+        assertFalse(value.hasRemaining());
+
+        kvs.write(batch);
+        assertArrayEquals(bytes("value0"), kvs.get("key0").get());
+    }
+
+    @Test
+    public void put_Grow() throws HseException {
+        final byte[] value = new byte[Limits.KVS_VALUE_LEN_MAX];
+        value[value.length - 1] = 1;
+
+        final WriteBatch batch = new WriteBatch(1)
+            .put(bytes("key0"), value)
+            .put(bytes("key1"), value);
+
+        kvs.write(batch);
+        assertArrayEquals(value, kvs.get("key0").get());
+        assertArrayEquals(value, kvs.get("key1").get());
+    }
+
+    @Test
+    public void delete() throws HseException {
+        KvsTest.addData(kvs, null);
+
+        final WriteBatch batch = new WriteBatch()
+            .delete(bytes("key0"))
+            .delete(ByteBuffer.wrap(bytes("key1")));
+
+        kvs.write(batch);
+        assertFalse(kvs.get("key0").isPresent());
+        assertFalse(kvs.get("key1").isPresent());
+        assertArrayEquals(bytes("value2"), kvs.get("key2").get());
+    }
+
+    @Test
+    public void prefixDelete() throws HseException {
+        KvsTest.addData(kvs, null);
+
+        kvs.write(new WriteBatch().prefixDelete(bytes("key")));
+        for (int i = 0; i < NUM_ENTRIES; i++) {
+            assertFalse(kvs.get(String.format("key%d", i)).isPresent());
+        }
+    }
+
+    @Test
+    public void write_Order() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(bytes("key0"), bytes("value0"))
+            .delete(bytes("key0"))
+            .put(bytes("key1"), bytes("value1"))
+            .prefixDelete(bytes("key"))
+            .put(bytes("key2"), bytes("value2"));
+
+        kvs.write(batch);
+        assertFalse(kvs.get("key0").isPresent());
+        assertFalse(kvs.get("key1").isPresent());
+        assertArrayEquals(bytes("value2"), kvs.get("key2").get());
+    }
+
+    @Test
+    public void write_Failure() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(bytes("key0"), bytes("value0"))
+            .put((byte[]) null, bytes("value1"))
+            .put(bytes("key2"), bytes("value2"));
+
+        assertThrows(HseException.class, () -> kvs.write(batch));
+        assertEquals(1, batch.getFailedIndex());
+        assertArrayEquals(bytes("value0"), kvs.get("key0").get());
+        assertFalse(kvs.get("key2").isPresent());
+
+        batch.clear();
+        assertEquals(0, batch.size());
+        assertEquals(-1, batch.getFailedIndex());
+
+        kvs.write(batch.put(bytes("key2"), bytes("value2")));
+        assertEquals(-1, batch.getFailedIndex());
+        assertArrayEquals(bytes("value2"), kvs.get("key2").get());
+    }
+
+    @Test
+    public void write_Transactional() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(bytes("key0"), bytes("value0"))
+            .put(bytes("key1"), bytes("value1"));
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            txnKvs.write(batch, txn);
+            assertArrayEquals(bytes("value0"), txnKvs.get("key0", txn).get());
+            assertFalse(txnKvs.get("key0").isPresent());
+
+            txn.abort();
+        }
+
+        assertFalse(txnKvs.get("key0").isPresent());
+        assertFalse(txnKvs.get("key1").isPresent());
+    }
+
+    @Test
+    public void commit() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(txnKvs, bytes("key0"), bytes("value0"))
+            .put(otherTxnKvs, bytes("key0"), bytes("other0"))
+            .delete(otherTxnKvs, bytes("key1"));
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.commit(batch);
+            assertEquals(KvdbTransaction.State.COMMITTED, txn.getState());
+            assertEquals(-1, batch.getFailedIndex());
+
+            batch.clear();
+            batch.put(txnKvs, bytes("key1"), bytes("value1"));
+
+            txn.commit(batch);
+            assertEquals(KvdbTransaction.State.COMMITTED, txn.getState());
+        }
+
+        assertArrayEquals(bytes("value0"), txnKvs.get("key0").get());
+        assertArrayEquals(bytes("other0"), otherTxnKvs.get("key0").get());
+        assertArrayEquals(bytes("value1"), txnKvs.get("key1").get());
+    }
+
+    @Test
+    public void commit_Failure() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(txnKvs, bytes("key0"), bytes("value0"))
+            .put(otherTxnKvs, bytes("key0"), bytes("other0"))
+            .put(txnKvs, (byte[]) null, bytes("value1"));
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            assertThrows(HseException.class, () -> txn.commit(batch));
+            assertEquals(2, batch.getFailedIndex());
+            assertEquals(KvdbTransaction.State.ABORTED, txn.getState());
+        }
+
+        assertFalse(txnKvs.get("key0").isPresent());
+        assertFalse(otherTxnKvs.get("key0").isPresent());
+    }
+
+    @Test
+    public void commit_NoKvs() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(txnKvs, bytes("key0"), bytes("value0"))
+            .put(bytes("key1"), bytes("value1"));
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            assertThrows(IllegalArgumentException.class, () -> txn.commit(batch));
+            assertEquals(-1, batch.getFailedIndex());
+
+            batch.clear();
+            batch.put(txnKvs, bytes("key1"), bytes("value1"));
+
+            txn.commit(batch);
+        }
+
+        assertFalse(txnKvs.get("key0").isPresent());
+        assertArrayEquals(bytes("value1"), txnKvs.get("key1").get());
+    }
+
+    @Test
+    public void commit_Active() throws HseException {
+        final WriteBatch batch = new WriteBatch()
+            .put(txnKvs, bytes("key0"), bytes("value0"));
+
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            assertThrows(HseException.class, () -> txn.commit(batch));
+            assertEquals(-1, batch.getFailedIndex());
+
+            txn.abort();
+        }
+
+        assertFalse(txnKvs.get("key0").isPresent());
+    }
+}
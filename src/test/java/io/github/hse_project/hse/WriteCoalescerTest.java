@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertInstanceOf;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.TimeUnit;
+
+import org.junit.jupiter.api.AfterAll;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+
+public final class WriteCoalescerTest {
+    private static final int NUM_ENTRIES = 5;
+    private static final int NUM_THREADS = 4;
+    private static Kvdb kvdb;
+    private static Kvs kvs;
+
+    @BeforeAll
+    public static void setupSuite() throws HseException {
+        TestUtils.registerShutdownHook();
+        Hse.init("rest.enabled=false");
+        kvdb = TestUtils.setupKvdb();
+    }
+
+    @AfterAll
+    public static void tearDownSuite() throws HseException {
+        TestUtils.tearDownKvdb(kvdb);
+        Hse.fini();
+    }
+
+    @BeforeEach
+    public void setupTest() throws HseException {
+        kvs = TestUtils.setupKvs(kvdb, "kvs", new String[]{"prefix.length=3"}, null);
+    }
+
+    @AfterEach
+    public void tearDownTest() throws HseException {
+        TestUtils.tearDownKvs(kvdb, kvs);
+    }
+
+    private static byte[] bytes(final String s) {
+        return s.getBytes(StandardCharsets.UTF_8);
+    }
+
+    @Test
+    public void batchFull() throws Exception {
+        final List<CompletableFuture<Void>> futures = new ArrayList<>();
+
+        // Nothing but a full batch can flush within the test.
+        try (WriteCoalescer coalescer = new WriteCoalescer(kvs, NUM_ENTRIES, 1, TimeUnit.HOURS)) {
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                futures.add(coalescer.put(bytes(String.format("key%d", i)),
+                    bytes(String.format("value%d", i))));
+            }
+
+            CompletableFuture.allOf(futures.toArray(new CompletableFuture<?>[0])).get();
+            for (int i = 0; i < NUM_ENTRIES; i++) {
+                assertArrayEquals(bytes(String.format("value%d", i)),
+                    kvs.get(bytes(String.format("key%d", i))).get());
+            }
+        }
+    }
+
+    @Test
+    public void close() throws HseException {
+        final WriteCoalescer coalescer = new WriteCoalescer(kvs, NUM_ENTRIES, 1, TimeUnit.HOURS);
+        final CompletableFuture<Void> future = coalescer.put(bytes("key0"), bytes("value0"));
+
+        assertFalse(future.isDone());
+        coalescer.close();
+        assertTrue(future.isDone());
+        assertArrayEquals(bytes("value0"), kvs.get(bytes("key0")).get());
+
+        assertThrows(IllegalStateException.class, () -> coalescer.delete(bytes("key0")));
+    }
+
+    @Test
+    public void concurrentWriters() throws Exception {
+        final List<CompletableFuture<Void>> futures = new ArrayList<>();
+        final List<Thread> threads = new ArrayList<>();
+
+        try (WriteCoalescer coalescer = new WriteCoalescer(kvs, kvdb, 8, 1,
+                TimeUnit.MILLISECONDS)) {
+            for (int t = 0; t < NUM_THREADS; t++) {
+                final int id = t;
+                final Thread thread = new Thread(() -> {
+                    for (int i = 0; i < NUM_ENTRIES; i++) {
+                        final byte[] key = bytes(String.format("k%02d%d", id, i));
+                        final CompletableFuture<Void> put = coalescer.put(ByteBuffer.wrap(key),
+                            ByteBuffer.wrap(key));
+
+                        synchronized (futures) {
+                            futures.add(put);
+                        }
+                    }
+
+                    synchronized (futures) {
+                        futures.add(coalescer.delete(bytes(String.format("k%02d0", id))));
+                    }
+                });
+
+                threads.add(thread);
+                thread.start();
+            }
+
+            for (final Thread thread : threads) {
+                thread.join();
+            }
+
+            CompletableFuture.allOf(futures.toArray(new CompletableFuture<?>[0])).get();
+        }
+
+        for (int t = 0; t < NUM_THREADS; t++) {
+            assertFalse(kvs.get(bytes(String.format("k%02d0", t))).isPresent());
+            for (int i = 1; i < NUM_ENTRIES; i++) {
+                final byte[] key = bytes(String.format("k%02d%d", t, i));
+                assertArrayEquals(key, kvs.get(key).get());
+            }
+        }
+    }
+
+    @Test
+    public void failedOperation() throws Exception {
+        try (WriteCoalescer coalescer = new WriteCoalescer(kvs, 3, 1, TimeUnit.HOURS)) {
+            final CompletableFuture<Void> before = coalescer.put(bytes("key0"), bytes("value0"));
+            final CompletableFuture<Void> failed = coalescer.put((byte[]) null, bytes("value1"));
+            final CompletableFuture<Void> after = coalescer.put(bytes("key2"), bytes("value2"));
+
+            before.get();
+            after.get();
+            final ExecutionException e = assertThrows(ExecutionException.class, failed::get);
+            assertInstanceOf(HseException.class, e.getCause());
+        }
+
+        assertArrayEquals(bytes("value0"), kvs.get(bytes("key0")).get());
+        assertArrayEquals(bytes("value2"), kvs.get(bytes("key2")).get());
+    }
+}
@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+package io.github.hse_project.hse;
+
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.MemorySegment;
+import java.util.EnumSet;
+import java.util.Optional;
+
+import org.junit.jupiter.api.AfterAll;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+
+import io.github.hse_project.hse.Kvs.PutFlags;
+
+public final class ForeignKvsTest {
+    private static Kvdb kvdb;
+    private static Kvs kvs;
+    private static Kvs txnKvs;
+    private Arena arena;
+
+    @BeforeAll
+    public static void setupSuite() throws HseException {
+        TestUtils.registerShutdownHook();
+        Hse.init("rest.enabled=false");
+        kvdb = TestUtils.setupKvdb();
+    }
+
+    @AfterAll
+    public static void tearDownSuite() throws HseException {
+        TestUtils.tearDownKvdb(kvdb);
+        Hse.fini();
+    }
+
+    @BeforeEach
+    public void setupTest() throws HseException {
+        final String[] cparams = new String[]{"prefix.length=3"};
+        final String[] rparams = new String[]{"transactions.enabled=true"};
+
+        kvs = TestUtils.setupKvs(kvdb, "kvs", cparams, null);
+        txnKvs = TestUtils.setupKvs(kvdb, "txnKvs", cparams, rparams);
+        this.arena = Arena.ofConfined();
+    }
+
+    @AfterEach
+    public void tearDownTest() throws HseException {
+        this.arena.close();
+        TestUtils.tearDownKvs(kvdb, kvs);
+        TestUtils.tearDownKvs(kvdb, txnKvs);
+    }
+
+    private MemorySegment segment(final String s) {
+        final MemorySegment segment = this.arena.allocateFrom(s);
+
+        // Drop the NUL terminator.
+        return segment.asSlice(0, segment.byteSize() - 1);
+    }
+
+    @Test
+    public void put_VisibleToJni() throws HseException {
+        ForeignKvs.put(kvs, segment("key0"), segment("value0"));
+
+        assertEquals(Optional.of("value0"), kvs.get("key0").map(String::new));
+    }
+
+    @Test
+    public void put_Flags() throws HseException {
+        ForeignKvs.put(kvs, segment("key0"), segment("value0"), EnumSet.of(PutFlags.VCOMP_OFF),
+            null);
+
+        assertEquals(Optional.of("value0"), kvs.get("key0").map(String::new));
+    }
+
+    @Test
+    public void put_NullValue() throws HseException {
+        ForeignKvs.put(kvs, segment("key0"), null);
+
+        assertEquals(Optional.of(0), ForeignKvs.get(kvs, segment("key0"), null));
+    }
+
+    @Test
+    public void put_NullKey() {
+        assertThrows(HseException.class, () -> ForeignKvs.put(kvs, null, segment("value0")));
+    }
+
+    @Test
+    public void get_WrittenByJni() throws HseException {
+        final MemorySegment valueBuf = this.arena.allocate(16);
+
+        kvs.put("key0", "value0");
+
+        assertEquals(Optional.of(6), ForeignKvs.get(kvs, segment("key0"), valueBuf));
+        assertEquals(-1, segment("value0").mismatch(valueBuf.asSlice(0, 6)));
+    }
+
+    @Test
+    public void get_NotFound() throws HseException {
+        assertFalse(ForeignKvs.get(kvs, segment("key0"), this.arena.allocate(16)).isPresent());
+    }
+
+    @Test
+    public void get_SmallBuffer() throws HseException {
+        final MemorySegment valueBuf = this.arena.allocate(3);
+
+        kvs.put("key0", "value0");
+
+        // The whole length is returned, and the buffer holds a prefix of the value.
+        assertEquals(Optional.of(6), ForeignKvs.get(kvs, segment("key0"), valueBuf));
+        assertEquals(-1, segment("val").mismatch(valueBuf));
+    }
+
+    @Test
+    public void get_NullValueBuf() throws HseException {
+        kvs.put("key0", "value0");
+
+        assertEquals(Optional.of(6), ForeignKvs.get(kvs, segment("key0"), null));
+    }
+
+    @Test
+    public void delete() throws HseException {
+        kvs.put("key0", "value0");
+
+        ForeignKvs.delete(kvs, segment("key0"));
+
+        assertFalse(kvs.get("key0").isPresent());
+    }
+
+    @Test
+    public void delete_NullKey() {
+        assertThrows(HseException.class, () -> ForeignKvs.delete(kvs, null));
+    }
+
+    @Test
+    public void transactional() throws HseException {
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            ForeignKvs.put(txnKvs, segment("key0"), segment("value0"), txn);
+            ForeignKvs.put(txnKvs, segment("key1"), segment("value1"), txn);
+            assertTrue(ForeignKvs.get(txnKvs, segment("key0"), null, txn).isPresent());
+            assertFalse(txnKvs.get("key0").isPresent());
+
+            ForeignKvs.delete(txnKvs, segment("key1"), txn);
+            assertFalse(ForeignKvs.get(txnKvs, segment("key1"), null, txn).isPresent());
+
+            txn.commit();
+        }
+
+        assertTrue(ForeignKvs.get(txnKvs, segment("key0"), null).isPresent());
+        assertFalse(ForeignKvs.get(txnKvs, segment("key1"), null).isPresent());
+    }
+
+    @Test
+    public void error_Translated() {
+        // A KVS without transactions rejects a transaction, as it does through JNI.
+        try (KvdbTransaction txn = kvdb.transaction()) {
+            txn.begin();
+
+            final HseException e = assertThrows(HseException.class,
+                () -> ForeignKvs.put(kvs, segment("key0"), segment("value0"), txn));
+            final HseException expected = assertThrows(HseException.class,
+                () -> kvs.put("key0", "value0", txn));
+
+            assertEquals(expected.getErrno(), e.getErrno());
+            assertEquals(expected.getMessage(), e.getMessage());
+        } catch (final HseException e) {
+            throw new AssertionError(e);
+        }
+    }
+}